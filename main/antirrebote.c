@@ -0,0 +1,96 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+/** @file antirrebote.c
+ ** @brief Definiciones del antirrebote en paralelo de hasta 32 entradas con contadores verticales
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include "antirrebote.h"
+#include <stddef.h>
+
+/* === Macros definitions ========================================================================================== */
+
+/* === Private data type declarations ============================================================================== */
+
+//! @brief Estado de un grupo de entradas
+struct antirrebote_s {
+    uint32_t mascara;    //!< Bits de la muestra que son entradas
+    uint32_t invertidas; //!< Entradas activas en nivel bajo
+    uint32_t estable;    //!< Último nivel aceptado de cada entrada, ya corregido para que uno sea activa
+    uint32_t cuenta0;    //!< Bit menos significativo del contador de cada entrada
+    uint32_t cuenta1;    //!< Bit más significativo del contador de cada entrada
+};
+
+/* === Private variable declarations =============================================================================== */
+
+/* === Private function declarations =============================================================================== */
+
+/* === Public variable definitions ================================================================================= */
+
+/* === Private variable definitions ================================================================================ */
+
+//! @brief Grupos de entradas disponibles
+static struct antirrebote_s instancias[ANTIRREBOTE_MAXIMO];
+
+//! @brief Cantidad de grupos creados
+static uint8_t creados;
+
+/* === Private function definitions ================================================================================ */
+
+/* === Public function implementation ============================================================================== */
+
+antirrebote_t AntirreboteCrear(uint32_t mascara, uint32_t invertidas, uint32_t muestra) {
+    if (creados >= ANTIRREBOTE_MAXIMO) {
+        return NULL;
+    }
+    antirrebote_t self = &instancias[creados++];
+    self->mascara = mascara;
+    self->invertidas = invertidas & mascara;
+    self->estable = (muestra ^ self->invertidas) & mascara;
+    self->cuenta0 = 0;
+    self->cuenta1 = 0;
+    return self;
+}
+
+bool AntirreboteMuestrear(antirrebote_t self, uint32_t muestra, uint32_t * activadas, uint32_t * desactivadas) {
+    /* Entradas cuya muestra difiere del nivel estable: su contador avanza, el de las demás vuelve a cero */
+    uint32_t diferentes = ((muestra ^ self->invertidas) & self->mascara) ^ self->estable;
+    self->cuenta1 = (self->cuenta1 ^ self->cuenta0) & diferentes;
+    self->cuenta0 = ~self->cuenta0 & diferentes;
+
+    /* Un contador que vuelve a cero con la muestra todavía diferente completó las muestras necesarias */
+    uint32_t cambios = diferentes & ~(self->cuenta0 | self->cuenta1);
+    self->estable ^= cambios;
+
+    if (activadas) {
+        *activadas = cambios & self->estable;
+    }
+    if (desactivadas) {
+        *desactivadas = cambios & ~self->estable;
+    }
+    return (self->cuenta0 | self->cuenta1) != 0;
+}
+
+uint32_t AntirreboteActivas(antirrebote_t self) {
+    return self->estable;
+}
+
+/* === End of documentation ======================================================================================== */
@@ -0,0 +1,100 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+#ifndef ANTIRREBOTE_H_
+#define ANTIRREBOTE_H_
+
+/** @file antirrebote.h
+ ** @brief Declaraciones del antirrebote en paralelo de hasta 32 entradas con contadores verticales
+ **
+ ** Cada muestra es una palabra con un bit por entrada, por ejemplo el registro de entrada de los GPIO leído de una
+ ** sola vez. Cada entrada tiene un contador de dos bits que avanza mientras la muestra difiere del nivel estable y
+ ** vuelve a cero cuando coincide; al completar @ref ANTIRREBOTE_MUESTRAS muestras distintas seguidas se acepta el nivel
+ ** nuevo. Los contadores se guardan "verticalmente": una palabra con el bit menos significativo de todos los
+ ** contadores y otra con el más significativo, asi una muestra se procesa con unas pocas operaciones lógicas sin
+ ** importar la cantidad de entradas.
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* === Cabecera C++ ================================================================================================ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* === Public macros definitions =================================================================================== */
+
+//! @brief Cantidad de muestras seguidas con el nivel nuevo necesarias para aceptarlo
+#define ANTIRREBOTE_MUESTRAS 4
+
+//! @brief Cantidad máxima de grupos de entradas que se pueden crear
+#ifndef ANTIRREBOTE_MAXIMO
+#define ANTIRREBOTE_MAXIMO 2
+#endif
+
+/* === Public data type declarations =============================================================================== */
+
+//! @brief Tipo de dato para referenciar a un grupo de entradas
+typedef struct antirrebote_s * antirrebote_t;
+
+/* === Public variable declarations ================================================================================ */
+
+/* === Public function declarations ================================================================================ */
+
+/**
+ * @brief Función que crea un grupo de entradas
+ *
+ * @param  mascara        Bits de la muestra que son entradas, el resto se ignora
+ * @param  invertidas     Bits de las entradas que están activas en nivel bajo (por ejemplo pulsadores con pull-up)
+ * @param  muestra        Muestra inicial, se toma como nivel estable sin generar flancos
+ * @return antirrebote_t  Puntero al grupo creado o NULL si no quedan grupos disponibles
+ */
+antirrebote_t AntirreboteCrear(uint32_t mascara, uint32_t invertidas, uint32_t muestra);
+
+/**
+ * @brief Función que procesa una muestra de todas las entradas del grupo
+ *
+ * @param  self          Puntero al grupo creado con @ref AntirreboteCrear
+ * @param  muestra       Niveles leídos de las entradas
+ * @param  activadas     Puntero donde se devuelven las entradas que pasaron a estar activas, puede ser NULL
+ * @param  desactivadas  Puntero donde se devuelven las entradas que dejaron de estar activas, puede ser NULL
+ * @return true          Alguna entrada difiere de su nivel estable y hacen falta más muestras
+ * @return false         Todas las entradas están estables
+ */
+bool AntirreboteMuestrear(antirrebote_t self, uint32_t muestra, uint32_t * activadas, uint32_t * desactivadas);
+
+/**
+ * @brief Función que devuelve las entradas activas según el último nivel estable
+ *
+ * @param  self      Puntero al grupo creado con @ref AntirreboteCrear
+ * @return uint32_t  Máscara con un bit en uno por cada entrada activa
+ */
+uint32_t AntirreboteActivas(antirrebote_t self);
+
+/* === End of documentation ======================================================================================== */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ANTIRREBOTE_H_ */
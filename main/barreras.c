@@ -0,0 +1,293 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+/** @file barreras.c
+ ** @brief Definiciones de las barreras de luz con el instante de cada corte capturado por hardware
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include "barreras.h"
+#include <stddef.h>
+
+#ifdef ESP_PLATFORM
+#include "driver/mcpwm_cap.h"
+#include "esp_attr.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#else
+#define IRAM_ATTR
+#endif
+
+/* === Macros definitions ========================================================================================== */
+
+#define ESPERA_CAPTURA_US 100 //!< Tiempo máximo que se espera la interrupción de la captura de referencia
+
+/* === Private data type declarations ============================================================================== */
+
+//! @brief Estado de una barrera
+struct barrera_s {
+    barrera_aviso_t aviso;            //!< Función que se llama con cada corte aceptado
+    void * contexto;                  //!< Parámetro para la función de aviso
+    uint8_t flancos;                  //!< Flancos que se toman como corte, uno de los valores de barrera_flancos_t
+    bool cortada;                     //!< Ya se aceptó algún corte y ultimo_us es válido
+    uint32_t bloqueo_us;              //!< Tiempo que se ignoran los flancos después de un corte aceptado
+    int64_t ultimo_us;                //!< Instante del último corte aceptado
+    uint32_t descartados;             //!< Flancos descartados por caer en el periodo de bloqueo
+#ifdef ESP_PLATFORM
+    mcpwm_cap_channel_handle_t canal; //!< Canal de captura de la barrera
+#endif
+};
+
+/* === Private variable declarations =============================================================================== */
+
+/* === Private function declarations =============================================================================== */
+
+/**
+ * @brief Función que convierte un valor del temporizador de captura al reloj de alta resolución
+ *
+ * @param  captura  Valor del temporizador de captura
+ * @return int64_t  Instante en microsegundos del reloj de alta resolución
+ */
+static int64_t Convertir(uint32_t captura);
+
+#ifdef ESP_PLATFORM
+/**
+ * @brief Función que llama la interrupción de un canal de captura de barrera
+ *
+ * @param  canal     Canal de captura que se disparó
+ * @param  datos     Valor capturado y flanco que lo disparó
+ * @param  contexto  Barrera del canal
+ * @return true      Se despertó una tarea de más prioridad
+ */
+static bool Capturado(mcpwm_cap_channel_handle_t canal, const mcpwm_capture_event_data_t * datos, void * contexto);
+
+/**
+ * @brief Función que llama la interrupción del canal de la referencia al disparar su captura por software
+ *
+ * @param  canal     Canal de la referencia
+ * @param  datos     Valor capturado
+ * @param  contexto  No utilizado
+ * @return false     Nunca despierta tareas
+ */
+static bool Referencia(mcpwm_cap_channel_handle_t canal, const mcpwm_capture_event_data_t * datos, void * contexto);
+
+/**
+ * @brief Función que toma una referencia nueva, la llama periódicamente el servicio esp_timer
+ *
+ * @param  contexto  No utilizado
+ */
+static void Renovar(void * contexto);
+#endif
+
+/* === Public variable definitions ================================================================================= */
+
+/* === Private variable definitions ================================================================================ */
+
+//! @brief Barreras disponibles
+static struct barrera_s instancias[BARRERAS_MAXIMO];
+
+//! @brief Cantidad de barreras creadas
+static uint8_t creadas;
+
+//! @brief Frecuencia del temporizador de captura
+static uint32_t resolucion;
+
+//! @brief Valor del temporizador de captura en la última referencia
+static uint32_t referencia_captura;
+
+//! @brief Instante del reloj de alta resolución en la última referencia
+static int64_t referencia_us;
+
+#ifdef ESP_PLATFORM
+//! @brief Protege el par de referencia entre la tarea esp_timer y las interrupciones de captura de ambos núcleos
+static portMUX_TYPE cerrojo = portMUX_INITIALIZER_UNLOCKED;
+
+//! @brief Temporizador de captura compartido por todos los canales
+static mcpwm_cap_timer_handle_t temporizador;
+
+//! @brief Canal sin terminal que solo se dispara por software para tomar la referencia
+static mcpwm_cap_channel_handle_t sincronismo;
+
+//! @brief Temporizador que renueva la referencia
+static esp_timer_handle_t renovacion;
+
+//! @brief Valor capturado por el canal de la referencia, lo escribe su interrupción
+static volatile uint32_t captura_sincronismo;
+
+//! @brief La interrupción del canal de la referencia ya guardó su valor
+static volatile bool sincronismo_capturado;
+#endif
+
+/* === Private function definitions ================================================================================ */
+
+static int64_t IRAM_ATTR Convertir(uint32_t captura) {
+    /* La diferencia con signo admite capturas anteriores a la referencia y el paso por cero de la cuenta */
+    int32_t diferencia = (int32_t)(captura - referencia_captura);
+    return referencia_us + ((int64_t)diferencia * 1000000) / resolucion;
+}
+
+#ifdef ESP_PLATFORM
+static bool IRAM_ATTR Capturado(mcpwm_cap_channel_handle_t canal, const mcpwm_capture_event_data_t * datos,
+                                void * contexto) {
+    return BarreraCapturar(contexto, datos->cap_value, datos->cap_edge == MCPWM_CAP_EDGE_POS);
+}
+
+static bool IRAM_ATTR Referencia(mcpwm_cap_channel_handle_t canal, const mcpwm_capture_event_data_t * datos,
+                                 void * contexto) {
+    captura_sincronismo = datos->cap_value;
+    sincronismo_capturado = true;
+    return false;
+}
+
+static void Renovar(void * contexto) {
+    int64_t antes, despues;
+
+    /* La captura ocurre entre las dos lecturas del reloj, con las interrupciones de este núcleo deshabilitadas */
+    sincronismo_capturado = false;
+    portENTER_CRITICAL(&cerrojo);
+    antes = esp_timer_get_time();
+    mcpwm_capture_channel_trigger_soft_catch(sincronismo);
+    despues = esp_timer_get_time();
+    portEXIT_CRITICAL(&cerrojo);
+
+    while (!sincronismo_capturado) {
+        if (esp_timer_get_time() - despues > ESPERA_CAPTURA_US) {
+            return; // Se conserva la referencia anterior, sigue valiendo hasta que la cuenta dé media vuelta
+        }
+    }
+    BarrerasSincronizar(captura_sincronismo, antes + (despues - antes) / 2);
+}
+#endif
+
+/* === Public function implementation ============================================================================== */
+
+bool BarrerasIniciar(uint32_t resolucion_hz) {
+#ifdef ESP_PLATFORM
+    mcpwm_capture_timer_config_t configuracion = {
+        .group_id = 0,
+        .clk_src = MCPWM_CAPTURE_CLK_SRC_DEFAULT,
+    };
+    mcpwm_capture_channel_config_t canal = {
+        .gpio_num = -1, // Solo se dispara por software
+        .prescale = 1,
+    };
+    mcpwm_capture_event_callbacks_t avisos = {
+        .on_cap = Referencia,
+    };
+    esp_timer_create_args_t argumentos = {
+        .callback = Renovar,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "barreras",
+    };
+
+    if ((mcpwm_new_capture_timer(&configuracion, &temporizador) != ESP_OK) ||
+        (mcpwm_capture_timer_get_resolution(temporizador, &resolucion_hz) != ESP_OK) ||
+        (mcpwm_new_capture_channel(temporizador, &canal, &sincronismo) != ESP_OK) ||
+        (mcpwm_capture_channel_register_event_callbacks(sincronismo, &avisos, NULL) != ESP_OK) ||
+        (mcpwm_capture_channel_enable(sincronismo) != ESP_OK) || (mcpwm_capture_timer_enable(temporizador) != ESP_OK) ||
+        (mcpwm_capture_timer_start(temporizador) != ESP_OK) || (esp_timer_create(&argumentos, &renovacion) != ESP_OK)) {
+        return false;
+    }
+#endif
+    resolucion = resolucion_hz;
+#ifdef ESP_PLATFORM
+    Renovar(NULL);
+    return esp_timer_start_periodic(renovacion, BARRERAS_SINCRONIZACION_MS * 1000ULL) == ESP_OK;
+#else
+    return true;
+#endif
+}
+
+void BarrerasSincronizar(uint32_t captura, int64_t instante_us) {
+#ifdef ESP_PLATFORM
+    portENTER_CRITICAL(&cerrojo);
+#endif
+    referencia_captura = captura;
+    referencia_us = instante_us;
+#ifdef ESP_PLATFORM
+    portEXIT_CRITICAL(&cerrojo);
+#endif
+}
+
+barrera_t BarreraCrear(int8_t gpio, barrera_flancos_t flancos, uint32_t bloqueo_us, barrera_aviso_t aviso,
+                       void * contexto) {
+    if (creadas >= BARRERAS_MAXIMO) {
+        return NULL;
+    }
+    barrera_t self = &instancias[creadas];
+    self->aviso = aviso;
+    self->contexto = contexto;
+    self->flancos = flancos;
+    self->bloqueo_us = bloqueo_us;
+    self->cortada = false;
+    self->descartados = 0;
+
+#ifdef ESP_PLATFORM
+    mcpwm_capture_channel_config_t canal = {
+        .gpio_num = gpio,
+        .prescale = 1,
+        .flags.pos_edge = (flancos & BARRERA_SUBIDA) != 0,
+        .flags.neg_edge = (flancos & BARRERA_BAJADA) != 0,
+    };
+    mcpwm_capture_event_callbacks_t avisos = {
+        .on_cap = Capturado,
+    };
+    if (mcpwm_new_capture_channel(temporizador, &canal, &self->canal) != ESP_OK) {
+        return NULL;
+    }
+    if ((mcpwm_capture_channel_register_event_callbacks(self->canal, &avisos, self) != ESP_OK) ||
+        (mcpwm_capture_channel_enable(self->canal) != ESP_OK)) {
+        mcpwm_del_capture_channel(self->canal);
+        return NULL;
+    }
+#else
+    (void)gpio;
+#endif
+    creadas++;
+    return self;
+}
+
+bool IRAM_ATTR BarreraCapturar(barrera_t self, uint32_t captura, bool subida) {
+    if (!(self->flancos & (subida ? BARRERA_SUBIDA : BARRERA_BAJADA))) {
+        return false;
+    }
+
+#ifdef ESP_PLATFORM
+    portENTER_CRITICAL_ISR(&cerrojo);
+#endif
+    int64_t instante = Convertir(captura);
+#ifdef ESP_PLATFORM
+    portEXIT_CRITICAL_ISR(&cerrojo);
+#endif
+
+    if (self->cortada && (instante - self->ultimo_us < self->bloqueo_us)) {
+        self->descartados++;
+        return false;
+    }
+    self->cortada = true;
+    self->ultimo_us = instante;
+    return self->aviso(self, instante, self->contexto);
+}
+
+uint32_t BarreraDescartados(barrera_t self) {
+    return self->descartados;
+}
+
+/* === End of documentation ======================================================================================== */
@@ -0,0 +1,153 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+#ifndef BARRERAS_H_
+#define BARRERAS_H_
+
+/** @file barreras.h
+ ** @brief Declaraciones de las barreras de luz con el instante de cada corte capturado por hardware
+ **
+ ** Cada barrera es una entrada conectada a un canal de captura del MCPWM, que guarda el valor de su temporizador en el
+ ** mismo flanco de la señal con una resolución de 12,5 ns, sin depender de cuándo se atiende la interrupción. El
+ ** valor capturado se convierte al reloj de alta resolución (esp_timer) que usa el cronómetro con un par de referencia
+ ** que se toma disparando por software una captura en un canal reservado. Ambos relojes derivan del mismo cristal, asi
+ ** que la referencia solo se renueva cada @ref BARRERAS_SINCRONIZACION_MS para que la cuenta de 32 bits del
+ ** temporizador de captura no dé la vuelta entre dos referencias.
+ **
+ ** Después de un corte aceptado la barrera ignora los flancos durante su periodo de bloqueo, asi los brazos y las
+ ** piernas que cortan el haz después del torso no generan eventos nuevos. El bloqueo se mide desde el último corte
+ ** aceptado, por lo que un haz que sigue cortado no lo extiende.
+ **
+ ** En la computadora de desarrollo no hay periférico: las capturas y las referencias se entregan con
+ ** @ref BarreraCapturar y @ref BarrerasSincronizar.
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* === Cabecera C++ ================================================================================================ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* === Public macros definitions =================================================================================== */
+
+//! @brief Cantidad máxima de barreras, un canal de captura del grupo queda reservado para la referencia
+#ifndef BARRERAS_MAXIMO
+#define BARRERAS_MAXIMO 2
+#endif
+
+//! @brief Periodo de renovación de la referencia entre el temporizador de captura y el reloj de alta resolución
+#ifndef BARRERAS_SINCRONIZACION_MS
+#define BARRERAS_SINCRONIZACION_MS 10000
+#endif
+
+/* === Public data type declarations =============================================================================== */
+
+//! @brief Tipo de dato para referenciar a una barrera
+typedef struct barrera_s * barrera_t;
+
+//! @brief Flancos de la señal del receptor que se toman como corte del haz
+typedef enum {
+    BARRERA_SUBIDA = 1, //!< El receptor pasa a nivel alto al cortarse el haz
+    BARRERA_BAJADA = 2, //!< El receptor pasa a nivel bajo al cortarse el haz
+    BARRERA_AMBOS = 3,  //!< Cualquier cambio de nivel es un corte
+} barrera_flancos_t;
+
+/**
+ * @brief Función que se llama con cada corte aceptado, en el ESP32 desde la interrupción de captura
+ *
+ * @param  barrera      Barrera que detectó el corte
+ * @param  instante_us  Instante del flanco medido con el reloj de alta resolución
+ * @param  contexto     Parámetro indicado al crear la barrera
+ * @return true         Se despertó una tarea de más prioridad que la interrumpida
+ * @return false        No hace falta cambiar de tarea al salir de la interrupción
+ */
+typedef bool (*barrera_aviso_t)(barrera_t barrera, int64_t instante_us, void * contexto);
+
+/* === Public variable declarations ================================================================================ */
+
+/* === Public function declarations ================================================================================ */
+
+/**
+ * @brief Función que inicializa el temporizador de captura y toma la primera referencia
+ *
+ * En el ESP32 crea el temporizador de captura del grupo 0 del MCPWM, el canal de la referencia y el temporizador
+ * que la renueva. Se debe llamar una única vez antes de crear cualquier barrera.
+ *
+ * @param  resolucion_hz  Frecuencia del temporizador de captura, solo se utiliza en la computadora de desarrollo
+ * @return true           Las barreras se inicializaron correctamente
+ * @return false          No se pudo configurar el periférico de captura
+ */
+bool BarrerasIniciar(uint32_t resolucion_hz);
+
+/**
+ * @brief Función que renueva la referencia entre el temporizador de captura y el reloj de alta resolución
+ *
+ * En el ESP32 la llama periódicamente el servicio esp_timer.
+ *
+ * @param  captura      Valor del temporizador de captura
+ * @param  instante_us  Instante del reloj de alta resolución que corresponde a ese valor
+ */
+void BarrerasSincronizar(uint32_t captura, int64_t instante_us);
+
+/**
+ * @brief Función que crea una barrera en un canal de captura libre
+ *
+ * @param  gpio        Terminal del receptor, en el ESP32 debe tener su propia resistencia de pull-up si la necesita
+ * @param  flancos     Flancos que se toman como corte del haz
+ * @param  bloqueo_us  Tiempo que se ignoran los flancos después de un corte aceptado
+ * @param  aviso       Función que se llama con cada corte aceptado
+ * @param  contexto    Parámetro para la función de aviso
+ * @return barrera_t   Puntero a la barrera creada o NULL si no quedan canales de captura
+ */
+barrera_t BarreraCrear(int8_t gpio, barrera_flancos_t flancos, uint32_t bloqueo_us, barrera_aviso_t aviso,
+                       void * contexto);
+
+/**
+ * @brief Función que procesa un valor capturado en el flanco de una barrera
+ *
+ * En el ESP32 la llama la interrupción del canal de captura.
+ *
+ * @param  self     Puntero a la barrera creada con @ref BarreraCrear
+ * @param  captura  Valor del temporizador de captura en el flanco
+ * @param  subida   El flanco capturado es de subida
+ * @return true     La función de aviso despertó una tarea de más prioridad
+ * @return false    El flanco se descartó o no hace falta cambiar de tarea
+ */
+bool BarreraCapturar(barrera_t self, uint32_t captura, bool subida);
+
+/**
+ * @brief Función que devuelve la cantidad de flancos descartados por caer en el periodo de bloqueo
+ *
+ * @param  self      Puntero a la barrera creada con @ref BarreraCrear
+ * @return uint32_t  Flancos descartados desde que se creó la barrera
+ */
+uint32_t BarreraDescartados(barrera_t self);
+
+/* === End of documentation ======================================================================================== */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BARRERAS_H_ */
@@ -0,0 +1,189 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+/** @file bitacora.c
+ ** @brief Definiciones de la bitácora binaria de eventos para el camino de medición
+ **
+ ** El anillo es una cola acotada con un número de secuencia por casillero. Un productor reserva un casillero
+ ** avanzando la cabeza con una comparación e intercambio atómicos, copia el registro y publica el casillero
+ ** actualizando su secuencia. El consumidor solo lee un casillero después de su publicación, por lo que un productor
+ ** interrumpido a mitad de la copia nunca entrega un registro incompleto.
+ **
+ ** La secuencia se guarda descontando el índice del casillero, de modo que el anillo en cero ya está listo para usar
+ ** y se puede escribir antes de iniciar la tarea que lo vacía.
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include "bitacora.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <stdio.h>
+
+/* === Macros definitions ========================================================================================== */
+
+#define MASCARA (BITACORA_CAPACIDAD - 1)
+#define PILA    3072 //!< Tamaño de la pila de la tarea que vacía el anillo, incluye el formateo con ESP_LOG
+
+_Static_assert((BITACORA_CAPACIDAD & MASCARA) == 0, "La capacidad de la bitácora debe ser una potencia de dos");
+
+/* === Private data type declarations ============================================================================== */
+
+//! @brief Casillero del anillo
+struct casillero_s {
+    atomic_uint secuencia; //!< Posición menos el índice si está libre, uno más si tiene un registro
+    uint32_t instante_us;  //!< Parte baja del instante, la parte alta se reconstruye al leer
+    uint16_t evento;
+    int32_t primero;
+    int32_t segundo;
+};
+
+/* === Private variable declarations =============================================================================== */
+
+/* === Private function declarations =============================================================================== */
+
+/**
+ * @brief Tarea que vacía el anillo periódicamente
+ *
+ * @param  parametros  No se utiliza
+ */
+static void BitacoraTask(void * parametros);
+
+/* === Public variable definitions ================================================================================= */
+
+/* === Private variable definitions ================================================================================ */
+
+//! @brief Casilleros del anillo
+static struct casillero_s anillo[BITACORA_CAPACIDAD];
+
+//! @brief Próxima posición a reservar por los productores
+static atomic_uint cabeza;
+
+//! @brief Próxima posición a leer por el consumidor
+static uint32_t cola;
+
+//! @brief Cantidad de eventos descartados
+static atomic_uint perdidos;
+
+//! @brief Etiqueta con la que se muestran los eventos
+static const char * etiqueta_eventos;
+
+//! @brief Texto de cada evento
+static const char * const * textos_eventos;
+
+//! @brief Cantidad de textos
+static uint16_t cantidad_textos;
+
+/* === Private function definitions ================================================================================ */
+
+static void BitacoraTask(void * parametros) {
+    bitacora_registro_t registro;
+    uint32_t informados = 0;
+    char texto[96];
+
+    while (1) {
+        while (BitacoraLeer(&registro)) {
+            if (registro.evento < cantidad_textos) {
+                snprintf(texto, sizeof(texto), textos_eventos[registro.evento], registro.primero, registro.segundo);
+            } else {
+                snprintf(texto, sizeof(texto), "Evento %u (%" PRId32 ", %" PRId32 ")", registro.evento,
+                         registro.primero, registro.segundo);
+            }
+            ESP_LOGI(etiqueta_eventos, "@%" PRId64 ".%06" PRId64 " %s", registro.instante_us / 1000000,
+                     registro.instante_us % 1000000, texto);
+        }
+
+        uint32_t total = atomic_load_explicit(&perdidos, memory_order_relaxed);
+        if (total != informados) {
+            ESP_LOGW(etiqueta_eventos, "Bitácora llena, %" PRIu32 " eventos perdidos", total - informados);
+            informados = total;
+        }
+        vTaskDelay(pdMS_TO_TICKS(BITACORA_PERIODO_MS));
+    }
+}
+
+/* === Public function implementation ============================================================================== */
+
+bool BitacoraIniciar(const char * etiqueta, const char * const textos[], uint16_t cantidad, uint8_t prioridad) {
+    etiqueta_eventos = etiqueta;
+    textos_eventos = textos;
+    cantidad_textos = cantidad;
+    return xTaskCreate(BitacoraTask, "BitacoraTask", PILA, NULL, prioridad, NULL) == pdPASS;
+}
+
+bool IRAM_ATTR BitacoraEscribir(uint16_t evento, int32_t primero, int32_t segundo) {
+    uint32_t instante = (uint32_t)esp_timer_get_time();
+    struct casillero_s * casillero;
+
+    uint32_t posicion = atomic_load_explicit(&cabeza, memory_order_relaxed);
+    while (1) {
+        casillero = &anillo[posicion & MASCARA];
+        uint32_t secuencia = atomic_load_explicit(&casillero->secuencia, memory_order_acquire) + (posicion & MASCARA);
+        int32_t diferencia = (int32_t)(secuencia - posicion);
+        if (diferencia == 0) {
+            /* Casillero libre, se reserva si ningún otro productor avanzó la cabeza mientras tanto */
+            if (atomic_compare_exchange_weak_explicit(&cabeza, &posicion, posicion + 1, memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                break;
+            }
+        } else if (diferencia < 0) {
+            /* El consumidor todavía no liberó el casillero de la vuelta anterior */
+            atomic_fetch_add_explicit(&perdidos, 1, memory_order_relaxed);
+            return false;
+        } else {
+            posicion = atomic_load_explicit(&cabeza, memory_order_relaxed);
+        }
+    }
+
+    casillero->instante_us = instante;
+    casillero->evento = evento;
+    casillero->primero = primero;
+    casillero->segundo = segundo;
+    atomic_store_explicit(&casillero->secuencia, posicion + 1 - (posicion & MASCARA), memory_order_release);
+    return true;
+}
+
+bool BitacoraLeer(bitacora_registro_t * registro) {
+    struct casillero_s * casillero = &anillo[cola & MASCARA];
+
+    if (atomic_load_explicit(&casillero->secuencia, memory_order_acquire) + (cola & MASCARA) != cola + 1) {
+        return false;
+    }
+
+    /* El registro se escribió hace menos de 71 minutos, la parte alta del instante se toma del reloj actual */
+    int64_t ahora = esp_timer_get_time();
+    registro->instante_us = ahora - (uint32_t)((uint32_t)ahora - casillero->instante_us);
+    registro->evento = casillero->evento;
+    registro->primero = casillero->primero;
+    registro->segundo = casillero->segundo;
+    atomic_store_explicit(&casillero->secuencia, cola + BITACORA_CAPACIDAD - (cola & MASCARA), memory_order_release);
+    cola++;
+    return true;
+}
+
+uint32_t BitacoraPerdidos(void) {
+    return atomic_load_explicit(&perdidos, memory_order_relaxed);
+}
+
+/* === End of documentation ======================================================================================== */
@@ -0,0 +1,121 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+#ifndef BITACORA_H_
+#define BITACORA_H_
+
+/** @file bitacora.h
+ ** @brief Declaraciones de la bitácora binaria de eventos para el camino de medición
+ **
+ ** Escribir en la bitácora solo copia un registro de tamaño fijo (instante, número de evento y dos argumentos) en un
+ ** anillo sin bloqueos, por lo que se puede llamar desde cualquier tarea, con mutex tomados, o desde una interrupción
+ ** sin que el formateo ni la salida por el puerto serie alarguen la sección crítica. Una tarea de baja prioridad vacía
+ ** el anillo, da formato a cada registro con el texto que corresponde a su número de evento y lo muestra con ESP_LOG.
+ **
+ ** Si el anillo está lleno el registro nuevo se descarta y se cuenta; la tarea que vacía el anillo informa la cantidad
+ ** de registros perdidos.
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* === Cabecera C++ ================================================================================================ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* === Public macros definitions =================================================================================== */
+
+//! @brief Cantidad de registros del anillo, debe ser una potencia de dos
+#ifndef BITACORA_CAPACIDAD
+#define BITACORA_CAPACIDAD 64
+#endif
+
+//! @brief Período en milisegundos con que se vacía el anillo
+#ifndef BITACORA_PERIODO_MS
+#define BITACORA_PERIODO_MS 100
+#endif
+
+/* === Public data type declarations =============================================================================== */
+
+//! @brief Registro de la bitácora
+typedef struct {
+    int64_t instante_us; //!< Instante del evento según esp_timer_get_time
+    uint16_t evento;     //!< Número de evento, índice en la tabla de textos
+    int32_t primero;     //!< Primer argumento del texto
+    int32_t segundo;     //!< Segundo argumento del texto
+} bitacora_registro_t;
+
+/* === Public variable declarations ================================================================================ */
+
+/* === Public function declarations ================================================================================ */
+
+/**
+ * @brief Función que crea la tarea que vacía el anillo
+ *
+ * @param  etiqueta   Etiqueta con la que se muestran los eventos por ESP_LOG
+ * @param  textos     Texto de cada evento, con hasta dos conversiones de tipo int32_t, se usa por referencia
+ * @param  cantidad   Cantidad de textos
+ * @param  prioridad  Prioridad de la tarea que vacía el anillo
+ * @return true       La tarea se creó correctamente
+ * @return false      No se pudo crear la tarea
+ */
+bool BitacoraIniciar(const char * etiqueta, const char * const textos[], uint16_t cantidad, uint8_t prioridad);
+
+/**
+ * @brief Función que agrega un evento a la bitácora en tiempo constante
+ *
+ * Se puede llamar antes de @ref BitacoraIniciar, los eventos se muestran cuando comienza a funcionar la tarea.
+ *
+ * @param  evento   Número de evento
+ * @param  primero  Primer argumento del texto
+ * @param  segundo  Segundo argumento del texto
+ * @return true     El evento se agregó
+ * @return false    El anillo estaba lleno y el evento se descartó
+ */
+bool BitacoraEscribir(uint16_t evento, int32_t primero, int32_t segundo);
+
+/**
+ * @brief Función que retira el registro más antiguo del anillo
+ *
+ * Solo la debe llamar un único consumidor, que normalmente es la tarea creada por @ref BitacoraIniciar.
+ *
+ * @param  registro  Puntero donde se devuelve el registro
+ * @return true      Se retiró un registro
+ * @return false     El anillo está vacío
+ */
+bool BitacoraLeer(bitacora_registro_t * registro);
+
+/**
+ * @brief Función que devuelve la cantidad de eventos descartados por encontrar el anillo lleno
+ *
+ * @return uint32_t  Cantidad de eventos descartados desde el arranque
+ */
+uint32_t BitacoraPerdidos(void);
+
+/* === End of documentation ======================================================================================== */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BITACORA_H_ */
@@ -0,0 +1,228 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+/** @file calibracion.c
+ ** @brief Definiciones de la calibración de la deriva del reloj local contra un pulso de referencia
+ **
+ ** La medición solo guarda el instante del primer y del último pulso válido y los segundos de referencia entre ambos,
+ ** asi el error de cada instante (la latencia de la interrupción) no se acumula y se reparte en toda la medición.
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include "calibracion.h"
+
+#ifdef ESP_PLATFORM
+#include "freertos/FreeRTOS.h"
+#include "nvs.h"
+#include "nvs_flash.h"
+#endif
+
+/* === Macros definitions ========================================================================================== */
+
+#define SEGUNDO_US   1000000LL    //!< Microsegundos en un segundo
+#define ESPACIO_NVS  "cronometro" //!< Espacio de nombres en la memoria no volátil
+#define CLAVE_DERIVA "deriva_ppb" //!< Clave de la deriva guardada
+
+/* === Private data type declarations ============================================================================== */
+
+/* === Private variable declarations =============================================================================== */
+
+/* === Private function declarations =============================================================================== */
+
+/**
+ * @brief Función que toma un pulso como el primero de una medición nueva
+ *
+ * @param  instante_us  Instante del pulso medido con el reloj local
+ */
+static void Comenzar(int64_t instante_us);
+
+#ifdef ESP_PLATFORM
+/**
+ * @brief Función que abre el espacio de nombres de la memoria no volátil, inicializándola la primera vez
+ *
+ * @param[out] manejador  Manejador del espacio de nombres abierto
+ * @param  modo           Modo de apertura, de lectura o de lectura y escritura
+ * @return true           El espacio de nombres quedó abierto
+ * @return false          No se pudo acceder a la memoria no volátil
+ */
+static bool Abrir(nvs_handle_t * manejador, nvs_open_mode_t modo);
+#endif
+
+/* === Public variable definitions ================================================================================= */
+
+/* === Private variable definitions ================================================================================ */
+
+//! @brief Instante del primer pulso de la medición en curso
+static int64_t primero_us;
+
+//! @brief Instante del último pulso de la medición en curso
+static int64_t ultimo_us;
+
+//! @brief Segundos de referencia entre el primer y el último pulso
+static uint32_t segundos;
+
+//! @brief Se recibió el primer pulso de la medición en curso
+static bool comenzada;
+
+//! @brief Cantidad de pulsos descartados desde que se inició la medición
+static uint32_t descartados;
+
+//! @brief El pulso anterior se descartó por apartarse de la referencia
+static bool anterior_descartado;
+
+#ifdef ESP_PLATFORM
+//! @brief Protege la medición, que actualiza el lazo de control y consulta la consola
+static portMUX_TYPE cerrojo = portMUX_INITIALIZER_UNLOCKED;
+#define BLOQUEAR()    portENTER_CRITICAL(&cerrojo)
+#define DESBLOQUEAR() portEXIT_CRITICAL(&cerrojo)
+#else
+#define BLOQUEAR()
+#define DESBLOQUEAR()
+
+//! @brief Deriva guardada, reemplaza a la memoria no volátil en el simulador
+static int32_t guardada;
+static bool hay_guardada;
+#endif
+
+/* === Private function definitions ================================================================================ */
+
+static void Comenzar(int64_t instante_us) {
+    primero_us = instante_us;
+    ultimo_us = instante_us;
+    segundos = 0;
+    comenzada = true;
+    anterior_descartado = false;
+}
+
+#ifdef ESP_PLATFORM
+static bool Abrir(nvs_handle_t * manejador, nvs_open_mode_t modo) {
+    static bool iniciada = false;
+
+    if (!iniciada) {
+        esp_err_t error = nvs_flash_init();
+        if ((error == ESP_ERR_NVS_NO_FREE_PAGES) || (error == ESP_ERR_NVS_NEW_VERSION_FOUND)) {
+            /* La partición está llena o tiene otro formato, se borra y se vuelve a inicializar */
+            if (nvs_flash_erase() == ESP_OK) {
+                error = nvs_flash_init();
+            }
+        }
+        iniciada = (error == ESP_OK);
+    }
+    return iniciada && (nvs_open(ESPACIO_NVS, modo, manejador) == ESP_OK);
+}
+#endif
+
+/* === Public function implementation ============================================================================== */
+
+void CalibracionIniciar(void) {
+    BLOQUEAR();
+    comenzada = false;
+    segundos = 0;
+    descartados = 0;
+    DESBLOQUEAR();
+}
+
+void CalibracionPulso(int64_t instante_us) {
+    BLOQUEAR();
+    if (!comenzada) {
+        Comenzar(instante_us);
+    } else {
+        int64_t intervalo = instante_us - ultimo_us;
+        int64_t enteros = (intervalo + SEGUNDO_US / 2) / SEGUNDO_US;
+        int64_t error = intervalo - enteros * SEGUNDO_US;
+        int64_t limite = enteros * CALIBRACION_MAXIMO_PPM;
+
+        if ((enteros == 0) || (error > limite) || (error < -limite)) {
+            /* Un pulso falso se ignora, dos seguidos indican que la referencia cambió de fase */
+            descartados++;
+            if (anterior_descartado) {
+                Comenzar(instante_us);
+            } else {
+                anterior_descartado = true;
+            }
+        } else {
+            segundos += enteros;
+            ultimo_us = instante_us;
+            anterior_descartado = false;
+        }
+    }
+    DESBLOQUEAR();
+}
+
+uint32_t CalibracionSegundos(void) {
+    return segundos;
+}
+
+uint32_t CalibracionDescartados(void) {
+    return descartados;
+}
+
+bool CalibracionResultado(int32_t * ppb) {
+    BLOQUEAR();
+    int64_t diferencia = (ultimo_us - primero_us) - (int64_t)segundos * SEGUNDO_US;
+    uint32_t referencia = segundos;
+    DESBLOQUEAR();
+
+    if (referencia < CALIBRACION_MINIMO_S) {
+        return false;
+    }
+    /* Microsegundos de diferencia por segundo de referencia son ppm, por mil son ppb */
+    int64_t resultado = diferencia * 1000 / referencia;
+    if ((resultado > CALIBRACION_MAXIMO_PPM * 1000) || (resultado < -CALIBRACION_MAXIMO_PPM * 1000)) {
+        return false;
+    }
+    *ppb = (int32_t)resultado;
+    return true;
+}
+
+bool CalibracionCargar(int32_t * ppb) {
+#ifdef ESP_PLATFORM
+    nvs_handle_t manejador;
+    if (!Abrir(&manejador, NVS_READONLY)) {
+        return false;
+    }
+    bool leida = (nvs_get_i32(manejador, CLAVE_DERIVA, ppb) == ESP_OK);
+    nvs_close(manejador);
+    return leida;
+#else
+    if (hay_guardada) {
+        *ppb = guardada;
+    }
+    return hay_guardada;
+#endif
+}
+
+bool CalibracionGuardar(int32_t ppb) {
+#ifdef ESP_PLATFORM
+    nvs_handle_t manejador;
+    if (!Abrir(&manejador, NVS_READWRITE)) {
+        return false;
+    }
+    bool guardada = (nvs_set_i32(manejador, CLAVE_DERIVA, ppb) == ESP_OK) && (nvs_commit(manejador) == ESP_OK);
+    nvs_close(manejador);
+    return guardada;
+#else
+    guardada = ppb;
+    hay_guardada = true;
+    return true;
+#endif
+}
+
+/* === End of documentation ======================================================================================== */
@@ -0,0 +1,125 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+#ifndef CALIBRACION_H_
+#define CALIBRACION_H_
+
+/** @file calibracion.h
+ ** @brief Declaraciones de la calibración de la deriva del reloj local contra un pulso de referencia
+ **
+ ** La medición recibe los instantes, según el reloj local, de un pulso de referencia que se repite cada un número
+ ** entero de segundos, por ejemplo la salida 1PPS de un receptor GPS. Cada intervalo se redondea a segundos enteros,
+ ** asi un pulso perdido no afecta la medición, y la deriva es la diferencia acumulada entre el tiempo local y el de la
+ ** referencia dividida por el tiempo de la referencia. Un pulso que se aparta de los segundos enteros más de lo que
+ ** admite @ref CALIBRACION_MAXIMO_PPM se toma como falso y se descarta, pero si el siguiente también se aparta se
+ ** supone que cambió la referencia y la medición vuelve a empezar.
+ **
+ ** La deriva calibrada se guarda en la memoria no volátil (NVS) para aplicarla en cada arranque. Los instantes los
+ ** indica el llamador, asi la medición no depende del reloj del ESP32 y se puede usar en un simulador.
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* === Cabecera C++ ================================================================================================ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* === Public macros definitions =================================================================================== */
+
+#ifndef CALIBRACION_MINIMO_S
+//! Tiempo de referencia mínimo, en segundos, para dar un resultado (con 60 s un error de 1 us son 0,017 ppm)
+#define CALIBRACION_MINIMO_S 60
+#endif
+
+#ifndef CALIBRACION_MAXIMO_PPM
+//! Mayor deriva aceptada, en partes por millón, y mayor error admitido en cada intervalo entre pulsos
+#define CALIBRACION_MAXIMO_PPM 500
+#endif
+
+/* === Public data type declarations =============================================================================== */
+
+/* === Public variable declarations ================================================================================ */
+
+/* === Public function declarations ================================================================================ */
+
+/**
+ * @brief Función que descarta la medición en curso y comienza una nueva con el próximo pulso
+ */
+void CalibracionIniciar(void);
+
+/**
+ * @brief Función que agrega un pulso de referencia a la medición en curso
+ *
+ * @param  instante_us  Instante del pulso medido con el reloj local, en microsegundos
+ */
+void CalibracionPulso(int64_t instante_us);
+
+/**
+ * @brief Función que devuelve el tiempo de referencia medido desde el primer pulso válido
+ *
+ * @return uint32_t  Tiempo de la referencia en segundos
+ */
+uint32_t CalibracionSegundos(void);
+
+/**
+ * @brief Función que devuelve la cantidad de pulsos descartados desde que se inició la medición
+ *
+ * @return uint32_t  Cantidad de pulsos descartados
+ */
+uint32_t CalibracionDescartados(void);
+
+/**
+ * @brief Función que calcula la deriva del reloj local medida hasta el último pulso
+ *
+ * @param[out] ppb  Deriva en partes por mil millones, positiva si el reloj local adelanta respecto de la referencia
+ * @return true     La medición abarca al menos @ref CALIBRACION_MINIMO_S y la deriva es aceptable
+ * @return false    La medición es demasiado corta o la deriva supera @ref CALIBRACION_MAXIMO_PPM
+ */
+bool CalibracionResultado(int32_t * ppb);
+
+/**
+ * @brief Función que lee la deriva guardada en la memoria no volátil
+ *
+ * @param[out] ppb  Deriva guardada en partes por mil millones, sin cambios si no hay una guardada
+ * @return true     Se leyó una deriva guardada
+ * @return false    No hay una deriva guardada o no se pudo acceder a la memoria no volátil
+ */
+bool CalibracionCargar(int32_t * ppb);
+
+/**
+ * @brief Función que guarda una deriva en la memoria no volátil
+ *
+ * @param  ppb    Deriva en partes por mil millones
+ * @return true   La deriva quedó guardada
+ * @return false  No se pudo escribir la memoria no volátil
+ */
+bool CalibracionGuardar(int32_t ppb);
+
+/* === End of documentation ======================================================================================== */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CALIBRACION_H_ */
@@ -0,0 +1,69 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+/** @file consola.c
+ ** @brief Definiciones de la consola de comandos por el puerto serie
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include "consola.h"
+#include "esp_console.h"
+
+/* === Macros definitions ========================================================================================== */
+
+#define PROMPT "cronometro> " //!< Texto que indica que la consola espera un comando
+
+/* === Private data type declarations ============================================================================== */
+
+/* === Private variable declarations =============================================================================== */
+
+/* === Private function declarations =============================================================================== */
+
+/* === Public variable definitions ================================================================================= */
+
+/* === Private variable definitions ================================================================================ */
+
+/* === Private function definitions ================================================================================ */
+
+/* === Public function implementation ============================================================================== */
+
+bool ConsolaIniciar(void) {
+    esp_console_repl_t * repl = NULL;
+    esp_console_repl_config_t configuracion = ESP_CONSOLE_REPL_CONFIG_DEFAULT();
+    esp_console_dev_uart_config_t puerto = ESP_CONSOLE_DEV_UART_CONFIG_DEFAULT();
+
+    configuracion.prompt = PROMPT;
+    if (esp_console_new_repl_uart(&puerto, &configuracion, &repl) != ESP_OK) {
+        return false;
+    }
+    esp_console_register_help_command();
+    return esp_console_start_repl(repl) == ESP_OK;
+}
+
+bool ConsolaRegistrar(const char * nombre, const char * ayuda, consola_comando_t funcion) {
+    const esp_console_cmd_t comando = {
+        .command = nombre,
+        .help = ayuda,
+        .func = funcion,
+    };
+    return esp_console_cmd_register(&comando) == ESP_OK;
+}
+
+/* === End of documentation ======================================================================================== */
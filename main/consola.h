@@ -0,0 +1,78 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+#ifndef CONSOLA_H_
+#define CONSOLA_H_
+
+/** @file consola.h
+ ** @brief Declaraciones de la consola de comandos por el puerto serie
+ **
+ ** La consola permite consultar en funcionamiento las estadísticas que recolectan los distintos módulos. Cada
+ ** comando es una función con la misma firma que @c main, que escribe su resultado con @c printf.
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include <stdbool.h>
+
+/* === Cabecera C++ ================================================================================================ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* === Public macros definitions =================================================================================== */
+
+/* === Public data type declarations =============================================================================== */
+
+//! @brief Función que ejecuta un comando, devuelve cero si el comando se ejecutó correctamente
+typedef int (*consola_comando_t)(int argc, char ** argv);
+
+/* === Public variable declarations ================================================================================ */
+
+/* === Public function declarations ================================================================================ */
+
+/**
+ * @brief Función que inicia la consola en el puerto serie del monitor
+ *
+ * Crea la tarea que lee y ejecuta los comandos. Los comandos se deben registrar después de iniciarla.
+ *
+ * @return true   La consola se inició correctamente
+ * @return false  No se pudo iniciar la consola
+ */
+bool ConsolaIniciar(void);
+
+/**
+ * @brief Función que agrega un comando a la consola
+ *
+ * @param  nombre   Nombre del comando, la cadena debe existir mientras funcione la consola
+ * @param  ayuda    Descripción que muestra el comando help
+ * @param  funcion  Función que ejecuta el comando
+ * @return true     El comando se registró correctamente
+ * @return false    No se pudo registrar el comando
+ */
+bool ConsolaRegistrar(const char * nombre, const char * ayuda, consola_comando_t funcion);
+
+/* === End of documentation ======================================================================================== */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONSOLA_H_ */
@@ -0,0 +1,136 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+/** @file contador.c
+ ** @brief Definiciones del contador de tiempo en digitos decimales que avanza sin divisiones
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include "contador.h"
+#include <stddef.h>
+#include <string.h>
+
+/* === Macros definitions ========================================================================================== */
+
+/* === Private data type declarations ============================================================================== */
+
+//! @brief Estado de un contador
+struct contador_s {
+    uint8_t cantidad;                  //!< Cantidad de digitos
+    uint8_t bases[CONTADOR_DIGITOS];   //!< Base de cada digito, del más significativo al menos significativo
+    uint8_t digitos[CONTADOR_DIGITOS]; //!< Valor de cada digito, en el mismo orden que las bases
+    uint32_t unidad_us;                //!< Microsegundos que representa el digito menos significativo
+    uint64_t limite_us;                //!< Mayor avance que se hace de a una unidad
+    uint64_t actual_us;                //!< Comienzo de la unidad que muestra el contador
+};
+
+/* === Private variable declarations =============================================================================== */
+
+/* === Private function declarations =============================================================================== */
+
+/**
+ * @brief Función que suma una unidad al contador propagando el acarreo
+ *
+ * @param  self      Puntero al contador
+ * @return uint32_t  Máscara con los digitos que cambiaron
+ */
+static uint32_t Incrementar(contador_t self);
+
+/* === Public variable definitions ================================================================================= */
+
+/* === Private variable definitions ================================================================================ */
+
+//! @brief Contadores disponibles
+static struct contador_s instancias[CONTADOR_MAXIMO];
+
+//! @brief Cantidad de contadores creados
+static uint8_t creados;
+
+/* === Private function definitions ================================================================================ */
+
+static uint32_t Incrementar(contador_t self) {
+    uint32_t cambios = 0;
+
+    for (int posicion = self->cantidad - 1; posicion >= 0; posicion--) {
+        cambios |= 1UL << posicion;
+        if (++self->digitos[posicion] < self->bases[posicion]) {
+            break;
+        }
+        self->digitos[posicion] = 0;
+    }
+    return cambios;
+}
+
+/* === Public function implementation ============================================================================== */
+
+contador_t ContadorCrear(const uint8_t * bases, uint8_t digitos, uint32_t unidad_us) {
+    if (creados >= CONTADOR_MAXIMO || digitos == 0 || digitos > CONTADOR_DIGITOS || unidad_us == 0) {
+        return NULL;
+    }
+    for (uint8_t posicion = 0; posicion < digitos; posicion++) {
+        if (bases[posicion] < 2 || bases[posicion] > 10) {
+            return NULL;
+        }
+    }
+    contador_t self = &instancias[creados++];
+    self->cantidad = digitos;
+    memcpy(self->bases, bases, digitos);
+    memset(self->digitos, 0, sizeof(self->digitos));
+    self->unidad_us = unidad_us;
+    self->limite_us = (uint64_t)CONTADOR_PASOS_MAXIMOS * unidad_us;
+    self->actual_us = 0;
+    return self;
+}
+
+uint32_t ContadorAvanzar(contador_t self, uint64_t tiempo_us) {
+    uint32_t cambios = 0;
+
+    /* Un salto hacia atrás o demasiado largo, por ejemplo un reinicio o un cambio de canal, se resuelve dividiendo */
+    if (tiempo_us < self->actual_us || tiempo_us - self->actual_us > self->limite_us) {
+        return ContadorSincronizar(self, tiempo_us);
+    }
+    while (tiempo_us - self->actual_us >= self->unidad_us) {
+        cambios |= Incrementar(self);
+        self->actual_us += self->unidad_us;
+    }
+    return cambios;
+}
+
+uint32_t ContadorSincronizar(contador_t self, uint64_t tiempo_us) {
+    uint64_t valor = tiempo_us / self->unidad_us;
+    uint32_t cambios = 0;
+
+    self->actual_us = valor * self->unidad_us;
+    for (int posicion = self->cantidad - 1; posicion >= 0; posicion--) {
+        uint8_t digito = valor % self->bases[posicion];
+        valor /= self->bases[posicion];
+        if (self->digitos[posicion] != digito) {
+            self->digitos[posicion] = digito;
+            cambios |= 1UL << posicion;
+        }
+    }
+    return cambios;
+}
+
+const uint8_t * ContadorDigitos(contador_t self) {
+    return self->digitos;
+}
+
+/* === End of documentation ======================================================================================== */
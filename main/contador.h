@@ -0,0 +1,119 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+#ifndef CONTADOR_H_
+#define CONTADOR_H_
+
+/** @file contador.h
+ ** @brief Declaraciones del contador de tiempo en digitos decimales que avanza sin divisiones
+ **
+ ** El contador guarda el tiempo como un digito por byte, del más significativo al menos significativo, y cada digito
+ ** tiene su propia base: 10 para las unidades y las fracciones de segundo, 6 para las decenas de segundos y de
+ ** minutos. Con las bases adecuadas el mismo contador sirve para horas, minutos, segundos y fracciones hasta el
+ ** microsegundo, y el digito más significativo vuelve a cero al desbordar.
+ **
+ ** Al avanzar hasta un instante posterior el contador suma de a una unidad propagando el acarreo, que en la gran
+ ** mayoría de los pasos solo modifica el último digito. Solo cuando el instante es anterior al actual o está a más
+ ** de @ref CONTADOR_PASOS_MAXIMOS unidades se resincroniza con divisiones a partir de los microsegundos. En ambos
+ ** casos se devuelve una máscara con los digitos que cambiaron, asi el llamador sabe qué redibujar sin comparar ni
+ ** dividir.
+ **
+ ** Las funciones de esta biblioteca no son reentrantes, el llamador debe serializar el acceso.
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include <stdint.h>
+
+/* === Cabecera C++ ================================================================================================ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* === Public macros definitions =================================================================================== */
+
+//! @brief Cantidad máxima de digitos de un contador, como máximo 32 por el tamaño de la máscara de cambios
+#ifndef CONTADOR_DIGITOS
+#define CONTADOR_DIGITOS 12
+#endif
+
+//! @brief Cantidad máxima de unidades que se avanzan de a una antes de resincronizar con divisiones
+#ifndef CONTADOR_PASOS_MAXIMOS
+#define CONTADOR_PASOS_MAXIMOS 256
+#endif
+
+//! @brief Cantidad máxima de contadores que se pueden crear
+#ifndef CONTADOR_MAXIMO
+#define CONTADOR_MAXIMO 2
+#endif
+
+/* === Public data type declarations =============================================================================== */
+
+//! @brief Tipo de dato para referenciar a un contador
+typedef struct contador_s * contador_t;
+
+/* === Public variable declarations ================================================================================ */
+
+/* === Public function declarations ================================================================================ */
+
+/**
+ * @brief Función que crea un contador en cero
+ *
+ * @param  bases       Base de cada digito, del más significativo al menos significativo (entre 2 y 10)
+ * @param  digitos     Cantidad de digitos del contador
+ * @param  unidad_us   Microsegundos que representa el digito menos significativo
+ * @return contador_t  Puntero al contador creado o NULL si no quedan contadores o los parámetros no son válidos
+ */
+contador_t ContadorCrear(const uint8_t * bases, uint8_t digitos, uint32_t unidad_us);
+
+/**
+ * @brief Función que lleva el contador al valor de un instante, avanzando de a una unidad si es posible
+ *
+ * @param  self       Puntero al contador creado con @ref ContadorCrear
+ * @param  tiempo_us  Tiempo a representar en microsegundos
+ * @return uint32_t   Máscara con el bit n en uno si cambió el digito n, contando desde el más significativo. Puede
+ *                    incluir un digito que dio una vuelta completa y volvió a su valor
+ */
+uint32_t ContadorAvanzar(contador_t self, uint64_t tiempo_us);
+
+/**
+ * @brief Función que recalcula todos los digitos del contador a partir de los microsegundos
+ *
+ * @param  self       Puntero al contador creado con @ref ContadorCrear
+ * @param  tiempo_us  Tiempo a representar en microsegundos
+ * @return uint32_t   Máscara con el bit n en uno si cambió el digito n, contando desde el más significativo
+ */
+uint32_t ContadorSincronizar(contador_t self, uint64_t tiempo_us);
+
+/**
+ * @brief Función que devuelve los digitos del valor actual del contador
+ *
+ * @param  self             Puntero al contador creado con @ref ContadorCrear
+ * @return const uint8_t *  Valor de cada digito, del más significativo al menos significativo
+ */
+const uint8_t * ContadorDigitos(contador_t self);
+
+/* === End of documentation ======================================================================================== */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONTADOR_H_ */
@@ -0,0 +1,235 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+/** @file cronometro.c
+ ** @brief Definiciones del estado de los canales del cronómetro persistente en la memoria RTC
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include "cronometro.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_rom_crc.h"
+#include "esp_rtc_time.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include <stddef.h>
+#include <string.h>
+
+/* === Macros definitions ========================================================================================== */
+
+#define TAG              "CRONOMETRO"
+#define MARCA_VALIDA     0x43524F4E //!< Valor que identifica un estado inicializado ("CRON")
+#define LARGO_VERIFICADO offsetof(struct estado_s, verificacion)
+#define PPB              1000000000LL //!< Partes por mil millones de la unidad
+
+_Static_assert(CRONOMETRO_CANALES <= 32, "El estado de ejecución de los canales se guarda en 32 bits");
+
+/* === Private data type declarations ============================================================================== */
+
+//! @brief Estado de los canales que se conserva en la memoria RTC, organizado como estructura de arreglos
+struct estado_s {
+    uint32_t marca;                                //!< Igual a @ref MARCA_VALIDA cuando el estado fue inicializado
+    uint32_t corriendo;                            //!< Bit n en uno si el canal n está corriendo
+    uint32_t vueltas[CRONOMETRO_CANALES];          //!< Cantidad de vueltas registradas
+    uint64_t acumulado_us[CRONOMETRO_CANALES];     //!< Tiempo acumulado hasta el último arranque o suspensión
+    uint64_t dormido_us[CRONOMETRO_CANALES];       //!< Tiempo corriendo medido con el reloj del RTC, sin corregir
+    int64_t inicio_us[CRONOMETRO_CANALES];         //!< Instante del último arranque según el reloj de alta resolución
+    uint64_t inicio_rtc_us[CRONOMETRO_CANALES];    //!< Mismo instante medido con el reloj del RTC
+    uint32_t verificacion;                         //!< CRC de los campos anteriores
+};
+
+/* === Private variable declarations =============================================================================== */
+
+//! @brief Estado de los canales, no se inicializa en los reinicios que conservan la memoria RTC
+static RTC_NOINIT_ATTR struct estado_s estado;
+
+/* === Private function declarations =============================================================================== */
+
+/**
+ * @brief Función que recalcula el CRC del estado después de cada modificación
+ */
+static void Sellar(void);
+
+/**
+ * @brief Función que verifica que el estado de la memoria RTC sea válido
+ *
+ * @return true   El estado está inicializado y su CRC es correcto
+ * @return false  El estado no es válido
+ */
+static bool Verificar(void);
+
+/**
+ * @brief Función que corrige un tiempo medido con el reloj local por la deriva fijada con @ref CronometroCorregir
+ *
+ * @param  tiempo_us  Tiempo medido con el reloj de alta resolución, el del RTC tiene su propia calibración
+ * @return uint64_t   Tiempo corregido
+ */
+static uint64_t Corregir(uint64_t tiempo_us);
+
+/* === Public variable definitions ================================================================================= */
+
+/* === Private variable definitions ================================================================================ */
+
+//! @brief Factor de corrección menos uno, en formato Q32 (con signo): el tiempo corregido es t + t * correccion / 2^32
+static int32_t correccion;
+
+/* === Private function definitions ================================================================================ */
+
+static void Sellar(void) {
+    estado.verificacion = esp_rom_crc32_le(0, (const uint8_t *)&estado, LARGO_VERIFICADO);
+}
+
+static bool Verificar(void) {
+    return (estado.marca == MARCA_VALIDA) &&
+           (estado.verificacion == esp_rom_crc32_le(0, (const uint8_t *)&estado, LARGO_VERIFICADO));
+}
+
+static uint64_t Corregir(uint64_t tiempo_us) {
+    /* El producto se hace por mitades de 32 bits para no desbordar con tiempos largos */
+    int64_t alta = (int64_t)(tiempo_us >> 32) * correccion;
+    int64_t baja = ((int64_t)(tiempo_us & UINT32_MAX) * correccion) >> 32;
+    return tiempo_us + alta + baja;
+}
+
+/* === Public function implementation ============================================================================== */
+
+bool CronometroRestaurar(void) {
+    if (!Verificar()) {
+        memset(&estado, 0, sizeof(estado));
+        estado.marca = MARCA_VALIDA;
+        Sellar();
+        return false;
+    }
+
+    uint64_t ahora_rtc = esp_rtc_get_time_us();
+    int64_t ahora = esp_timer_get_time();
+    /* Solo al despertar del sueño profundo la marca del RTC es la de CronometroSuspender y el intervalo es tiempo
+     * dormido. Después de un reinicio por software o por el perro guardián la marca es la del arranque, el tiempo
+     * despierto nunca se sumó a acumulado_us y se suma ahí para que se corrija como el resto */
+    uint64_t * destino = (esp_reset_reason() == ESP_RST_DEEPSLEEP) ? estado.dormido_us : estado.acumulado_us;
+    for (int canal = 0; canal < CRONOMETRO_CANALES; canal++) {
+        if (estado.corriendo & (1UL << canal)) {
+            if (ahora_rtc >= estado.inicio_rtc_us[canal]) {
+                destino[canal] += ahora_rtc - estado.inicio_rtc_us[canal];
+            } else {
+                /* El reloj del RTC se reinició, no hay forma de saber cuánto tiempo pasó */
+                ESP_LOGW(TAG, "Reloj RTC reiniciado, el canal %d queda detenido", canal);
+                estado.corriendo &= ~(1UL << canal);
+            }
+            estado.inicio_us[canal] = ahora;
+            estado.inicio_rtc_us[canal] = ahora_rtc;
+        }
+    }
+    Sellar();
+    return true;
+}
+
+void CronometroSuspender(void) {
+    uint64_t ahora_rtc = esp_rtc_get_time_us();
+    int64_t ahora = esp_timer_get_time();
+
+    for (int canal = 0; canal < CRONOMETRO_CANALES; canal++) {
+        if (estado.corriendo & (1UL << canal)) {
+            estado.acumulado_us[canal] += ahora - estado.inicio_us[canal];
+            estado.inicio_us[canal] = 0;
+            estado.inicio_rtc_us[canal] = ahora_rtc;
+        }
+    }
+    Sellar();
+}
+
+bool CronometroAlternarEn(uint8_t canal, int64_t instante_us) {
+    uint32_t mascara = 1UL << canal;
+
+    if (estado.corriendo & mascara) {
+        /* Un evento anterior al arranque no puede restar tiempo */
+        if (instante_us > estado.inicio_us[canal]) {
+            estado.acumulado_us[canal] += instante_us - estado.inicio_us[canal];
+        }
+        estado.corriendo &= ~mascara;
+    } else {
+        /* La marca del RTC se retrasa lo mismo que el evento, asi el sueño profundo cuenta desde el arranque real */
+        estado.inicio_us[canal] = instante_us;
+        estado.inicio_rtc_us[canal] = esp_rtc_get_time_us() - (esp_timer_get_time() - instante_us);
+        estado.corriendo |= mascara;
+    }
+    Sellar();
+    return (estado.corriendo & mascara) != 0;
+}
+
+void CronometroReiniciar(uint8_t canal) {
+    estado.acumulado_us[canal] = 0;
+    estado.dormido_us[canal] = 0;
+    estado.vueltas[canal] = 0;
+    estado.inicio_us[canal] = esp_timer_get_time();
+    estado.inicio_rtc_us[canal] = esp_rtc_get_time_us();
+    Sellar();
+}
+
+bool CronometroCorriendo(uint8_t canal) {
+    return (estado.corriendo & (1UL << canal)) != 0;
+}
+
+uint32_t CronometroCanalesCorriendo(void) {
+    return estado.corriendo;
+}
+
+uint64_t CronometroTranscurrido(uint8_t canal) {
+    return CronometroTranscurridoEn(canal, esp_timer_get_time());
+}
+
+uint64_t CronometroTranscurridoEn(uint8_t canal, int64_t instante_us) {
+    uint64_t resultado = estado.acumulado_us[canal];
+
+    if ((estado.corriendo & (1UL << canal)) && (instante_us > estado.inicio_us[canal])) {
+        resultado += instante_us - estado.inicio_us[canal];
+    }
+    return Corregir(resultado) + estado.dormido_us[canal];
+}
+
+void CronometroTranscurridos(uint64_t transcurridos[CRONOMETRO_CANALES]) {
+    int64_t ahora = esp_timer_get_time();
+    uint32_t corriendo = estado.corriendo;
+
+    /* Recorrido lineal de los arreglos, sin saltos para los canales detenidos */
+    for (int canal = 0; canal < CRONOMETRO_CANALES; canal++) {
+        uint64_t activo = 0 - (uint64_t)((corriendo >> canal) & 1);
+        uint64_t despierto = estado.acumulado_us[canal] + ((ahora - estado.inicio_us[canal]) & activo);
+        transcurridos[canal] = Corregir(despierto) + estado.dormido_us[canal];
+    }
+}
+
+uint32_t CronometroRegistrarVuelta(uint8_t canal) {
+    estado.vueltas[canal]++;
+    Sellar();
+    return estado.vueltas[canal];
+}
+
+uint32_t CronometroVueltas(uint8_t canal) {
+    return estado.vueltas[canal];
+}
+
+void CronometroCorregir(int32_t ppb) {
+    /* Un reloj que adelanta ppb mide t * (1 + ppb / 10^9), el factor que lo corrige es 10^9 / (10^9 + ppb) */
+    correccion = -(int64_t)ppb * (INT64_C(1) << 32) / (PPB + ppb);
+}
+
+/* === End of documentation ======================================================================================== */
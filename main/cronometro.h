@@ -0,0 +1,176 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+#ifndef CRONOMETRO_H_
+#define CRONOMETRO_H_
+
+/** @file cronometro.h
+ ** @brief Declaraciones del estado de los canales del cronómetro persistente en la memoria RTC
+ **
+ ** El cronómetro tiene @ref CRONOMETRO_CANALES canales independientes. El estado de cada canal (instante de arranque,
+ ** tiempo acumulado y cantidad de vueltas) se guarda como estructura de arreglos en la memoria lenta del RTC, que
+ ** se conserva durante el sueño profundo y los reinicios por software. Mientras el procesador está despierto el tiempo
+ ** se mide con el reloj de alta resolución (derivado del cristal) y el reloj del RTC solo se usa para cubrir el
+ ** intervalo en que el procesador estuvo dormido o reiniciándose.
+ **
+ ** Los tiempos se guardan medidos con el reloj local y la corrección de la deriva del cristal, indicada con
+ ** @ref CronometroCorregir, se aplica al devolverlos. Así una calibración nueva corrige también los tiempos en curso.
+ ** El tiempo dormido se acumula aparte y no se corrige, porque el reloj del RTC no deriva del cristal y ESP-IDF lo
+ ** calibra por su cuenta.
+ **
+ ** Las funciones de esta biblioteca no son reentrantes, el llamador debe serializar el acceso.
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* === Cabecera C++ ================================================================================================ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* === Public macros definitions =================================================================================== */
+
+//! @brief Cantidad de canales independientes del cronómetro, como máximo 32
+#ifndef CRONOMETRO_CANALES
+#define CRONOMETRO_CANALES 8
+#endif
+
+/* === Public data type declarations =============================================================================== */
+
+/* === Public variable declarations ================================================================================ */
+
+/* === Public function declarations ================================================================================ */
+
+/**
+ * @brief Función que recupera el estado guardado en la memoria RTC
+ *
+ * Si la memoria RTC no contiene un estado válido (por ejemplo después de un encendido) todos los canales se inicializan
+ * detenidos y en cero. A los canales que estaban corriendo se les suma el tiempo transcurrido mientras el procesador
+ * estuvo dormido o reiniciándose. Solo el intervalo del sueño profundo queda sin corregir, después de otro reinicio el
+ * tiempo desde la última marca incluye el que el canal corrió despierto y se corrige con el resto.
+ *
+ * @return true   Se recuperó un estado válido de la memoria RTC
+ * @return false  No había un estado válido y el cronómetro se inicializó en cero
+ */
+bool CronometroRestaurar(void);
+
+/**
+ * @brief Función que guarda el estado para que sobreviva a un sueño profundo
+ *
+ * Acumula el tiempo medido con el reloj de alta resolución y toma la marca del reloj del RTC a partir de la cual se
+ * medirá el intervalo dormido. Se debe llamar inmediatamente antes de entrar en sueño profundo.
+ */
+void CronometroSuspender(void);
+
+/**
+ * @brief Función que arranca o detiene un canal en un instante ya pasado
+ *
+ * Permite usar el instante en que se produjo el evento, por ejemplo el capturado por hardware en una barrera de luz,
+ * en lugar del instante en que se atiende.
+ *
+ * @param  canal        Número de canal, entre 0 y @ref CRONOMETRO_CANALES - 1
+ * @param  instante_us  Instante del evento medido con el reloj de alta resolución, no posterior al actual
+ * @return true         El canal quedó corriendo
+ * @return false        El canal quedó detenido
+ */
+bool CronometroAlternarEn(uint8_t canal, int64_t instante_us);
+
+/**
+ * @brief Función que pone en cero el tiempo acumulado y la cantidad de vueltas de un canal
+ *
+ * @param  canal  Número de canal, entre 0 y @ref CRONOMETRO_CANALES - 1
+ */
+void CronometroReiniciar(uint8_t canal);
+
+/**
+ * @brief Función que informa si un canal está corriendo
+ *
+ * @param  canal  Número de canal, entre 0 y @ref CRONOMETRO_CANALES - 1
+ * @return true   El canal está corriendo
+ * @return false  El canal está detenido
+ */
+bool CronometroCorriendo(uint8_t canal);
+
+/**
+ * @brief Función que devuelve los canales que están corriendo
+ *
+ * @return uint32_t  Máscara con el bit n en uno si el canal n está corriendo
+ */
+uint32_t CronometroCanalesCorriendo(void);
+
+/**
+ * @brief Función que devuelve el tiempo medido por un canal
+ *
+ * @param  canal     Número de canal, entre 0 y @ref CRONOMETRO_CANALES - 1
+ * @return uint64_t  Tiempo transcurrido en microsegundos
+ */
+uint64_t CronometroTranscurrido(uint8_t canal);
+
+/**
+ * @brief Función que devuelve el tiempo que medía un canal en un instante ya pasado
+ *
+ * @param  canal        Número de canal, entre 0 y @ref CRONOMETRO_CANALES - 1
+ * @param  instante_us  Instante medido con el reloj de alta resolución, no anterior al último arranque del canal
+ * @return uint64_t     Tiempo transcurrido en microsegundos hasta ese instante
+ */
+uint64_t CronometroTranscurridoEn(uint8_t canal, int64_t instante_us);
+
+/**
+ * @brief Función que devuelve el tiempo medido por todos los canales en el mismo instante
+ *
+ * @param  transcurridos  Arreglo donde se devuelve el tiempo de cada canal en microsegundos
+ */
+void CronometroTranscurridos(uint64_t transcurridos[CRONOMETRO_CANALES]);
+
+/**
+ * @brief Función que incrementa la cantidad de vueltas registradas en un canal
+ *
+ * @param  canal     Número de canal, entre 0 y @ref CRONOMETRO_CANALES - 1
+ * @return uint32_t  Número de la vuelta registrada, comenzando en 1
+ */
+uint32_t CronometroRegistrarVuelta(uint8_t canal);
+
+/**
+ * @brief Función que devuelve la cantidad de vueltas registradas en un canal
+ *
+ * @param  canal     Número de canal, entre 0 y @ref CRONOMETRO_CANALES - 1
+ * @return uint32_t  Cantidad de vueltas registradas desde el último reinicio
+ */
+uint32_t CronometroVueltas(uint8_t canal);
+
+/**
+ * @brief Función que fija la corrección de la deriva del reloj local que se aplica a los tiempos devueltos
+ *
+ * Solo se corrige el tiempo medido con el reloj de alta resolución, no el medido por el RTC durante el sueño profundo.
+ *
+ * @param  ppb  Deriva del reloj local en partes por mil millones, positiva si adelanta respecto de la referencia
+ */
+void CronometroCorregir(int32_t ppb);
+
+/* === End of documentation ======================================================================================== */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CRONOMETRO_H_ */
@@ -25,7 +25,9 @@ SPDX-License-Identifier: MIT
 
 #include "digitos.h"
 #include "ili9341.h"
+#include "perfil.h"
 #include <stddef.h>
+#include <string.h>
 
 /* === Macros definitions ========================================================================================== */
 
@@ -37,6 +39,8 @@ SPDX-License-Identifier: MIT
 #define SEGMENTO_F 0x20 //!< Máscara para el segmento F
 #define SEGMENTO_G 0x40 //!< Máscara para el segmento G
 
+#define SIN_VALOR 0xFF //!< Indica que el digito todavía no se dibujó y no se conoce el estado de sus segmentos
+
 /* === Private data type declarations ============================================================================== */
 
 typedef struct punto_s {
@@ -60,6 +64,7 @@ typedef struct segmentos_s {
 } * segmentos_t;
 
 struct panel_s {
+    ili9341_t pantalla;
     struct punto_s origen;
     uint16_t digitos;
     uint16_t ancho;
@@ -68,7 +73,7 @@ struct panel_s {
     uint16_t apagado;
     uint16_t fondo;
     struct segmentos_s segmentos;
-    uint8_t valores[MAXIMO_DIGITOS];
+    uint8_t valores[MAXIMO_DIGITOS]; //!< Índice en @ref DIGITOS del valor dibujado en cada posición
 };
 
 /* === Private variable declarations =============================================================================== */
@@ -138,7 +143,7 @@ void BorrarDigito(panel_t self, uint8_t digito) {
     area.hasta.x = self->origen.x + (digito + 1) * self->ancho;
     area.hasta.y = self->origen.y + self->alto;
 
-    ILI9341DrawFilledRectangle(area.desde.x, area.desde.y, area.hasta.x, area.hasta.y, self->fondo);
+    ILI9341DrawFilledRectangle(self->pantalla, area.desde.x, area.desde.y, area.hasta.x, area.hasta.y, self->fondo);
 }
 
 void DibujarSegmento(panel_t self, uint8_t digito, area_t segmento, uint16_t color) {
@@ -149,15 +154,16 @@ void DibujarSegmento(panel_t self, uint8_t digito, area_t segmento, uint16_t col
     area.hasta.x = self->origen.x + digito * self->ancho + segmento->hasta.x;
     area.hasta.y = self->origen.y + segmento->hasta.y;
 
-    ILI9341DrawFilledRectangle(area.desde.x, area.desde.y, area.hasta.x, area.hasta.y, color);
+    ILI9341DrawFilledRectangle(self->pantalla, area.desde.x, area.desde.y, area.hasta.x, area.hasta.y, color);
 }
 
 /* === Public function implementation ============================================================================== */
 
-panel_t CrearPanel(uint16_t x, uint16_t y, uint16_t digitos, uint16_t alto, uint16_t ancho, uint16_t encendido,
-                   uint16_t apagado, uint16_t fondo) {
+panel_t CrearPanel(ili9341_t pantalla, uint16_t x, uint16_t y, uint16_t digitos, uint16_t alto, uint16_t ancho,
+                   uint16_t encendido, uint16_t apagado, uint16_t fondo) {
     panel_t self = CrearInstancia();
     if (self) {
+        self->pantalla = pantalla;
         self->origen.x = x;
         self->origen.y = y;
         self->alto = alto;
@@ -176,33 +182,88 @@ panel_t CrearPanel(uint16_t x, uint16_t y, uint16_t digitos, uint16_t alto, uint
         self->fondo = fondo;
 
         CalcularGeometria(self);
-    }
 
-    for (int i = 0; i < self->digitos; i++) {
-        DibujarDigito(self, i, 0xFF);
+        for (int i = 0; i < self->digitos; i++) {
+            self->valores[i] = SIN_VALOR;
+            DibujarDigito(self, i, 0xFF);
+        }
     }
     return self;
 }
 
 void DibujarDigito(panel_t self, uint8_t posicion, uint8_t valor) {
+    PERFIL_INICIO();
+
     if (posicion < self->digitos) {
         uint8_t segmentos;
+        uint8_t cambios;
+
+        if (valor >= sizeof(DIGITOS)) {
+            valor = sizeof(DIGITOS) - 1;
+        }
+        segmentos = DIGITOS[valor];
 
+        /* Solo se dibujan los segmentos que cambian, salvo la primera vez que se dibuja el digito */
+        if (self->valores[posicion] == SIN_VALOR) {
+            BorrarDigito(self, posicion);
+            cambios = 0x7F;
+        } else {
+            cambios = segmentos ^ DIGITOS[self->valores[posicion]];
+        }
         self->valores[posicion] = valor;
-        if (valor > sizeof(DIGITOS)) {
-            self->valores[posicion] = sizeof(DIGITOS);
+
+        if (cambios & SEGMENTO_A) {
+            DibujarSegmento(self, posicion, &(self->segmentos.a),
+                            segmentos & SEGMENTO_A ? self->encendido : self->apagado);
+        }
+        if (cambios & SEGMENTO_B) {
+            DibujarSegmento(self, posicion, &(self->segmentos.b),
+                            segmentos & SEGMENTO_B ? self->encendido : self->apagado);
+        }
+        if (cambios & SEGMENTO_C) {
+            DibujarSegmento(self, posicion, &(self->segmentos.c),
+                            segmentos & SEGMENTO_C ? self->encendido : self->apagado);
+        }
+        if (cambios & SEGMENTO_D) {
+            DibujarSegmento(self, posicion, &(self->segmentos.d),
+                            segmentos & SEGMENTO_D ? self->encendido : self->apagado);
         }
-        segmentos = DIGITOS[self->valores[posicion]];
-
-        BorrarDigito(self, posicion);
-        DibujarSegmento(self, posicion, &(self->segmentos.a), segmentos & SEGMENTO_A ? self->encendido : self->apagado);
-        DibujarSegmento(self, posicion, &(self->segmentos.b), segmentos & SEGMENTO_B ? self->encendido : self->apagado);
-        DibujarSegmento(self, posicion, &(self->segmentos.c), segmentos & SEGMENTO_C ? self->encendido : self->apagado);
-        DibujarSegmento(self, posicion, &(self->segmentos.d), segmentos & SEGMENTO_D ? self->encendido : self->apagado);
-        DibujarSegmento(self, posicion, &(self->segmentos.e), segmentos & SEGMENTO_E ? self->encendido : self->apagado);
-        DibujarSegmento(self, posicion, &(self->segmentos.f), segmentos & SEGMENTO_F ? self->encendido : self->apagado);
-        DibujarSegmento(self, posicion, &(self->segmentos.g), segmentos & SEGMENTO_G ? self->encendido : self->apagado);
+        if (cambios & SEGMENTO_E) {
+            DibujarSegmento(self, posicion, &(self->segmentos.e),
+                            segmentos & SEGMENTO_E ? self->encendido : self->apagado);
+        }
+        if (cambios & SEGMENTO_F) {
+            DibujarSegmento(self, posicion, &(self->segmentos.f),
+                            segmentos & SEGMENTO_F ? self->encendido : self->apagado);
+        }
+        if (cambios & SEGMENTO_G) {
+            DibujarSegmento(self, posicion, &(self->segmentos.g),
+                            segmentos & SEGMENTO_G ? self->encendido : self->apagado);
+        }
+    }
+    PERFIL_FIN(PERFIL_DIGITO);
+}
+
+uint8_t ContarSegmentos(panel_t self, uint8_t posicion, uint8_t valor) {
+    if (posicion >= self->digitos) {
+        return 0;
     }
+    if (valor >= sizeof(DIGITOS)) {
+        valor = sizeof(DIGITOS) - 1;
+    }
+    if (self->valores[posicion] == SIN_VALOR) {
+        return 7;
+    }
+    return __builtin_popcount(DIGITOS[valor] ^ DIGITOS[self->valores[posicion]]);
+}
+
+void InvalidarPanel(panel_t self) {
+    memset(self->valores, SIN_VALOR, sizeof(self->valores));
+}
+
+void MedirPanel(panel_t self, uint16_t * ancho, uint16_t * alto) {
+    *ancho = self->digitos * self->ancho;
+    *alto = self->alto;
 }
 
 /* === End of documentation ======================================================================================== */
@@ -27,6 +27,7 @@ SPDX-License-Identifier: MIT
 /* === Headers files inclusions ==================================================================================== */
 
 #include <stdint.h>
+#include "ili9341.h"
 
 /* === Cabecera C++ ================================================================================================ */
 
@@ -58,6 +59,7 @@ typedef struct panel_s * panel_t;
 /**
  * @brief Función que crea un panel de n digitos de 7 segmentos en una pantalla TFT
  *
+ * @param  pantalla  Pantalla en la que se dibuja el panel
  * @param  x         Posición horizontal de la esquina superior derecha del panel
  * @param  y         Posición vertical de la esquina superior derecha del panel
  * @param  digitos   Cantidad de digitos que se pueden mostrar en el panel
@@ -68,18 +70,52 @@ typedef struct panel_s * panel_t;
  * @param  fondo     Color de fondo del panel
  * @return panel_t   Puntero al panel creado
  */
-panel_t CrearPanel(uint16_t x, uint16_t y, uint16_t digitos, uint16_t alto, uint16_t ancho, uint16_t encendido,
-                   uint16_t apagado, uint16_t fondo);
+panel_t CrearPanel(ili9341_t pantalla, uint16_t x, uint16_t y, uint16_t digitos, uint16_t alto, uint16_t ancho,
+                   uint16_t encendido, uint16_t apagado, uint16_t fondo);
 
 /**
  * @brief Función para actualizar el valor de un digito en un panel
  *
+ * Solo se dibujan los segmentos que cambian respecto del valor mostrado, por lo que el costo depende de la cantidad
+ * de segmentos que se encienden o apagan y no del tamaño del digito.
+ *
  * @param self       Puntero al panel creado con la funcion @ref CrearPanel
  * @param posicion   Posición del digito que se desea actualizar
  * @param valor      Valor que se desea mostrar en el digito
  */
 void DibujarDigito(panel_t self, uint8_t posicion, uint8_t valor);
 
+/**
+ * @brief Función que calcula cuántos segmentos dibujaría @ref DibujarDigito con un valor, sin dibujarlos
+ *
+ * Permite estimar el tiempo de dibujo de un valor antes de enviarlo a la pantalla.
+ *
+ * @param self       Puntero al panel creado con la funcion @ref CrearPanel
+ * @param posicion   Posición del digito
+ * @param valor      Valor que se desea mostrar en el digito
+ * @return uint8_t   Cantidad de segmentos que cambian, entre 0 y 7
+ */
+uint8_t ContarSegmentos(panel_t self, uint8_t posicion, uint8_t valor);
+
+/**
+ * @brief Función que olvida los valores mostrados en un panel
+ *
+ * Se usa cuando otro dibujo tapó el panel: el próximo @ref DibujarDigito de cada posición borra el digito y dibuja
+ * todos sus segmentos.
+ *
+ * @param self       Puntero al panel creado con la funcion @ref CrearPanel
+ */
+void InvalidarPanel(panel_t self);
+
+/**
+ * @brief Función que obtiene el tamaño que ocupa un panel en la pantalla
+ *
+ * @param self       Puntero al panel creado con la funcion @ref CrearPanel
+ * @param ancho      Ancho en pixeles de todos los digitos del panel
+ * @param alto       Alto en pixeles del panel
+ */
+void MedirPanel(panel_t self, uint16_t * ancho, uint16_t * alto);
+
 /* === End of documentation ======================================================================================== */
 
 #ifdef __cplusplus
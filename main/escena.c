@@ -0,0 +1,531 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+/** @file escena.c
+ ** @brief Definiciones de la capa de elementos de interfaz que se redibujan solos cuando cambian
+ **
+ ** Los elementos se guardan en un vector en el orden de dibujo y las áreas dañadas en otro del mismo tamaño. Las
+ ** áreas son rectángulos con sus bordes incluidos, igual que las ventanas de la pantalla.
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include "escena.h"
+#include "esp_timer.h"
+#include <stdio.h>
+#include <string.h>
+
+/* === Macros definitions ========================================================================================== */
+
+#define DECIMA_US 100000 //!< Microsegundos de una décima, unidad de la duración de las vueltas
+
+/* === Private data type declarations ============================================================================== */
+
+//! @brief Clases de elementos
+typedef enum {
+    ELEMENTO_DIGITOS,
+    ELEMENTO_SEPARADOR,
+    ELEMENTO_TEXTO,
+    ELEMENTO_VUELTAS,
+    ELEMENTO_IMAGEN,
+} clase_t;
+
+//! @brief Rectángulo de la pantalla con sus bordes incluidos
+typedef struct {
+    uint16_t x0;
+    uint16_t y0;
+    uint16_t x1;
+    uint16_t y1;
+} area_t;
+
+//! @brief Estado de un elemento
+struct elemento_s {
+    escena_t escena;  //!< Escena a la que pertenece el elemento
+    clase_t clase;    //!< Clase del elemento, indica el miembro válido de la unión
+    area_t area;      //!< Área que ocupa el elemento en la pantalla
+    bool visible;     //!< El elemento se debe mostrar
+    bool en_pantalla; //!< El elemento está dibujado, al ocultarlo hay que borrarlo
+    bool repintar;    //!< Hay que dibujar el elemento completo
+    bool cambiado;    //!< Cambió el estado desde el último dibujo
+    uint16_t color;   //!< Color del separador, el texto o la lista de vueltas
+    union {
+        struct {
+            panel_t panel;                   //!< Panel que dibuja los digitos
+            uint8_t cantidad;                //!< Cantidad de digitos del panel
+            uint8_t valores[MAXIMO_DIGITOS]; //!< Valores a mostrar
+        } digitos;
+        struct {
+            uint16_t radio; //!< Radio del separador
+        } separador;
+        struct {
+            Font_t * fuente;                         //!< Fuente de los caracteres
+            uint8_t columnas;                        //!< Caracteres que ocupa el texto
+            char contenido[ESCENA_TEXTO_MAXIMO + 1]; //!< Texto a mostrar
+        } texto;
+        struct {
+            Font_t * fuente;    //!< Fuente de los caracteres
+            uint8_t columnas;   //!< Caracteres de cada fila
+            uint8_t filas;      //!< Cantidad de vueltas que se muestran
+            vueltas_t registro; //!< Registro del que se leen las duraciones
+            uint32_t numero;    //!< Número de la última vuelta
+        } vueltas;
+        struct {
+            const ili9341_sprite_t * imagen; //!< Imagen indexada
+            uint16_t paleta[4];              //!< Colores de los índices
+        } imagen;
+    };
+};
+
+//! @brief Estado de una escena
+struct escena_s {
+    ili9341_t pantalla;                            //!< Pantalla en la que se dibuja
+    uint16_t fondo;                                //!< Color con el que se borran las áreas dañadas
+    uint8_t cantidad;                              //!< Cantidad de elementos agregados
+    uint8_t danadas;                               //!< Cantidad de áreas dañadas pendientes
+    area_t areas[ESCENA_ELEMENTOS];                //!< Áreas dañadas pendientes, sin pares que convenga unir
+    struct elemento_s elementos[ESCENA_ELEMENTOS]; //!< Elementos en el orden de dibujo
+};
+
+/* === Private variable declarations =============================================================================== */
+
+/* === Private function declarations =============================================================================== */
+
+/**
+ * @brief Función que toma un elemento libre de una escena
+ *
+ * @param  self        Puntero a la escena
+ * @param  clase       Clase del elemento
+ * @param  x0          Columna inicial del área del elemento
+ * @param  y0          Fila inicial del área del elemento
+ * @param  x1          Columna final del área del elemento, inclusive
+ * @param  y1          Fila final del área del elemento, inclusive
+ * @return elemento_t  Puntero al elemento, visible y pendiente de dibujar, o NULL si no quedan elementos
+ */
+static elemento_t AgregarElemento(escena_t self, clase_t clase, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1);
+
+/**
+ * @brief Función que indica si dos áreas tienen algún pixel en común
+ *
+ * @param  a     Primera área
+ * @param  b     Segunda área
+ * @return true  Las áreas se superponen
+ */
+static bool Superpuestas(const area_t * a, const area_t * b);
+
+/**
+ * @brief Función que calcula la cantidad de pixeles de un área
+ *
+ * @param  area      Área a medir
+ * @return uint32_t  Cantidad de pixeles
+ */
+static uint32_t Superficie(const area_t * area);
+
+/**
+ * @brief Función que agrega un área dañada, combinándola con las pendientes si su unión no tiene más pixeles que
+ * borrarlas por separado
+ *
+ * @param  self  Puntero a la escena
+ * @param  area  Área dañada
+ */
+static void AgregarArea(escena_t self, area_t area);
+
+/**
+ * @brief Función que dibuja los digitos de un panel que cambiaron, mientras no se llegue al límite de tiempo
+ *
+ * @param  self       Puntero al elemento
+ * @param  limite     Instante a partir del cual no se empiezan a dibujar más digitos
+ * @param  resultado  Resultado del cuadro, se acumulan los segmentos dibujados
+ * @return true       Se dibujó al menos un digito
+ */
+static bool DibujarDigitos(elemento_t self, int64_t limite, escena_dibujo_t * resultado);
+
+/**
+ * @brief Función que escribe el texto de una fila de una lista de vueltas
+ *
+ * @param  self   Puntero al elemento
+ * @param  fila   Fila de la lista, cero para la última vuelta
+ * @param  texto  Texto de la fila, de @ref ESCENA_TEXTO_MAXIMO caracteres como máximo
+ */
+static void FormatearVuelta(elemento_t self, uint8_t fila, char * texto);
+
+/**
+ * @brief Función que dibuja completo un elemento que no es un panel de digitos
+ *
+ * @param  self  Puntero al elemento
+ */
+static void DibujarElemento(elemento_t self);
+
+/* === Public variable definitions ================================================================================= */
+
+/* === Private variable definitions ================================================================================ */
+
+//! @brief Escenas disponibles
+static struct escena_s instancias[ESCENA_MAXIMO];
+
+//! @brief Cantidad de escenas creadas
+static uint8_t creadas;
+
+/* === Private function definitions ================================================================================ */
+
+static elemento_t AgregarElemento(escena_t self, clase_t clase, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
+    if (self->cantidad >= ESCENA_ELEMENTOS) {
+        return NULL;
+    }
+    elemento_t elemento = &self->elementos[self->cantidad++];
+    memset(elemento, 0, sizeof(struct elemento_s));
+    elemento->escena = self;
+    elemento->clase = clase;
+    elemento->area = (area_t){x0, y0, x1, y1};
+    elemento->visible = true;
+    elemento->repintar = true;
+    return elemento;
+}
+
+static bool Superpuestas(const area_t * a, const area_t * b) {
+    return a->x0 <= b->x1 && b->x0 <= a->x1 && a->y0 <= b->y1 && b->y0 <= a->y1;
+}
+
+static uint32_t Superficie(const area_t * area) {
+    return (uint32_t)(area->x1 - area->x0 + 1) * (area->y1 - area->y0 + 1);
+}
+
+static void AgregarArea(escena_t self, area_t area) {
+    uint8_t indice = 0;
+
+    /* La unión se vuelve a comparar con todas las pendientes, porque al crecer puede convenir unirla con otras */
+    while (indice < self->danadas) {
+        area_t otra = self->areas[indice];
+        area_t union_areas = {
+            (area.x0 < otra.x0) ? area.x0 : otra.x0,
+            (area.y0 < otra.y0) ? area.y0 : otra.y0,
+            (area.x1 > otra.x1) ? area.x1 : otra.x1,
+            (area.y1 > otra.y1) ? area.y1 : otra.y1,
+        };
+        if (Superficie(&union_areas) <= Superficie(&area) + Superficie(&otra)) {
+            area = union_areas;
+            self->areas[indice] = self->areas[--self->danadas];
+            indice = 0;
+        } else {
+            indice++;
+        }
+    }
+    if (self->danadas < ESCENA_ELEMENTOS) {
+        self->areas[self->danadas++] = area;
+    } else {
+        /* Sin lugar se agranda la primera, se borran pixeles de más pero no se pierde ningún daño */
+        area_t * primera = &self->areas[0];
+        primera->x0 = (area.x0 < primera->x0) ? area.x0 : primera->x0;
+        primera->y0 = (area.y0 < primera->y0) ? area.y0 : primera->y0;
+        primera->x1 = (area.x1 > primera->x1) ? area.x1 : primera->x1;
+        primera->y1 = (area.y1 > primera->y1) ? area.y1 : primera->y1;
+    }
+}
+
+static bool DibujarDigitos(elemento_t self, int64_t limite, escena_dibujo_t * resultado) {
+    panel_t panel = self->digitos.panel;
+    bool dibujado = false;
+
+    /* El área se borró o la tapó otro elemento, el panel ya no muestra lo que recuerda */
+    if (self->repintar) {
+        InvalidarPanel(panel);
+        self->repintar = false;
+    }
+    for (uint8_t posicion = 0; posicion < self->digitos.cantidad; posicion++) {
+        uint8_t valor = self->digitos.valores[posicion];
+        uint8_t segmentos = ContarSegmentos(panel, posicion, valor);
+        if (segmentos == 0) {
+            continue;
+        }
+        int64_t inicio = esp_timer_get_time();
+        if (inicio > limite) {
+            resultado->completo = false; // Los digitos que faltan se dibujan en el próximo cuadro
+            break;
+        }
+        DibujarDigito(panel, posicion, valor);
+        int64_t fin = esp_timer_get_time();
+        resultado->segmentos += segmentos;
+        resultado->segmentos_us += fin - inicio;
+        resultado->fin_digitos = fin;
+        if (resultado->primer_digito == 0) {
+            resultado->primer_digito = fin;
+        }
+        dibujado = true;
+    }
+    return dibujado;
+}
+
+static void FormatearVuelta(elemento_t self, uint8_t fila, char * texto) {
+    vueltas_t registro = self->vueltas.registro;
+    uint32_t numero = self->vueltas.numero;
+    uint32_t cantidad = (registro != NULL) ? VueltasCantidad(registro) : 0;
+    uint64_t parcial_us, anterior_us;
+
+    if (fila >= numero) {
+        texto[0] = '\0';
+    } else if (fila < cantidad && (cantidad - 1 - fila > 0 || numero == cantidad) &&
+               VueltasLeer(registro, cantidad - 1 - fila, &parcial_us)) {
+        /* La más antigua del registro solo es la primera vuelta si no se perdió ninguna, sino falta su parcial */
+        uint64_t vuelta_us = parcial_us;
+        if (cantidad - 1 - fila > 0 && VueltasLeer(registro, cantidad - 2 - fila, &anterior_us)) {
+            vuelta_us = parcial_us - anterior_us;
+        }
+        uint32_t decimas = vuelta_us / DECIMA_US;
+        snprintf(texto, ESCENA_TEXTO_MAXIMO + 1, "Vuelta %-4lu %02lu:%02lu.%lu", (unsigned long)(numero - fila),
+                 (unsigned long)((decimas / 600) % 100), (unsigned long)((decimas / 10) % 60),
+                 (unsigned long)(decimas % 10));
+    } else {
+        /* La vuelta ya no está en el registro, por ejemplo después de despertar de un sueño profundo */
+        snprintf(texto, ESCENA_TEXTO_MAXIMO + 1, "Vuelta %-4lu", (unsigned long)(numero - fila));
+    }
+}
+
+static void DibujarElemento(elemento_t self) {
+    ili9341_t pantalla = self->escena->pantalla;
+    uint16_t fondo = self->escena->fondo;
+    char texto[ESCENA_TEXTO_MAXIMO + 1];
+    char fila[ESCENA_TEXTO_MAXIMO + 1];
+
+    switch (self->clase) {
+    case ELEMENTO_SEPARADOR:
+        ILI9341DrawFilledCircle(pantalla, self->area.x0 + self->separador.radio, self->area.y0 + self->separador.radio,
+                                self->separador.radio, self->color);
+        break;
+
+    case ELEMENTO_TEXTO:
+        /* Se completa con espacios para borrar lo que quede de un texto más largo */
+        snprintf(fila, sizeof(fila), "%-*s", self->texto.columnas, self->texto.contenido);
+        ILI9341DrawString(pantalla, self->area.x0, self->area.y0, fila, self->texto.fuente, self->color, fondo);
+        break;
+
+    case ELEMENTO_VUELTAS:
+        for (uint8_t indice = 0; indice < self->vueltas.filas; indice++) {
+            FormatearVuelta(self, indice, texto);
+            snprintf(fila, sizeof(fila), "%-*s", self->vueltas.columnas, texto);
+            ILI9341DrawString(pantalla, self->area.x0, self->area.y0 + indice * self->vueltas.fuente->FontHeight, fila,
+                              self->vueltas.fuente, self->color, fondo);
+        }
+        break;
+
+    case ELEMENTO_IMAGEN:
+        ILI9341DrawSprite(pantalla, self->area.x0, self->area.y0, self->imagen.imagen, self->imagen.paleta);
+        break;
+
+    default:
+        break;
+    }
+}
+
+/* === Public function implementation ============================================================================== */
+
+escena_t EscenaCrear(ili9341_t pantalla, uint16_t fondo) {
+    if (creadas >= ESCENA_MAXIMO) {
+        return NULL;
+    }
+    escena_t self = &instancias[creadas++];
+    self->pantalla = pantalla;
+    self->fondo = fondo;
+    return self;
+}
+
+elemento_t EscenaAgregarDigitos(escena_t self, uint16_t x, uint16_t y, uint8_t digitos, uint16_t alto, uint16_t ancho,
+                                uint16_t encendido, uint16_t apagado) {
+    uint16_t ancho_panel, alto_panel;
+
+    if (self->cantidad >= ESCENA_ELEMENTOS) {
+        return NULL;
+    }
+    panel_t panel = CrearPanel(self->pantalla, x, y, digitos, alto, ancho, encendido, apagado, self->fondo);
+    if (panel == NULL) {
+        return NULL;
+    }
+    /* El borde final solo lo toca el borrado de un digito con el fondo, no cuenta para tapar a un panel vecino */
+    MedirPanel(panel, &ancho_panel, &alto_panel);
+    elemento_t elemento = AgregarElemento(self, ELEMENTO_DIGITOS, x, y, x + ancho_panel - 1, y + alto_panel - 1);
+    elemento->digitos.panel = panel;
+    elemento->digitos.cantidad = (digitos > MAXIMO_DIGITOS) ? MAXIMO_DIGITOS : digitos;
+    memset(elemento->digitos.valores, 0xFF, sizeof(elemento->digitos.valores));
+    /* CrearPanel ya dibujó los digitos en blanco */
+    elemento->repintar = false;
+    elemento->en_pantalla = true;
+    return elemento;
+}
+
+elemento_t EscenaAgregarSeparador(escena_t self, uint16_t x, uint16_t y, uint16_t radio, uint16_t color) {
+    elemento_t elemento = AgregarElemento(self, ELEMENTO_SEPARADOR, x - radio, y - radio, x + radio, y + radio);
+    if (elemento != NULL) {
+        elemento->separador.radio = radio;
+        elemento->color = color;
+    }
+    return elemento;
+}
+
+elemento_t EscenaAgregarTexto(escena_t self, uint16_t x, uint16_t y, uint8_t columnas, Font_t * fuente,
+                              uint16_t color) {
+    if (columnas > ESCENA_TEXTO_MAXIMO) {
+        columnas = ESCENA_TEXTO_MAXIMO;
+    }
+    elemento_t elemento = AgregarElemento(self, ELEMENTO_TEXTO, x, y, x + columnas * fuente->FontWidth - 1,
+                                          y + fuente->FontHeight - 1);
+    if (elemento != NULL) {
+        elemento->texto.fuente = fuente;
+        elemento->texto.columnas = columnas;
+        elemento->color = color;
+    }
+    return elemento;
+}
+
+elemento_t EscenaAgregarVueltas(escena_t self, uint16_t x, uint16_t y, uint8_t filas, uint8_t columnas,
+                                Font_t * fuente, uint16_t color) {
+    if (columnas > ESCENA_TEXTO_MAXIMO) {
+        columnas = ESCENA_TEXTO_MAXIMO;
+    }
+    elemento_t elemento = AgregarElemento(self, ELEMENTO_VUELTAS, x, y, x + columnas * fuente->FontWidth - 1,
+                                          y + filas * fuente->FontHeight - 1);
+    if (elemento != NULL) {
+        elemento->vueltas.fuente = fuente;
+        elemento->vueltas.columnas = columnas;
+        elemento->vueltas.filas = filas;
+        elemento->color = color;
+    }
+    return elemento;
+}
+
+elemento_t EscenaAgregarImagen(escena_t self, uint16_t x, uint16_t y, const ili9341_sprite_t * imagen) {
+    elemento_t elemento = AgregarElemento(self, ELEMENTO_IMAGEN, x, y, x + imagen->width - 1, y + imagen->height - 1);
+    if (elemento != NULL) {
+        elemento->imagen.imagen = imagen;
+    }
+    return elemento;
+}
+
+void EscenaInvalidarArea(escena_t self, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
+    AgregarArea(self, (area_t){x0, y0, x1, y1});
+}
+
+void EscenaDibujar(escena_t self, int64_t limite, escena_dibujo_t * resultado) {
+    area_t dibujadas[ESCENA_ELEMENTOS];
+    uint8_t cantidad_dibujadas = 0;
+
+    memset(resultado, 0, sizeof(escena_dibujo_t));
+    resultado->completo = true;
+
+    /* Las áreas dañadas se borran con una sola ventana cada una, y se redibujan los elementos que quedan encima */
+    for (uint8_t indice = 0; indice < self->danadas; indice++) {
+        area_t * area = &self->areas[indice];
+        ILI9341DrawFilledRectangle(self->pantalla, area->x0, area->y0, area->x1, area->y1, self->fondo);
+        for (uint8_t orden = 0; orden < self->cantidad; orden++) {
+            elemento_t elemento = &self->elementos[orden];
+            if (elemento->visible && Superpuestas(&elemento->area, area)) {
+                elemento->repintar = true;
+            }
+        }
+    }
+    self->danadas = 0;
+
+    for (uint8_t orden = 0; orden < self->cantidad; orden++) {
+        elemento_t elemento = &self->elementos[orden];
+        bool dibujado = false;
+
+        if (!elemento->visible) {
+            continue;
+        }
+        /* Un elemento superpuesto a otro que se acaba de dibujar quedó tapado y se dibuja completo encima */
+        for (uint8_t indice = 0; indice < cantidad_dibujadas; indice++) {
+            if (Superpuestas(&elemento->area, &dibujadas[indice])) {
+                elemento->repintar = true;
+            }
+        }
+        if (elemento->clase == ELEMENTO_DIGITOS) {
+            dibujado = DibujarDigitos(elemento, limite, resultado);
+        } else if (elemento->repintar || elemento->cambiado) {
+            DibujarElemento(elemento);
+            elemento->repintar = false;
+            elemento->cambiado = false;
+            dibujado = true;
+        }
+        if (dibujado) {
+            elemento->en_pantalla = true;
+            dibujadas[cantidad_dibujadas++] = elemento->area;
+        }
+    }
+}
+
+void ElementoVisible(elemento_t self, bool visible) {
+    if (self->visible == visible) {
+        return;
+    }
+    self->visible = visible;
+    if (visible) {
+        self->repintar = true;
+    } else if (self->en_pantalla) {
+        AgregarArea(self->escena, self->area);
+        self->en_pantalla = false;
+    }
+}
+
+void ElementoColor(elemento_t self, uint16_t color) {
+    if (self->clase != ELEMENTO_DIGITOS && self->color != color) {
+        self->color = color;
+        self->cambiado = true;
+    }
+}
+
+void ElementoDigitos(elemento_t self, const uint8_t * valores) {
+    memcpy(self->digitos.valores, valores, self->digitos.cantidad);
+}
+
+uint32_t ElementoSegmentos(elemento_t self, const uint8_t * valores) {
+    uint32_t segmentos = 0;
+
+    if (!self->visible) {
+        return 0;
+    }
+    for (uint8_t posicion = 0; posicion < self->digitos.cantidad; posicion++) {
+        /* Al repintar el panel se dibujan todos los segmentos de todos los digitos */
+        segmentos += self->repintar ? 7 : ContarSegmentos(self->digitos.panel, posicion, valores[posicion]);
+    }
+    return segmentos;
+}
+
+void ElementoTexto(elemento_t self, const char * texto) {
+    char contenido[ESCENA_TEXTO_MAXIMO + 1];
+
+    snprintf(contenido, self->texto.columnas + 1, "%s", texto);
+    if (strcmp(contenido, self->texto.contenido) != 0) {
+        strcpy(self->texto.contenido, contenido);
+        self->cambiado = true;
+    }
+}
+
+void ElementoVueltas(elemento_t self, vueltas_t registro, uint32_t numero) {
+    if (self->vueltas.registro != registro || self->vueltas.numero != numero) {
+        self->vueltas.registro = registro;
+        self->vueltas.numero = numero;
+        self->cambiado = true;
+    }
+}
+
+void ElementoPaleta(elemento_t self, const uint16_t paleta[4]) {
+    if (memcmp(self->imagen.paleta, paleta, sizeof(self->imagen.paleta)) != 0) {
+        memcpy(self->imagen.paleta, paleta, sizeof(self->imagen.paleta));
+        self->cambiado = true;
+    }
+}
+
+/* === End of documentation ======================================================================================== */
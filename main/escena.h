@@ -0,0 +1,267 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+#ifndef ESCENA_H_
+#define ESCENA_H_
+
+/** @file escena.h
+ ** @brief Declaraciones de la capa de elementos de interfaz que se redibujan solos cuando cambian
+ **
+ ** Una escena es una lista de elementos (paneles de digitos, separadores, textos, listas de vueltas e imágenes
+ ** indexadas) sobre una pantalla. Cada elemento guarda el estado que muestra: el programa solo le informa el valor
+ ** actual y el elemento decide si cambió. En cada cuadro @ref EscenaDibujar redibuja lo que cambió:
+ **
+ ** - Ocultar un elemento deja su área dañada. Las áreas dañadas se combinan cuando borrar su unión no cuesta más
+ **   pixeles que borrarlas por separado, se borran con el color de fondo y se redibujan los elementos que las tocan.
+ ** - Los elementos se dibujan en el orden en que se agregaron, y los que se superponen a uno redibujado se redibujan
+ **   también para quedar por encima.
+ ** - Los paneles de digitos dibujan solo los segmentos que cambian, y dejan de dibujar al llegar al límite de tiempo
+ **   del cuadro. Los digitos que faltan se dibujan en el cuadro siguiente.
+ **
+ ** Las funciones no son reentrantes, una escena se debe usar desde una sola tarea o con la pantalla protegida.
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "digitos.h"
+#include "fonts.h"
+#include "ili9341.h"
+#include "vueltas.h"
+
+/* === Cabecera C++ ================================================================================================ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* === Public macros definitions =================================================================================== */
+
+//! @brief Cantidad máxima de escenas que se pueden crear
+#ifndef ESCENA_MAXIMO
+#define ESCENA_MAXIMO 2
+#endif
+
+//! @brief Cantidad máxima de elementos de una escena
+#ifndef ESCENA_ELEMENTOS
+#define ESCENA_ELEMENTOS 16
+#endif
+
+//! @brief Cantidad máxima de caracteres de un texto
+#ifndef ESCENA_TEXTO_MAXIMO
+#define ESCENA_TEXTO_MAXIMO 32
+#endif
+
+/* === Public data type declarations =============================================================================== */
+
+//! @brief Tipo de dato para referenciar a una escena
+typedef struct escena_s * escena_t;
+
+//! @brief Tipo de dato para referenciar a un elemento de una escena
+typedef struct elemento_s * elemento_t;
+
+//! @brief Resultado del dibujo de un cuadro
+typedef struct {
+    bool completo;         //!< Falso si quedaron digitos sin dibujar al llegar al límite de tiempo
+    uint32_t segmentos;    //!< Cantidad de segmentos de digitos dibujados
+    uint32_t segmentos_us; //!< Tiempo empleado en dibujar esos segmentos, en microsegundos
+    int64_t primer_digito; //!< Instante en que terminó de dibujarse el primer digito, cero si no cambió ninguno
+    int64_t fin_digitos;   //!< Instante en que terminó de dibujarse el último digito, cero si no cambió ninguno
+} escena_dibujo_t;
+
+/* === Public variable declarations ================================================================================ */
+
+/* === Public function declarations ================================================================================ */
+
+/**
+ * @brief Función que crea una escena vacía
+ *
+ * @param  pantalla  Pantalla en la que se dibujan los elementos
+ * @param  fondo     Color de fondo de la escena, con el que se borran las áreas dañadas
+ * @return escena_t  Puntero a la escena creada o NULL si no quedan escenas disponibles
+ */
+escena_t EscenaCrear(ili9341_t pantalla, uint16_t fondo);
+
+/**
+ * @brief Función que agrega un panel de digitos de 7 segmentos
+ *
+ * El panel se crea con @ref CrearPanel y queda dibujado en blanco, sus digitos se dibujan al asignarles un valor
+ * con @ref ElementoDigitos.
+ *
+ * @param  self        Puntero a la escena creada con @ref EscenaCrear
+ * @param  x           Posición horizontal de la esquina superior izquierda del panel
+ * @param  y           Posición vertical de la esquina superior izquierda del panel
+ * @param  digitos     Cantidad de digitos del panel
+ * @param  alto        Alto en pixeles de los digitos
+ * @param  ancho       Ancho en pixeles de los digitos
+ * @param  encendido   Color de los segmentos encendidos
+ * @param  apagado     Color de los segmentos apagados
+ * @return elemento_t  Puntero al elemento creado o NULL si no quedan elementos o paneles disponibles
+ */
+elemento_t EscenaAgregarDigitos(escena_t self, uint16_t x, uint16_t y, uint8_t digitos, uint16_t alto, uint16_t ancho,
+                                uint16_t encendido, uint16_t apagado);
+
+/**
+ * @brief Función que agrega un separador circular entre paneles de digitos
+ *
+ * @param  self        Puntero a la escena creada con @ref EscenaCrear
+ * @param  x           Posición horizontal del centro
+ * @param  y           Posición vertical del centro
+ * @param  radio       Radio en pixeles
+ * @param  color       Color del separador
+ * @return elemento_t  Puntero al elemento creado o NULL si no quedan elementos disponibles
+ */
+elemento_t EscenaAgregarSeparador(escena_t self, uint16_t x, uint16_t y, uint16_t radio, uint16_t color);
+
+/**
+ * @brief Función que agrega una línea de texto
+ *
+ * El texto ocupa siempre la cantidad de columnas indicada, los caracteres que sobran se borran con el fondo.
+ *
+ * @param  self        Puntero a la escena creada con @ref EscenaCrear
+ * @param  x           Posición horizontal de la esquina superior izquierda
+ * @param  y           Posición vertical de la esquina superior izquierda
+ * @param  columnas    Cantidad de caracteres que ocupa el texto, como máximo @ref ESCENA_TEXTO_MAXIMO
+ * @param  fuente      Fuente de los caracteres
+ * @param  color       Color de los caracteres
+ * @return elemento_t  Puntero al elemento creado o NULL si no quedan elementos disponibles
+ */
+elemento_t EscenaAgregarTexto(escena_t self, uint16_t x, uint16_t y, uint8_t columnas, Font_t * fuente,
+                              uint16_t color);
+
+/**
+ * @brief Función que agrega una lista con las últimas vueltas de un registro
+ *
+ * Cada fila muestra el número de una vuelta y su duración en décimas, la primera fila es la última vuelta. Las
+ * vueltas que ya no están en el registro se muestran solo con su número.
+ *
+ * @param  self        Puntero a la escena creada con @ref EscenaCrear
+ * @param  x           Posición horizontal de la esquina superior izquierda
+ * @param  y           Posición vertical de la esquina superior izquierda
+ * @param  filas       Cantidad de vueltas que se muestran
+ * @param  columnas    Cantidad de caracteres de cada fila, como máximo @ref ESCENA_TEXTO_MAXIMO
+ * @param  fuente      Fuente de los caracteres
+ * @param  color       Color de los caracteres
+ * @return elemento_t  Puntero al elemento creado o NULL si no quedan elementos disponibles
+ */
+elemento_t EscenaAgregarVueltas(escena_t self, uint16_t x, uint16_t y, uint8_t filas, uint8_t columnas,
+                                Font_t * fuente, uint16_t color);
+
+/**
+ * @brief Función que agrega una imagen indexada que se dibuja con una paleta propia
+ *
+ * @param  self        Puntero a la escena creada con @ref EscenaCrear
+ * @param  x           Posición horizontal de la esquina superior izquierda
+ * @param  y           Posición vertical de la esquina superior izquierda
+ * @param  imagen      Imagen indexada de hasta 2 bits por pixel, debe existir mientras exista la escena
+ * @return elemento_t  Puntero al elemento creado o NULL si no quedan elementos disponibles
+ */
+elemento_t EscenaAgregarImagen(escena_t self, uint16_t x, uint16_t y, const ili9341_sprite_t * imagen);
+
+/**
+ * @brief Función que marca un área de la pantalla como dañada
+ *
+ * Se usa cuando otro código dibujó sobre la pantalla. En el próximo cuadro el área se borra con el fondo y se
+ * redibujan completos los elementos visibles que la tocan.
+ *
+ * @param  self  Puntero a la escena creada con @ref EscenaCrear
+ * @param  x0    Columna inicial del área
+ * @param  y0    Fila inicial del área
+ * @param  x1    Columna final del área, inclusive
+ * @param  y1    Fila final del área, inclusive
+ */
+void EscenaInvalidarArea(escena_t self, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1);
+
+/**
+ * @brief Función que dibuja los cambios de la escena desde el cuadro anterior
+ *
+ * @param  self       Puntero a la escena creada con @ref EscenaCrear
+ * @param  limite     Instante de esp_timer_get_time a partir del cual no se empiezan a dibujar más digitos
+ * @param  resultado  Lo que se dibujó en el cuadro
+ */
+void EscenaDibujar(escena_t self, int64_t limite, escena_dibujo_t * resultado);
+
+/**
+ * @brief Función que muestra u oculta un elemento
+ *
+ * @param  self     Puntero al elemento
+ * @param  visible  Verdadero para mostrar el elemento, falso para borrarlo en el próximo cuadro
+ */
+void ElementoVisible(elemento_t self, bool visible);
+
+/**
+ * @brief Función que cambia el color de un separador, un texto o una lista de vueltas
+ *
+ * @param  self   Puntero al elemento
+ * @param  color  Color nuevo
+ */
+void ElementoColor(elemento_t self, uint16_t color);
+
+/**
+ * @brief Función que asigna los valores de un panel de digitos
+ *
+ * @param  self     Puntero al elemento creado con @ref EscenaAgregarDigitos
+ * @param  valores  Valor de cada digito, del primero al último del panel
+ */
+void ElementoDigitos(elemento_t self, const uint8_t * valores);
+
+/**
+ * @brief Función que calcula cuántos segmentos se dibujarían para mostrar unos valores en un panel de digitos
+ *
+ * Permite estimar el tiempo de dibujo de unos valores antes de asignarlos con @ref ElementoDigitos.
+ *
+ * @param  self      Puntero al elemento creado con @ref EscenaAgregarDigitos
+ * @param  valores   Valor de cada digito, del primero al último del panel
+ * @return uint32_t  Cantidad de segmentos que cambian
+ */
+uint32_t ElementoSegmentos(elemento_t self, const uint8_t * valores);
+
+/**
+ * @brief Función que asigna el contenido de una línea de texto
+ *
+ * @param  self   Puntero al elemento creado con @ref EscenaAgregarTexto
+ * @param  texto  Texto a mostrar, se copia y se recorta a las columnas del elemento
+ */
+void ElementoTexto(elemento_t self, const char * texto);
+
+/**
+ * @brief Función que asigna las vueltas de una lista
+ *
+ * @param  self      Puntero al elemento creado con @ref EscenaAgregarVueltas
+ * @param  registro  Registro del que se leen las duraciones, sin bloqueos
+ * @param  numero    Número de la última vuelta, cero si no hay vueltas
+ */
+void ElementoVueltas(elemento_t self, vueltas_t registro, uint32_t numero);
+
+/**
+ * @brief Función que asigna la paleta de una imagen indexada
+ *
+ * @param  self    Puntero al elemento creado con @ref EscenaAgregarImagen
+ * @param  paleta  Colores de los cuatro índices
+ */
+void ElementoPaleta(elemento_t self, const uint16_t paleta[4]);
+
+/* === End of documentation ======================================================================================== */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ESCENA_H_ */
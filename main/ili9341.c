@@ -26,10 +26,17 @@ SPDX-License-Identifier: MIT
 /* === Headers files inclusions =============================================================== */
 
 #include "ili9341.h"
+#include "perfil.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/semphr.h"
 #include "driver/spi_master.h"
 #include "driver/gpio.h"
+#include "esp_lcd_panel_io.h"
+#include "esp_attr.h"
+#include "esp_heap_caps.h"
+#include "esp_memory_utils.h"
+#include "soc/soc_caps.h"
 #include <string.h>
 
 /* === Macros definitions ====================================================================== */
@@ -43,6 +50,18 @@ SPDX-License-Identifier: MIT
 #define MAX_PIXEL         320 * 240 * 2 /*!< Maximum number of bytes to write on LCD */
 #define MSK_BIT16         0x8000        /*!< 16th bit mask */
 #define MAX_VALUE_SIZE    256           /*!< Maximum length of a data array to \  prevent excessive use of memory */
+#define MAX_TRANSFER      (PARALLEL_LINES * 320 * 2 + 8) /*!< Maximum bytes of a single bus transaction */
+#define BLIT_CHUNK        (MAX_TRANSFER & ~3) /*!< Bytes of a pixel transaction, the largest multiple of a word */
+#define BLIT_QUEUE        6             /*!< Canvas blit transactions queued at a time */
+#ifdef CONFIG_LCD_OVERCLOCK
+#define LCD_CLOCK_HZ      (26 * 1000 * 1000) /*!< Clock out at 26 MHz */
+#else
+#define LCD_CLOCK_HZ      (10 * 1000 * 1000) /*!< Clock out at 10 MHz */
+#endif
+#define I80_CLOCK_HZ      (10 * 1000 * 1000) /*!< Write strobe at 10 MHz, the ILI9341 write cycle is 66 ns minimum */
+#define NO_COMMAND        -1            /*!< Pixels that continue the memory write started before */
+#define RLE_HEADER        5             /*!< Bytes of the encoded picture header, before the palette */
+#define RLE_RUN           0x80          /*!< Packet header flag of a run of the same color */
 #define LEFT              -1            /*!< Horizontal grow direction */
 #define RIGHT             1             /*!< Horizontal grow direction */
 #define DOWN              1             /*!< Vertical grow direction */
@@ -116,6 +135,28 @@ typedef struct {
     uint8_t databytes; // No of data in data; bit 7 = delay after set; 0xFF = end of cmds.
 } lcd_init_cmd_t;
 
+/**
+ * @brief Structure with the state of a display
+ */
+struct ili9341_s {
+    ili9341_config_t config;                  /*!< Bus, pins and clock of the display */
+    esp_lcd_panel_io_handle_t io;             /*!< Panel IO that sends commands and pixels on the bus */
+    SemaphoreHandle_t done;                   /*!< Given once for each pixel transaction finished */
+    ili9341_stats_t stats;                    /*!< Bus traffic counters */
+    orientation_properties_t lcd_orientation; /*!< Current orientation */
+    struct {
+        bool valid;              /*!< False until the first window is set or after the LCD is reconfigured */
+        uint16_t x0, y0, x1, y1; /*!< Last address window sent */
+    } last_window;
+    ili9341_canvas_t * target; /*!< Canvas where the primitives draw, NULL to draw on the LCD */
+    struct {
+        uint16_t x0, y0, x1, y1; /*!< Address window on the canvas */
+        uint16_t x, y;           /*!< Next pixel to write, as the frame memory write pointer */
+    } canvas_window;
+    uint32_t (*bounce)[BLIT_CHUNK / 4]; /*!< Two internal RAM buffers, one is filled while the other is sent */
+    uint16_t lookup[256];               /*!< Sprite palette in bus byte order */
+};
+
 /* === Private variable declarations =========================================================== */
 
 /* === Private function declarations =========================================================== */
@@ -127,25 +168,35 @@ typedef struct {
  */
 void SetChipSelect(uint8_t state);
 
+/**
+ * @brief  		Take a free display, initialize its bus if needed and create its panel IO on the bus
+ * @param[in]  	config: Bus, pins and clock of the display
+ * @retval 		Display prepared to send commands, NULL if there are no free displays or no memory for its buffers
+ */
+ili9341_t panel_io_config(const ili9341_config_t * config);
+
 /**
  * @brief  		Send command and parameters/data to LCD
+ * @param[in]  	self: Display
  * @param[in]  	data: Structure with the command and parameters/data to send
  * @retval 		None
  */
-void WriteLCD(lcd_cmd_t * data);
+void WriteLCD(ili9341_t self, lcd_cmd_t * data);
 
 /**
  * @brief  		Define an area of frame memory where MCU can access
+ * @param[in]  	self: Display
  * @param[in]  	x1: Start column
  * @param[in]  	y1: Start row
  * @param[in]  	x2: End column
  * @param[in]  	y2: End row
  * @retval 		None
  */
-void SetCursorPosition(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1);
+void SetCursorPosition(ili9341_t self, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1);
 
 /**
  * @brief  		Fill an srea of LCD with a determined color
+ * @param[in]  	self: Display
  * @param[in]  	x1: Start column
  * @param[in]  	y1: Start row
  * @param[in]  	x2: End column
@@ -153,14 +204,70 @@ void SetCursorPosition(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1);
  * @param[in]	color: color
  * @retval 		None
  */
-void Fill(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color);
+void Fill(ili9341_t self, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color);
 
-/* === Public variable definitions ============================================================= */
+/**
+ * @brief  		Write pixels on the selected canvas as the LCD does on its frame memory
+ * @param[in]  	self: Display
+ * @param[in]  	data: Pixels in bus byte order
+ * @param[in]  	bytes: Number of bytes to write
+ * @retval 		None
+ */
+void CanvasWrite(ili9341_t self, const uint8_t * data, uint32_t bytes);
+
+/**
+ * @brief  		Send a buffer of pixels with a queued DMA transaction, or write it on the selected canvas
+ * @param[in]  	self: Display
+ * @param[in]  	data: Pixels in bus byte order, it must not change until the transaction is done
+ * @param[in]  	bytes: Number of bytes to send
+ * @param[inout]	in_flight: Number of queued transactions not yet finished
+ * @retval 		None
+ */
+void QueuePixels(ili9341_t self, const uint8_t * data, uint32_t bytes, uint8_t * in_flight);
+
+/**
+ * @brief  		Wait until the oldest queued transaction is finished
+ * @param[in]  	self: Display
+ * @param[inout]	in_flight: Number of queued transactions not yet finished
+ * @retval 		None
+ */
+void WaitPixels(ili9341_t self, uint8_t * in_flight);
+
+/**
+ * @brief  		Copy pixels with word wide accesses when the source is aligned, as flash mapped data is read
+ *				faster a word at a time
+ * @param[out]	destination: Word aligned buffer
+ * @param[in]  	source: Pixels to copy
+ * @param[in]  	bytes: Number of bytes to copy
+ * @retval 		None
+ */
+void CopyWords(uint32_t * destination, const uint8_t * source, uint32_t bytes);
+
+/**
+ * @brief  		Width of the selected target, the canvas or the LCD in its current orientation
+ * @param[in]  	self: Display
+ * @retval 		Width in pixels
+ */
+static inline uint16_t TargetWidth(ili9341_t self);
+
+/**
+ * @brief  		Height of the selected target, the canvas or the LCD in its current orientation
+ * @param[in]  	self: Display
+ * @retval 		Height in pixels
+ */
+static inline uint16_t TargetHeight(ili9341_t self);
 
-static spi_device_handle_t spi;
+/* === Public variable definitions ============================================================= */
 
 /* === Private variable definitions ============================================================ */
 
+static struct ili9341_s instances[ILI9341_MAX_DISPLAYS]; /*!< Displays that can be created */
+static uint8_t created;                                  /*!< Number of displays created */
+static uint32_t buses;                                   /*!< Bit n set if SPI host n is initialized */
+#if SOC_LCD_I80_SUPPORTED
+static esp_lcd_i80_bus_handle_t i80_bus; /*!< Parallel bus, created by the first display that uses it */
+#endif
+
 /**
  * @brief Initial LCD configuration parameters
  */
@@ -221,8 +328,10 @@ lcd_cmd_t lcd_init[] = {
 lcd_cmd_t lcd_reset = {RESET, 0, NULL};         /*!< SW reset */
 lcd_cmd_t lcd_sleep_out = {SLEEP_OUT, 0, NULL}; /*!< Exit sleep mode */
 lcd_cmd_t lcd_on = {DISPLAY_ON, 0, NULL};       /*!< Exit sleep mode */
+lcd_cmd_t lcd_off = {DISPLAY_OFF, 0, NULL};     /*!< Blank the display */
+lcd_cmd_t lcd_sleep_in = {SLEEP_IN, 0, NULL};   /*!< Enter sleep mode */
 
-orientation_properties_t lcd_orientation = {
+const orientation_properties_t default_orientation = {
     ILI9341_WIDTH,
     ILI9341_HEIGHT,
     ILI9341_Portrait_1,
@@ -230,103 +339,168 @@ orientation_properties_t lcd_orientation = {
 
 /* === Private function definitions ============================================================ */
 
-/* Send a command to the LCD. Uses spi_device_polling_transmit, which waits
- * until the transfer is complete.
- *
- * Since command transactions are usually small, they are handled in polling
- * mode for higher speed. The overhead of interrupt transactions is more than
- * just waiting for the transaction to complete.
+/* Send a command and its parameters to the LCD. The panel IO waits until the queued pixels are sent before it
+ * sends the command, so commands and pixels always reach the LCD in the order they were issued.
  */
-void lcd_cmd(const uint8_t cmd, bool keep_cs_active) {
-    esp_err_t ret;
-    spi_transaction_t t;
-    memset(&t, 0, sizeof(t)); // Zero out the transaction
-    t.length = 8;             // Command is 8 bits
-    t.tx_buffer = &cmd;       // The data is the cmd itself
-    t.user = (void *)0;       // D/C needs to be set to 0
-    if (keep_cs_active) {
-        t.flags = SPI_TRANS_CS_KEEP_ACTIVE; // Keep CS active after data transfer
-    }
-    ret = spi_device_polling_transmit(spi, &t); // Transmit!
-    assert(ret == ESP_OK);                      // Should have had no issues.
-}
-
-/* Send data to the LCD. Uses spi_device_polling_transmit, which waits until the
- * transfer is complete.
- *
- * Since data transactions are usually small, they are handled in polling
- * mode for higher speed. The overhead of interrupt transactions is more than
- * just waiting for the transaction to complete.
+void lcd_cmd(ili9341_t self, const uint8_t cmd, const uint8_t * params, int len) {
+    ESP_ERROR_CHECK(esp_lcd_panel_io_tx_param(self->io, cmd, params, len));
+    self->stats.commands++;
+    self->stats.bytes += 1 + len;
+    if (len != 0) {
+        self->stats.data_transactions++;
+    }
+}
+
+/* Send pixels to the LCD, after a memory write command or continuing the previous one. The pixels are sent with a
+ * DMA transaction, this function waits until it is done so the caller can reuse the buffer.
  */
-void lcd_data(const uint8_t * data, int len) {
-    esp_err_t ret;
-    spi_transaction_t t;
-    if (len == 0) {
-        return; // no need to send anything
+void lcd_data(ili9341_t self, int cmd, const uint8_t * data, int len) {
+    ESP_ERROR_CHECK(esp_lcd_panel_io_tx_color(self->io, cmd, data, len));
+    xSemaphoreTake(self->done, portMAX_DELAY);
+    if (cmd != NO_COMMAND) {
+        self->stats.commands++;
+        self->stats.bytes++;
     }
-    memset(&t, 0, sizeof(t));                   // Zero out the transaction
-    t.length = len * 8;                         // Len is in bytes, transaction length is in bits.
-    t.tx_buffer = data;                         // Data
-    t.user = (void *)1;                         // D/C needs to be set to 1
-    ret = spi_device_polling_transmit(spi, &t); // Transmit!
-    assert(ret == ESP_OK);                      // Should have had no issues.
+    self->stats.data_transactions++;
+    self->stats.bytes += len;
 }
 
-// This function is called (in irq context!) just before a transmission starts. It will
-// set the D/C line to the value indicated in the user field.
-void lcd_spi_pre_transfer_callback(spi_transaction_t * t) {
-    int dc = (int)t->user;
-    gpio_set_level(ILI9341_PIN_NUM_DC, dc);
+// This function is called (in irq context!) when the panel IO finishes a pixel transaction. It counts the
+// transaction as done so the task waiting for its buffer can continue.
+bool IRAM_ATTR lcd_color_trans_done_callback(esp_lcd_panel_io_handle_t io, esp_lcd_panel_io_event_data_t * event,
+                                             void * context) {
+    ili9341_t self = context;
+    BaseType_t woken = pdFALSE;
+
+    (void)io;
+    (void)event;
+    xSemaphoreGiveFromISR(self->done, &woken);
+    return woken == pdTRUE;
 }
 
-void spi_config() {
+ili9341_t panel_io_config(const ili9341_config_t * config) {
     esp_err_t ret;
 
-    spi_bus_config_t buscfg = {
-        .miso_io_num = ILI9341_PIN_NUM_MISO,
-        .mosi_io_num = ILI9341_PIN_NUM_MOSI,
-        .sclk_io_num = ILI9341_PIN_NUM_CLK,
-        .quadwp_io_num = -1,
-        .quadhd_io_num = -1,
-        .max_transfer_sz = PARALLEL_LINES * 320 * 2 + 8,
-    };
+    if (created >= ILI9341_MAX_DISPLAYS) {
+        return NULL;
+    }
+    ili9341_t self = &instances[created];
+    memset(self, 0, sizeof(struct ili9341_s));
+    self->config = *config;
+    self->lcd_orientation = default_orientation;
+    self->bounce = heap_caps_malloc(2 * BLIT_CHUNK, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    if (self->bounce == NULL) {
+        return NULL;
+    }
+    self->done = xSemaphoreCreateCounting(BLIT_QUEUE, 0);
+    if (self->done == NULL) {
+        heap_caps_free(self->bounce);
+        return NULL;
+    }
 
-    spi_device_interface_config_t devcfg = {
-#ifdef CONFIG_LCD_OVERCLOCK
-        .clock_speed_hz = 26 * 1000 * 1000, // Clock out at 26 MHz
+    if (config->bus == ILI9341_BUS_I80) {
+#if SOC_LCD_I80_SUPPORTED
+        self->config.clock_hz = config->clock_hz ? config->clock_hz : I80_CLOCK_HZ;
+
+        // Initialize the parallel bus, only once when two displays share it
+        if (i80_bus == NULL) {
+            esp_lcd_i80_bus_config_t buscfg = {
+                .dc_gpio_num = config->pin_dc,
+                .wr_gpio_num = config->pin_wr,
+                .clk_src = LCD_CLK_SRC_DEFAULT,
+                .bus_width = 8,
+                .max_transfer_bytes = MAX_TRANSFER,
+                .psram_trans_align = 64,
+                .sram_trans_align = 4,
+            };
+            for (int i = 0; i < 8; i++) {
+                buscfg.data_gpio_nums[i] = config->pin_data[i];
+            }
+            ret = esp_lcd_new_i80_bus(&buscfg, &i80_bus);
+            ESP_ERROR_CHECK(ret);
+        }
+
+        esp_lcd_panel_io_i80_config_t iocfg = {
+            .cs_gpio_num = config->pin_cs,
+            .pclk_hz = self->config.clock_hz,
+            .trans_queue_depth = BLIT_QUEUE,
+            .on_color_trans_done = lcd_color_trans_done_callback,
+            .user_ctx = self,
+            .lcd_cmd_bits = 8,
+            .lcd_param_bits = 8,
+            .dc_levels = {.dc_idle_level = 0, .dc_cmd_level = 0, .dc_dummy_level = 0, .dc_data_level = 1},
+        };
+        ret = esp_lcd_new_panel_io_i80(i80_bus, &iocfg, &self->io);
+        ESP_ERROR_CHECK(ret);
 #else
-        .clock_speed_hz = 10 * 1000 * 1000, // Clock out at 10 MHz
+        vSemaphoreDelete(self->done);
+        heap_caps_free(self->bounce);
+        return NULL;
 #endif
-        .mode = 0,                               // SPI mode 0
-        .spics_io_num = ILI9341_PIN_NUM_CS,      // CS pin
-        .queue_size = 7,                         // We want to be able to queue 7 transactions at a time
-        .pre_cb = lcd_spi_pre_transfer_callback, // Specify pre-transfer callback to handle D/C line
-    };
-
-    // Initialize the SPI bus
-    ret = spi_bus_initialize(ILI9341_SPI_PORT, &buscfg, SPI_DMA_CH_AUTO);
-    ESP_ERROR_CHECK(ret);
+    } else {
+        self->config.clock_hz = config->clock_hz ? config->clock_hz : LCD_CLOCK_HZ;
+
+        // Initialize the SPI bus, only once when two displays share it
+        if (!(buses & (1UL << config->host))) {
+            spi_bus_config_t buscfg = {
+                .miso_io_num = config->pin_miso,
+                .mosi_io_num = config->pin_mosi,
+                .sclk_io_num = config->pin_clk,
+                .quadwp_io_num = -1,
+                .quadhd_io_num = -1,
+                .max_transfer_sz = MAX_TRANSFER,
+            };
+            ret = spi_bus_initialize(config->host, &buscfg, SPI_DMA_CH_AUTO);
+            ESP_ERROR_CHECK(ret);
+            buses |= (1UL << config->host);
+        }
 
-    // Attach the LCD to the SPI bus
-    ret = spi_bus_add_device(ILI9341_SPI_PORT, &devcfg, &spi);
-    ESP_ERROR_CHECK(ret);
+        // Attach the LCD to the SPI bus, the panel IO drives the D/C line
+        esp_lcd_panel_io_spi_config_t iocfg = {
+            .dc_gpio_num = config->pin_dc,
+            .cs_gpio_num = config->pin_cs,
+            .pclk_hz = self->config.clock_hz,
+            .spi_mode = 0,
+            .trans_queue_depth = BLIT_QUEUE,
+            .on_color_trans_done = lcd_color_trans_done_callback,
+            .user_ctx = self,
+            .lcd_cmd_bits = 8,
+            .lcd_param_bits = 8,
+        };
+        ret = esp_lcd_new_panel_io_spi((esp_lcd_spi_bus_handle_t)config->host, &iocfg, &self->io);
+        ESP_ERROR_CHECK(ret);
+    }
+    created++;
+    return self;
 }
 
-void WriteLCD(lcd_cmd_t * data) {
-    /* If command is NULL don't send command */
-    if (data->cmd != 0) {
-        /* Send command */
-        lcd_cmd(data->cmd, false);
+void WriteLCD(ili9341_t self, lcd_cmd_t * data) {
+    /* Pixels drawn on a canvas stay in memory, any other command goes to the LCD */
+    if (self->target != NULL && (data->cmd == MEM_WRITE || data->cmd == SEND_PIXELS)) {
+        if (data->cmd == MEM_WRITE) {
+            self->canvas_window.x = self->canvas_window.x0;
+            self->canvas_window.y = self->canvas_window.y0;
+        }
+        CanvasWrite(self, data->data, data->databytes);
+        return;
     }
-    /* If there are parameters or data to send */
-    if (data->databytes != 0) {
-        /* Send parameters or data */
-        lcd_data(data->data, data->databytes);
+    /* Pixels are sent as color transactions, without command they continue the previous memory write */
+    if (data->cmd == MEM_WRITE || data->cmd == SEND_PIXELS) {
+        if (data->databytes != 0) {
+            lcd_data(self, (data->cmd == MEM_WRITE) ? MEM_WRITE : NO_COMMAND, data->data, data->databytes);
+        } else if (data->cmd == MEM_WRITE) {
+            lcd_cmd(self, MEM_WRITE, NULL, 0);
+        }
+        return;
     }
+    /* Send command and parameters */
+    lcd_cmd(self, data->cmd, data->data, data->databytes);
 }
 
-void SetCursorPosition(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
-    static uint16_t aux;
+void SetCursorPosition(ili9341_t self, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
+    uint16_t aux;
+
+    PERFIL_INICIO();
     /* The lower column must be send first */
     if (x0 > x1) {
         aux = x0;
@@ -339,19 +513,41 @@ void SetCursorPosition(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
         y0 = y1;
         y1 = aux;
     }
+    if (self->target != NULL) {
+        self->canvas_window.x0 = x0;
+        self->canvas_window.y0 = y0;
+        self->canvas_window.x1 = x1;
+        self->canvas_window.y1 = y1;
+        PERFIL_FIN(PERFIL_CURSOR);
+        return;
+    }
+    /* The window is always sent, even if unchanged, because it also resets the frame memory write pointer */
+    self->stats.window_sets++;
+    if (self->last_window.valid && self->last_window.x0 == x0 && self->last_window.y0 == y0 &&
+        self->last_window.x1 == x1 && self->last_window.y1 == y1) {
+        self->stats.redundant_window_sets++;
+    }
+    self->last_window.valid = true;
+    self->last_window.x0 = x0;
+    self->last_window.y0 = y0;
+    self->last_window.x1 = x1;
+    self->last_window.y1 = y1;
     uint8_t columns[] = {HighByte(x0), LowByte(x0), HighByte(x1), LowByte(x1)};
     lcd_cmd_t lcd_columns = {COLUMN_ADDR_SET, 4, columns};
     uint8_t rows[] = {HighByte(y0), LowByte(y0), HighByte(y1), LowByte(y1)};
     lcd_cmd_t lcd_rows = {PAGE_ADDR_SET, 4, rows};
-    WriteLCD(&lcd_columns);
-    WriteLCD(&lcd_rows);
+    WriteLCD(self, &lcd_columns);
+    WriteLCD(self, &lcd_rows);
+    PERFIL_FIN(PERFIL_CURSOR);
 }
 
-void Fill(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color) {
-    static uint16_t i;
-    static int32_t bytes_count;
-    static int16_t x_dist, y_dist;
-    static uint8_t pixel[MAX_VALUE_SIZE];
+void Fill(ili9341_t self, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color) {
+    uint16_t i;
+    int32_t bytes_count;
+    int16_t x_dist, y_dist;
+    uint8_t pixel[MAX_VALUE_SIZE];
+
+    PERFIL_INICIO();
 
     x_dist = x1 - x0;
     y_dist = y1 - y0;
@@ -364,7 +560,7 @@ void Fill(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color) {
     /* Number of bytes to write. We have to write 2 bytes/pixel (16bits color) */
     bytes_count = (x_dist + 1) * (y_dist + 1) * 2;
     /* Define area to fill */
-    SetCursorPosition(x0, y0, x1, y1);
+    SetCursorPosition(self, x0, y0, x1, y1);
 
     for (i = 0; i < MAX_VALUE_SIZE; i += 2) {
         pixel[i] = HighByte(color);
@@ -372,133 +568,312 @@ void Fill(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color) {
     }
     /* Start writing LCD memory */
     lcd_cmd_t lcd_write = {MEM_WRITE, 0, NULL};
-    WriteLCD(&lcd_write);
+    WriteLCD(self, &lcd_write);
 
     while (bytes_count - MAX_VALUE_SIZE > 0) {
         lcd_cmd_t lcd_pixel = {SEND_PIXELS, MAX_VALUE_SIZE, pixel};
-        WriteLCD(&lcd_pixel);
+        WriteLCD(self, &lcd_pixel);
         bytes_count -= MAX_VALUE_SIZE;
     }
     lcd_cmd_t lcd_pixel = {SEND_PIXELS, bytes_count, pixel};
-    WriteLCD(&lcd_pixel);
+    WriteLCD(self, &lcd_pixel);
+    PERFIL_FIN(PERFIL_FILL);
+}
+
+static inline uint16_t TargetWidth(ili9341_t self) {
+    return (self->target != NULL) ? self->target->width : self->lcd_orientation.width;
+}
+
+static inline uint16_t TargetHeight(ili9341_t self) {
+    return (self->target != NULL) ? self->target->height : self->lcd_orientation.height;
+}
+
+void CanvasWrite(ili9341_t self, const uint8_t * data, uint32_t bytes) {
+    ili9341_canvas_t * canvas = self->target;
+    uint32_t pixels = bytes / 2;
+    uint16_t x = self->canvas_window.x;
+    uint16_t y = self->canvas_window.y;
+
+    /* Each pass writes what is left of the current window row, clipped to the canvas */
+    while (pixels > 0 && y <= self->canvas_window.y1) {
+        uint32_t run = self->canvas_window.x1 - x + 1;
+        if (run > pixels) {
+            run = pixels;
+        }
+        if (y < canvas->height && x < canvas->width) {
+            uint32_t visible = canvas->width - x;
+            if (visible > run) {
+                visible = run;
+            }
+            memcpy(&canvas->pixels[y * canvas->width + x], data, visible * 2);
+        }
+        data += run * 2;
+        pixels -= run;
+        x += run;
+        if (x > self->canvas_window.x1) {
+            x = self->canvas_window.x0;
+            y++;
+        }
+    }
+    self->canvas_window.x = x;
+    self->canvas_window.y = y;
+}
+
+void QueuePixels(ili9341_t self, const uint8_t * data, uint32_t bytes, uint8_t * in_flight) {
+    if (self->target != NULL) {
+        CanvasWrite(self, data, bytes);
+        return;
+    }
+    /* The memory write command was sent before, the panel IO returns as soon as the transaction is queued */
+    ESP_ERROR_CHECK(esp_lcd_panel_io_tx_color(self->io, NO_COMMAND, data, bytes));
+    self->stats.data_transactions++;
+    self->stats.bytes += bytes;
+    (*in_flight)++;
+}
+
+void WaitPixels(ili9341_t self, uint8_t * in_flight) {
+    /* Transactions finish in order, so this is the oldest one */
+    xSemaphoreTake(self->done, portMAX_DELAY);
+    (*in_flight)--;
+}
+
+void CopyWords(uint32_t * destination, const uint8_t * source, uint32_t bytes) {
+    if (((uintptr_t)source & 3) != 0) {
+        memcpy(destination, source, bytes);
+        return;
+    }
+    const uint32_t * words = (const uint32_t *)source;
+    for (uint32_t i = 0; i < bytes / 4; i++) {
+        destination[i] = words[i];
+    }
+    memcpy(&destination[bytes / 4], &words[bytes / 4], bytes & 3);
 }
 
 /* === Public function implementation ========================================================== */
 
-void ILI9341Init(void) {
-    spi_config();
+ili9341_t ILI9341Init(const ili9341_config_t * config) {
+    ili9341_t self = panel_io_config(config);
+    if (self == NULL) {
+        return NULL;
+    }
 
-    // Initialize non-SPI GPIOs
+    // Initialize the GPIOs not driven by the panel IO
     gpio_config_t io_conf = {};
-    io_conf.pin_bit_mask =
-        ((1ULL << ILI9341_PIN_NUM_DC) | (1ULL << ILI9341_PIN_NUM_RST) | (1ULL << ILI9341_PIN_NUM_BCKL));
+    io_conf.pin_bit_mask = ((1ULL << config->pin_rst) | (1ULL << config->pin_bckl));
     io_conf.mode = GPIO_MODE_OUTPUT;
     io_conf.pull_up_en = true;
     gpio_config(&io_conf);
 
     /* Reset the display */
-    gpio_set_level(ILI9341_PIN_NUM_RST, 0);
+    gpio_set_level(config->pin_rst, 0);
     vTaskDelay(10 / portTICK_PERIOD_MS);
-    gpio_set_level(ILI9341_PIN_NUM_RST, 1);
+    gpio_set_level(config->pin_rst, 1);
     vTaskDelay(10 / portTICK_PERIOD_MS);
 
     /* It will be necessary to wait 5msec before sending new command following software reset */
-    WriteLCD(&lcd_reset);
+    WriteLCD(self, &lcd_reset);
     vTaskDelay(10 / portTICK_PERIOD_MS);
 
     /* Send initial configuration to LCD */
     for (uint8_t i = 0; i < sizeof(lcd_init) / sizeof(lcd_cmd_t); i++) {
-        WriteLCD(&lcd_init[i]);
+        WriteLCD(self, &lcd_init[i]);
     }
     /* It will be necessary to wait 5msec before sending next command after sleep out */
-    WriteLCD(&lcd_sleep_out);
+    WriteLCD(self, &lcd_sleep_out);
     vTaskDelay(10 / portTICK_PERIOD_MS);
-    WriteLCD(&lcd_on);
+    WriteLCD(self, &lcd_on);
     vTaskDelay(10 / portTICK_PERIOD_MS);
 
     /* Enable backlight */
-    gpio_set_level(ILI9341_PIN_NUM_BCKL, ILI9341_BK_LIGHT_ON_LEVEL);
+    gpio_set_level(config->pin_bckl, ILI9341_BK_LIGHT_ON_LEVEL);
 
     /* Start screen on White */
-    ILI9341Fill(ILI9341_BLACK);
+    ILI9341Fill(self, ILI9341_BLACK);
+    return self;
 }
 
-void ILI9341DrawPixel(uint16_t x, uint16_t y, uint16_t color) {
+ili9341_t ILI9341Resume(const ili9341_config_t * config) {
+    ili9341_t self = panel_io_config(config);
+    if (self == NULL) {
+        return NULL;
+    }
+
+    /* RST must stay high while the pins are configured again, otherwise the LCD loses its frame memory */
+    gpio_set_level(config->pin_rst, 1);
+    gpio_config_t io_conf = {};
+    io_conf.pin_bit_mask = ((1ULL << config->pin_rst) | (1ULL << config->pin_bckl));
+    io_conf.mode = GPIO_MODE_OUTPUT;
+    io_conf.pull_up_en = true;
+    gpio_config(&io_conf);
+
+    /* Release the pins held during deep sleep */
+    gpio_hold_dis(config->pin_rst);
+    gpio_hold_dis(config->pin_bckl);
+    gpio_hold_dis(config->pin_cs);
+    gpio_deep_sleep_hold_dis();
+
+    /* It will be necessary to wait 5msec before sending next command after sleep out */
+    WriteLCD(self, &lcd_sleep_out);
+    vTaskDelay(10 / portTICK_PERIOD_MS);
+    WriteLCD(self, &lcd_on);
+
+    /* Enable backlight */
+    gpio_set_level(config->pin_bckl, ILI9341_BK_LIGHT_ON_LEVEL);
+    return self;
+}
+
+void ILI9341Sleep(ili9341_t self) {
+    WriteLCD(self, &lcd_off);
+    /* It will be necessary to wait 5msec before the MCU stops driving the bus after sleep in */
+    WriteLCD(self, &lcd_sleep_in);
+    vTaskDelay(10 / portTICK_PERIOD_MS);
+
+    /* Disable backlight */
+    gpio_set_level(self->config.pin_bckl, !ILI9341_BK_LIGHT_ON_LEVEL);
+
+    /* Keep RST and CS inactive during deep sleep so the frame memory is preserved */
+    gpio_hold_en(self->config.pin_rst);
+    gpio_hold_en(self->config.pin_bckl);
+    gpio_hold_en(self->config.pin_cs);
+    gpio_deep_sleep_hold_en();
+}
+
+uint32_t ILI9341GetBusClock(ili9341_t self) {
+    return self->config.clock_hz;
+}
+
+uint8_t ILI9341GetBusWidth(ili9341_t self) {
+    return (self->config.bus == ILI9341_BUS_I80) ? 8 : 1;
+}
+
+void ILI9341GetStats(ili9341_t self, ili9341_stats_t * result) {
+    *result = self->stats;
+}
+
+void ILI9341ResetStats(ili9341_t self) {
+    memset(&self->stats, 0, sizeof(self->stats));
+}
+
+void ILI9341CanvasInit(ili9341_canvas_t * canvas, uint16_t * buffer, uint16_t width, uint16_t height) {
+    canvas->width = width;
+    canvas->height = height;
+    canvas->pixels = buffer;
+}
+
+void ILI9341SetTarget(ili9341_t self, ili9341_canvas_t * canvas) {
+    self->target = canvas;
+}
+
+void ILI9341BlitCanvas(ili9341_t self, const ili9341_canvas_t * canvas, uint16_t x, uint16_t y) {
+    const uint8_t * data = (const uint8_t *)canvas->pixels;
+    uint32_t bytes_count = canvas->width * canvas->height * 2;
+    uint8_t pending = 0;
+
+    PERFIL_INICIO();
+
+    SetCursorPosition(self, x, y, x + canvas->width - 1, y + canvas->height - 1);
+    lcd_cmd(self, MEM_WRITE, NULL, 0);
+
+    /* Transactions are queued so the DMA sends a chunk while the next one is set up */
+    while (bytes_count > 0 || pending > 0) {
+        if (bytes_count > 0 && pending < BLIT_QUEUE) {
+            uint32_t chunk = (bytes_count > BLIT_CHUNK) ? BLIT_CHUNK : bytes_count;
+            QueuePixels(self, data, chunk, &pending);
+            data += chunk;
+            bytes_count -= chunk;
+        } else {
+            WaitPixels(self, &pending);
+        }
+    }
+    PERFIL_FIN(PERFIL_BLIT);
+}
+
+void ILI9341DrawPixel(ili9341_t self, uint16_t x, uint16_t y, uint16_t color) {
+    PERFIL_INICIO();
     /* Define area (pixel) to fill */
-    SetCursorPosition(x, y, x, y);
+    SetCursorPosition(self, x, y, x, y);
     uint8_t pixels[] = {HighByte(color), LowByte(color)};
     lcd_cmd_t lcd_pixels = {MEM_WRITE, sizeof(pixels), pixels};
-    WriteLCD(&lcd_pixels);
+    WriteLCD(self, &lcd_pixels);
+    PERFIL_FIN(PERFIL_PIXEL);
 }
 
-void ILI9341Fill(uint16_t color) {
-    Fill(0, 0, lcd_orientation.width, lcd_orientation.height, color);
+void ILI9341Fill(ili9341_t self, uint16_t color) {
+    if (self->target != NULL) {
+        Fill(self, 0, 0, self->target->width - 1, self->target->height - 1, color);
+        return;
+    }
+    Fill(self, 0, 0, self->lcd_orientation.width - 1, self->lcd_orientation.height - 1, color);
 }
 
-void ILI9341Rotate(ili9341_orientation_t orientation) {
+void ILI9341Rotate(ili9341_t self, ili9341_orientation_t orientation) {
     uint8_t mem_acc[1];
     switch (orientation) {
     case ILI9341_Portrait_1:
         mem_acc[0] = 0x48; /*!< Row Address Order (MY) = 0, Column Address Order (MX) = 1,
                               Row/Column Exchange (MV) = 0 */
-        lcd_orientation.width = ILI9341_WIDTH;
-        lcd_orientation.height = ILI9341_HEIGHT;
-        lcd_orientation.orientation = ILI9341_Portrait_1;
+        self->lcd_orientation.width = ILI9341_WIDTH;
+        self->lcd_orientation.height = ILI9341_HEIGHT;
+        self->lcd_orientation.orientation = ILI9341_Portrait_1;
         break;
 
     case ILI9341_Portrait_2:
         mem_acc[0] = 0x88; /*!< Row Address Order (MY) = 1, Column Address Order (MX) = 1,
                               Row/Column Exchange (MV) = 0 */
-        lcd_orientation.width = ILI9341_WIDTH;
-        lcd_orientation.height = ILI9341_HEIGHT;
-        lcd_orientation.orientation = ILI9341_Portrait_2;
+        self->lcd_orientation.width = ILI9341_WIDTH;
+        self->lcd_orientation.height = ILI9341_HEIGHT;
+        self->lcd_orientation.orientation = ILI9341_Portrait_2;
         break;
 
     case ILI9341_Landscape_1:
         mem_acc[0] = 0x28; /*!< Row Address Order (MY) = 0, Column Address Order (MX) = 0,
                               Row/Column Exchange (MV) = 1 */
-        lcd_orientation.width = ILI9341_HEIGHT;
-        lcd_orientation.height = ILI9341_WIDTH;
-        lcd_orientation.orientation = ILI9341_Landscape_1;
+        self->lcd_orientation.width = ILI9341_HEIGHT;
+        self->lcd_orientation.height = ILI9341_WIDTH;
+        self->lcd_orientation.orientation = ILI9341_Landscape_1;
         break;
 
     case ILI9341_Landscape_2:
         mem_acc[0] = 0xE8; /*!< Row Address Order (MY) = 1, Column Address Order (MX) = 1,
                               Row/Column Exchange (MV) = 1 */
-        lcd_orientation.width = ILI9341_HEIGHT;
-        lcd_orientation.height = ILI9341_WIDTH;
-        lcd_orientation.orientation = ILI9341_Landscape_2;
+        self->lcd_orientation.width = ILI9341_HEIGHT;
+        self->lcd_orientation.height = ILI9341_WIDTH;
+        self->lcd_orientation.orientation = ILI9341_Landscape_2;
         break;
     }
     lcd_cmd_t lcd_mem_acc = {MEM_ACC_CTRL, 1, mem_acc};
-    WriteLCD(&lcd_mem_acc);
+    WriteLCD(self, &lcd_mem_acc);
+    self->last_window.valid = false;
 }
 
-void ILI9341DrawChar(uint16_t x, uint16_t y, char data, Font_t * font, uint16_t foreground, uint16_t background) {
-    static uint16_t i, j, k;
-    static uint16_t char_row;
-    static uint16_t lcd_x, lcd_y;
-    static int32_t bytes_count;
-    static uint8_t pixel[MAX_VALUE_SIZE];
+void ILI9341DrawChar(ili9341_t self, uint16_t x, uint16_t y, char data, Font_t * font, uint16_t foreground,
+                     uint16_t background) {
+    uint16_t i, j, k;
+    uint16_t char_row;
+    uint16_t lcd_x, lcd_y;
+    int32_t bytes_count;
+    uint8_t pixel[MAX_VALUE_SIZE];
+
+    PERFIL_INICIO();
 
     /* Set coordinates */
     lcd_x = x;
     lcd_y = y;
 
     /* If at the end of a line of display, go to new line and set x to 0 position */
-    if ((lcd_x + font->FontWidth) > lcd_orientation.width) {
+    if ((lcd_x + font->FontWidth) > TargetWidth(self)) {
         lcd_y += font->FontHeight;
         lcd_x = 0;
     }
 
-    SetCursorPosition(lcd_x, lcd_y, lcd_x + font->FontWidth - 1, lcd_y + font->FontHeight - 1);
+    SetCursorPosition(self, lcd_x, lcd_y, lcd_x + font->FontWidth - 1, lcd_y + font->FontHeight - 1);
 
     /* Number of bytes to write. We have to write 2 bytes/pixel */
     bytes_count = font->FontHeight * font->FontWidth * 2;
 
     /* Start writing LCD memory */
     lcd_cmd_t lcd_write = {MEM_WRITE, 0, NULL};
-    WriteLCD(&lcd_write);
+    WriteLCD(self, &lcd_write);
 
     /* Draw font data */
     /* go through character rows */
@@ -511,7 +886,7 @@ void ILI9341DrawChar(uint16_t x, uint16_t y, char data, Font_t * font, uint16_t
             /* If exceed buffer size, send buffer */
             if ((2 * j + i * font->FontWidth * 2 - k * MAX_VALUE_SIZE + 1) > MAX_VALUE_SIZE) {
                 lcd_cmd_t lcd_pixels = {SEND_PIXELS, MAX_VALUE_SIZE, pixel};
-                WriteLCD(&lcd_pixels);
+                WriteLCD(self, &lcd_pixels);
                 bytes_count -= MAX_VALUE_SIZE;
                 k++;
             }
@@ -529,11 +904,15 @@ void ILI9341DrawChar(uint16_t x, uint16_t y, char data, Font_t * font, uint16_t
     }
     /* Send the rest of the buffer */
     lcd_cmd_t lcd_pixels = {SEND_PIXELS, bytes_count, pixel};
-    WriteLCD(&lcd_pixels);
+    WriteLCD(self, &lcd_pixels);
+    PERFIL_FIN(PERFIL_CHAR);
 }
 
-void ILI9341DrawString(uint16_t x, uint16_t y, char * str, Font_t * font, uint16_t foreground, uint16_t background) {
-    static uint16_t lcd_x, lcd_y;
+void ILI9341DrawString(ili9341_t self, uint16_t x, uint16_t y, char * str, Font_t * font, uint16_t foreground,
+                       uint16_t background) {
+    uint16_t lcd_x, lcd_y;
+
+    PERFIL_INICIO();
 
     /* Set coordinates */
     lcd_x = x;
@@ -557,15 +936,16 @@ void ILI9341DrawString(uint16_t x, uint16_t y, char * str, Font_t * font, uint16
         }
 
         /* Put character to LCD */
-        ILI9341DrawChar(lcd_x, lcd_y, *str, font, foreground, background);
+        ILI9341DrawChar(self, lcd_x, lcd_y, *str, font, foreground, background);
         /* Next character */
         str++;
         lcd_x += font->FontWidth;
     }
+    PERFIL_FIN(PERFIL_STRING);
 }
 
 void ILI9341GetStringSize(char * str, Font_t * font, uint16_t * width, uint16_t * height) {
-    static uint16_t w;
+    uint16_t w;
 
     *height = font->FontHeight;
     w = 0;
@@ -577,21 +957,23 @@ void ILI9341GetStringSize(char * str, Font_t * font, uint16_t * width, uint16_t
     *width = w;
 }
 
-void ILI9341DrawLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color) {
-    static int16_t x_dist, y_dist, x_grow, y_grow, error, error_2;
+void ILI9341DrawLine(ili9341_t self, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color) {
+    int16_t x_dist, y_dist, x_grow, y_grow, error, error_2;
+
+    PERFIL_INICIO();
 
     /* Check for overflow */
-    if (x0 >= lcd_orientation.width) {
-        x0 = lcd_orientation.width - 1;
+    if (x0 >= TargetWidth(self)) {
+        x0 = TargetWidth(self) - 1;
     }
-    if (x1 >= lcd_orientation.width) {
-        x1 = lcd_orientation.width - 1;
+    if (x1 >= TargetWidth(self)) {
+        x1 = TargetWidth(self) - 1;
     }
-    if (y0 >= lcd_orientation.height) {
-        y0 = lcd_orientation.height - 1;
+    if (y0 >= TargetHeight(self)) {
+        y0 = TargetHeight(self) - 1;
     }
-    if (y1 >= lcd_orientation.height) {
-        y1 = lcd_orientation.height - 1;
+    if (y1 >= TargetHeight(self)) {
+        y1 = TargetHeight(self) - 1;
     }
 
     /* Calculate x y distances and determine grow direction */
@@ -612,7 +994,7 @@ void ILI9341DrawLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_
 
     /* Vertical or horizontal line */
     if (x_dist == 0 || y_dist == 0) {
-        Fill(x0, y0, x1, y1, color);
+        Fill(self, x0, y0, x1, y1, color);
     }
     /* Diagonal line */
     else {
@@ -624,7 +1006,7 @@ void ILI9341DrawLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_
 
         while (1) {
             /* Draw start point */
-            ILI9341DrawPixel(x0, y0, color);
+            ILI9341DrawPixel(self, x0, y0, color);
             /* Loop ends when start point reaches end point */
             if (x0 == x1 || y0 == y1) {
                 break;
@@ -642,21 +1024,26 @@ void ILI9341DrawLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_
             }
         }
     }
+    PERFIL_FIN(PERFIL_LINEA);
 }
 
-void ILI9341DrawRectangle(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color) {
-    ILI9341DrawLine(x0, y0, x1, y0, color); /* Draw top line */
-    ILI9341DrawLine(x1, y0, x1, y1, color); /* Draw right line */
-    ILI9341DrawLine(x0, y1, x1, y1, color); /* Draw bottom line */
-    ILI9341DrawLine(x0, y0, x0, y1, color); /* Draw left line */
+void ILI9341DrawRectangle(ili9341_t self, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color) {
+    PERFIL_INICIO();
+    ILI9341DrawLine(self, x0, y0, x1, y0, color); /* Draw top line */
+    ILI9341DrawLine(self, x1, y0, x1, y1, color); /* Draw right line */
+    ILI9341DrawLine(self, x0, y1, x1, y1, color); /* Draw bottom line */
+    ILI9341DrawLine(self, x0, y0, x0, y1, color); /* Draw left line */
+    PERFIL_FIN(PERFIL_RECTANGULO);
 }
 
-void ILI9341DrawFilledRectangle(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color) {
-    Fill(x0, y0, x1, y1, color);
+void ILI9341DrawFilledRectangle(ili9341_t self, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color) {
+    Fill(self, x0, y0, x1, y1, color);
 }
 
-void ILI9341DrawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color) {
-    static int16_t f, ddF_x, ddF_y, x, y;
+void ILI9341DrawCircle(ili9341_t self, int16_t x0, int16_t y0, int16_t r, uint16_t color) {
+    int16_t f, ddF_x, ddF_y, x, y;
+
+    PERFIL_INICIO();
 
     f = 1 - r;
     ddF_x = 1;
@@ -664,10 +1051,10 @@ void ILI9341DrawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color) {
     x = 0;
     y = r;
 
-    ILI9341DrawPixel(x0, y0 + r, color);
-    ILI9341DrawPixel(x0, y0 - r, color);
-    ILI9341DrawPixel(x0 + r, y0, color);
-    ILI9341DrawPixel(x0 - r, y0, color);
+    ILI9341DrawPixel(self, x0, y0 + r, color);
+    ILI9341DrawPixel(self, x0, y0 - r, color);
+    ILI9341DrawPixel(self, x0 + r, y0, color);
+    ILI9341DrawPixel(self, x0 - r, y0, color);
 
     while (x < y) {
         if (f >= 0) {
@@ -679,20 +1066,23 @@ void ILI9341DrawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color) {
         ddF_x += 2;
         f += ddF_x;
 
-        ILI9341DrawPixel(x0 + x, y0 + y, color);
-        ILI9341DrawPixel(x0 - x, y0 + y, color);
-        ILI9341DrawPixel(x0 + x, y0 - y, color);
-        ILI9341DrawPixel(x0 - x, y0 - y, color);
+        ILI9341DrawPixel(self, x0 + x, y0 + y, color);
+        ILI9341DrawPixel(self, x0 - x, y0 + y, color);
+        ILI9341DrawPixel(self, x0 + x, y0 - y, color);
+        ILI9341DrawPixel(self, x0 - x, y0 - y, color);
 
-        ILI9341DrawPixel(x0 + y, y0 + x, color);
-        ILI9341DrawPixel(x0 - y, y0 + x, color);
-        ILI9341DrawPixel(x0 + y, y0 - x, color);
-        ILI9341DrawPixel(x0 - y, y0 - x, color);
+        ILI9341DrawPixel(self, x0 + y, y0 + x, color);
+        ILI9341DrawPixel(self, x0 - y, y0 + x, color);
+        ILI9341DrawPixel(self, x0 + y, y0 - x, color);
+        ILI9341DrawPixel(self, x0 - y, y0 - x, color);
     }
+    PERFIL_FIN(PERFIL_CIRCULO);
 }
 
-void ILI9341DrawFilledCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color) {
-    static int16_t f, ddF_x, ddF_y, x, y;
+void ILI9341DrawFilledCircle(ili9341_t self, int16_t x0, int16_t y0, int16_t r, uint16_t color) {
+    int16_t f, ddF_x, ddF_y, x, y;
+
+    PERFIL_INICIO();
 
     f = 1 - r;
     ddF_x = 1;
@@ -700,11 +1090,11 @@ void ILI9341DrawFilledCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color)
     x = 0;
     y = r;
 
-    ILI9341DrawPixel(x0, y0 + r, color);
-    ILI9341DrawPixel(x0, y0 - r, color);
-    ILI9341DrawPixel(x0 + r, y0, color);
-    ILI9341DrawPixel(x0 - r, y0, color);
-    ILI9341DrawLine(x0 - r, y0, x0 + r, y0, color);
+    ILI9341DrawPixel(self, x0, y0 + r, color);
+    ILI9341DrawPixel(self, x0, y0 - r, color);
+    ILI9341DrawPixel(self, x0 + r, y0, color);
+    ILI9341DrawPixel(self, x0 - r, y0, color);
+    ILI9341DrawLine(self, x0 - r, y0, x0 + r, y0, color);
 
     while (x < y) {
         if (f >= 0) {
@@ -716,43 +1106,169 @@ void ILI9341DrawFilledCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color)
         ddF_x += 2;
         f += ddF_x;
 
-        ILI9341DrawLine(x0 - x, y0 + y, x0 + x, y0 + y, color);
-        ILI9341DrawLine(x0 + x, y0 - y, x0 - x, y0 - y, color);
+        ILI9341DrawLine(self, x0 - x, y0 + y, x0 + x, y0 + y, color);
+        ILI9341DrawLine(self, x0 + x, y0 - y, x0 - x, y0 - y, color);
 
-        ILI9341DrawLine(x0 + y, y0 + x, x0 - y, y0 + x, color);
-        ILI9341DrawLine(x0 + y, y0 - x, x0 - y, y0 - x, color);
+        ILI9341DrawLine(self, x0 + y, y0 + x, x0 - y, y0 + x, color);
+        ILI9341DrawLine(self, x0 + y, y0 - x, x0 - y, y0 - x, color);
     }
+    PERFIL_FIN(PERFIL_CIRCULO_RELLENO);
 }
 
-void ILI9341DrawPicture(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint8_t * pic) {
-    static uint16_t i, j;
-    static int32_t bytes_count;
-    static uint8_t pixel[MAX_VALUE_SIZE];
+void ILI9341DrawPicture(ili9341_t self, uint16_t x, uint16_t y, uint16_t width, uint16_t height, const uint8_t * pic) {
+    uint32_t bytes_count = width * height * 2;
+    uint8_t current = 0, in_flight = 0;
 
-    SetCursorPosition(x, y, x + width - 1, y + height - 1);
+    PERFIL_INICIO();
 
-    /* Number of bytes to write. We have to write 2 bytes/pixel */
-    bytes_count = width * height * 2;
+    SetCursorPosition(self, x, y, x + width - 1, y + height - 1);
 
     /* Start writing LCD memory */
     lcd_cmd_t lcd_write = {MEM_WRITE, 0, NULL};
-    WriteLCD(&lcd_write);
+    WriteLCD(self, &lcd_write);
+
+    if (self->target != NULL) {
+        CanvasWrite(self, pic, bytes_count);
+    } else if (esp_ptr_dma_capable(pic)) {
+        /* The DMA reads internal RAM directly, the picture is sent without copies */
+        while (bytes_count > 0) {
+            uint32_t chunk = (bytes_count > BLIT_CHUNK) ? BLIT_CHUNK : bytes_count;
+            QueuePixels(self, pic, chunk, &in_flight);
+            pic += chunk;
+            bytes_count -= chunk;
+            current ^= 1;
+            if (in_flight == 2) {
+                WaitPixels(self, &in_flight);
+            }
+        }
+    } else {
+        /* Flash mapped pictures go through the bounce buffers, the next slice is copied while the previous one
+         * is on the bus */
+        while (bytes_count > 0) {
+            uint32_t chunk = (bytes_count > BLIT_CHUNK) ? BLIT_CHUNK : bytes_count;
+            CopyWords(self->bounce[current], pic, chunk);
+            QueuePixels(self, (const uint8_t *)self->bounce[current], chunk, &in_flight);
+            pic += chunk;
+            bytes_count -= chunk;
+            current ^= 1;
+            if (in_flight == 2) {
+                WaitPixels(self, &in_flight);
+            }
+        }
+    }
+    while (in_flight > 0) {
+        WaitPixels(self, &in_flight);
+    }
+    PERFIL_FIN(PERFIL_IMAGEN);
+}
+
+void ILI9341DrawRLEPicture(ili9341_t self, uint16_t x, uint16_t y, const uint8_t * image) {
+    uint16_t width = (image[0] << 8) | image[1];
+    uint16_t height = (image[2] << 8) | image[3];
+    uint16_t colors = image[4] ? image[4] : 256;
+    const uint8_t * palette = &image[RLE_HEADER];
+    const uint8_t * data = palette + colors * 2;
+    uint32_t pixels = width * height;
+    uint32_t fill = 0;
+    uint8_t current = 0, in_flight = 0;
+
+    PERFIL_INICIO();
+
+    SetCursorPosition(self, x, y, x + width - 1, y + height - 1);
+    lcd_cmd_t lcd_write = {MEM_WRITE, 0, NULL};
+    WriteLCD(self, &lcd_write);
 
-    j = 0;
-    while (bytes_count - MAX_VALUE_SIZE > 0) {
-        for (i = 0; i < MAX_VALUE_SIZE; i++) {
-            pixel[i] = pic[j * MAX_VALUE_SIZE + i];
+    while (pixels > 0) {
+        uint8_t header = *data++;
+        uint32_t count = (header & ~RLE_RUN) + 1;
+        if (count > pixels) {
+            count = pixels; /* Corrupted picture, never write past the window */
+        }
+        pixels -= count;
+        while (count > 0) {
+            /* Expand the packet until the buffer is full */
+            uint8_t * buffer = (uint8_t *)self->bounce[current];
+            uint32_t room = (BLIT_CHUNK - fill) / 2;
+            uint32_t step = (count < room) ? count : room;
+            for (uint32_t i = 0; i < step; i++) {
+                const uint8_t * color = &palette[2 * ((header & RLE_RUN) ? data[0] : data[i])];
+                buffer[fill++] = color[0];
+                buffer[fill++] = color[1];
+            }
+            if (!(header & RLE_RUN)) {
+                data += step;
+            }
+            count -= step;
+            /* Send the full buffer and decode on the other one once its previous transaction is done */
+            if (fill == BLIT_CHUNK) {
+                QueuePixels(self, buffer, fill, &in_flight);
+                current ^= 1;
+                fill = 0;
+                if (in_flight == 2) {
+                    WaitPixels(self, &in_flight);
+                }
+            }
+        }
+        if (header & RLE_RUN) {
+            data++;
         }
-        lcd_cmd_t lcd_pixel = {SEND_PIXELS, MAX_VALUE_SIZE, pixel};
-        WriteLCD(&lcd_pixel);
-        bytes_count -= MAX_VALUE_SIZE;
-        j++;
     }
-    for (i = 0; i < bytes_count; i++) {
-        pixel[i] = pic[j * MAX_VALUE_SIZE + i];
+    if (fill > 0) {
+        QueuePixels(self, (const uint8_t *)self->bounce[current], fill, &in_flight);
     }
-    lcd_cmd_t lcd_pixel = {SEND_PIXELS, bytes_count, pixel};
-    WriteLCD(&lcd_pixel);
+    while (in_flight > 0) {
+        WaitPixels(self, &in_flight);
+    }
+    PERFIL_FIN(PERFIL_IMAGEN_RLE);
+}
+
+void ILI9341DrawSprite(ili9341_t self, uint16_t x, uint16_t y, const ili9341_sprite_t * sprite,
+                       const uint16_t * palette) {
+    uint8_t bpp = sprite->bpp;
+    uint8_t mask = (1 << bpp) - 1;
+    uint32_t stride = (sprite->width * bpp + 7) / 8;
+    uint32_t fill = 0;
+    uint8_t current = 0, in_flight = 0;
+
+    /* Only whole pixels per byte are supported, with other sizes the bit position of a pixel would go out of range */
+    if (bpp != 1 && bpp != 2 && bpp != 4 && bpp != 8) {
+        return;
+    }
+
+    PERFIL_INICIO();
+
+    /* Palette colors in bus byte order, so each pixel is a single lookup */
+    for (uint16_t i = 0; i <= mask; i++) {
+        self->lookup[i] = (palette[i] >> 8) | (palette[i] << 8);
+    }
+
+    SetCursorPosition(self, x, y, x + sprite->width - 1, y + sprite->height - 1);
+    lcd_cmd_t lcd_write = {MEM_WRITE, 0, NULL};
+    WriteLCD(self, &lcd_write);
+
+    for (uint16_t row = 0; row < sprite->height; row++) {
+        const uint8_t * indexes = &sprite->data[row * stride];
+        for (uint32_t bit = 0; bit < sprite->width * bpp; bit += bpp) {
+            uint16_t * buffer = (uint16_t *)self->bounce[current];
+            buffer[fill++] = self->lookup[(indexes[bit / 8] >> (8 - bpp - (bit & 7))) & mask];
+            /* Send the full buffer and expand on the other one once its previous transaction is done */
+            if (fill == BLIT_CHUNK / 2) {
+                QueuePixels(self, (const uint8_t *)buffer, BLIT_CHUNK, &in_flight);
+                current ^= 1;
+                fill = 0;
+                if (in_flight == 2) {
+                    WaitPixels(self, &in_flight);
+                }
+            }
+        }
+    }
+    if (fill > 0) {
+        QueuePixels(self, (const uint8_t *)self->bounce[current], fill * 2, &in_flight);
+    }
+    while (in_flight > 0) {
+        WaitPixels(self, &in_flight);
+    }
+    PERFIL_FIN(PERFIL_SPRITE);
 }
 
 /* === End of documentation ==================================================================== */
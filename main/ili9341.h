@@ -24,11 +24,18 @@ SPDX-License-Identifier: MIT
 
 /** @file ili9341.h
  ** @brief Declaraciones de la biblioteca para el control pantallas TFT con controlador ILI9341
+ **
+ ** Each display is an instance created with @ref ILI9341Init from a configuration with its bus, pins and clock.
+ ** The bus is SPI or the 8 bits i80 parallel interface, both driven through the esp_lcd panel IO, which moves
+ ** eight times more bits per clock. Two displays can share a bus, with different CS pins, or use one bus each. Every
+ ** instance has its own transactions and DMA buffers, so displays on different buses can be drawn at the same time
+ ** from different tasks. A single display must be drawn from one task at a time.
  **/
 
 /* === Headers files inclusions ================================================================ */
 
 #include <stdint.h>
+#include "driver/spi_master.h"
 #include "fonts.h"
 
 /* === Cabecera C++ ============================================================================ */
@@ -52,6 +59,19 @@ extern "C" {
 
 #define ILI9341_BK_LIGHT_ON_LEVEL 1
 
+/*!< Maximum number of displays */
+#ifndef ILI9341_MAX_DISPLAYS
+#define ILI9341_MAX_DISPLAYS      2
+#endif
+
+/*!< Configuration of the display wired with the default pins */
+#define ILI9341_DEFAULT_CONFIG()                                                                                       \
+    {                                                                                                                  \
+        .bus = ILI9341_BUS_SPI, .host = ILI9341_SPI_PORT, .pin_miso = ILI9341_PIN_NUM_MISO,                            \
+        .pin_mosi = ILI9341_PIN_NUM_MOSI, .pin_clk = ILI9341_PIN_NUM_CLK, .pin_cs = ILI9341_PIN_NUM_CS,                \
+        .pin_dc = ILI9341_PIN_NUM_DC, .pin_rst = ILI9341_PIN_NUM_RST, .pin_bckl = ILI9341_PIN_NUM_BCKL, .clock_hz = 0, \
+    }
+
 /* LCD settings */
 #define ILI9341_WIDTH             240 /*!< LCD width in pixels */
 #define ILI9341_HEIGHT            320 /*!< LCD height in pixels */
@@ -84,6 +104,37 @@ extern "C" {
 
 /* === Public data type declarations =========================================================== */
 
+/**
+ * @brief  Reference to a display created with @ref ILI9341Init or @ref ILI9341Resume
+ */
+typedef struct ili9341_s * ili9341_t;
+
+/**
+ * @brief  Interfaces to the LCD controller
+ */
+typedef enum {
+    ILI9341_BUS_SPI = 0, /*!< 4 wires serial interface, one bit per clock */
+    ILI9341_BUS_I80,     /*!< 8 bits 8080 parallel interface, one byte per write strobe, RD must be tied high */
+} ili9341_bus_t;
+
+/**
+ * @brief  Bus, pins and clock of a display
+ */
+typedef struct {
+    ili9341_bus_t bus;      /*!< Interface used to send commands and pixels */
+    spi_host_device_t host; /*!< SPI host, initialized by the first display that uses it */
+    int8_t pin_miso;        /*!< MISO pin of the SPI bus, ignored if the host is already initialized */
+    int8_t pin_mosi;        /*!< MOSI pin of the SPI bus, ignored if the host is already initialized */
+    int8_t pin_clk;         /*!< Clock pin of the SPI bus, ignored if the host is already initialized */
+    int8_t pin_wr;          /*!< Write strobe pin of the i80 bus, ignored if the bus is already initialized */
+    int8_t pin_data[8];     /*!< D0 to D7 pins of the i80 bus, ignored if the bus is already initialized */
+    int8_t pin_cs;          /*!< Chip select pin, one for each display on the same bus */
+    int8_t pin_dc;          /*!< Data/command pin, shared by every display on the same i80 bus */
+    int8_t pin_rst;         /*!< Reset pin */
+    int8_t pin_bckl;        /*!< Backlight pin */
+    uint32_t clock_hz;      /*!< SPI clock or i80 write strobe frequency, zero for the default */
+} ili9341_config_t;
+
 /**
  * @brief  Possible orientations for LCD
  */
@@ -94,40 +145,154 @@ typedef enum {
     ILI9341_Landscape_2  /*!< Landscape orientation mode 2 */
 } ili9341_orientation_t;
 
+/**
+ * @brief  Bus traffic counters, accumulated since start up or the last @ref ILI9341ResetStats
+ */
+typedef struct {
+    uint32_t commands;              /*!< Command bytes sent (D/C low) */
+    uint32_t data_transactions;     /*!< Parameter or pixel transactions sent (D/C high) */
+    uint64_t bytes;                 /*!< Total bytes sent, commands included */
+    uint32_t window_sets;           /*!< Address window changes (column and page address set) */
+    uint32_t redundant_window_sets; /*!< Address window sets identical to the previous one */
+} ili9341_stats_t;
+
+/**
+ * @brief  Off-screen RGB565 image that the drawing primitives can target instead of the LCD
+ * @note   Pixels are stored in bus byte order (high byte first), so the buffer is sent as is by
+ *         @ref ILI9341BlitCanvas
+ */
+typedef struct {
+    uint16_t width;     /*!< Canvas width in pixels */
+    uint16_t height;    /*!< Canvas height in pixels */
+    uint16_t * pixels;  /*!< Caller supplied buffer with width * height pixels, row by row */
+} ili9341_canvas_t;
+
+/**
+ * @brief  Indexed color picture, the colors are given by a palette when it is drawn
+ */
+typedef struct {
+    uint16_t width;         /*!< Sprite width in pixels */
+    uint16_t height;        /*!< Sprite height in pixels */
+    uint8_t bpp;            /*!< Bits per pixel: 1, 2, 4 or 8 */
+    const uint8_t * data;   /*!< Palette indexes, each row starts on a new byte with its leftmost pixel in the most
+                                 significant bits */
+} ili9341_sprite_t;
+
 /* === Public variable declarations ============================================================ */
 
 /* === Public function declarations ============================================================ */
 
 /**
  * @brief  		Initializes ILI9341 LCD
+ * @param[in]  	config: Bus, pins and clock of the display
+ * @retval 		Display created, NULL if there are no free displays or no memory for its DMA buffers
+ */
+ili9341_t ILI9341Init(const ili9341_config_t * config);
+
+/**
+ * @brief  		Wakes up an ILI9341 LCD put to sleep with @ref ILI9341Sleep
+ * @param[in]  	config: Bus, pins and clock of the display, the same used before the sleep
+ * @note		The LCD is not reset nor cleared, so the frame memory content from before the sleep is shown again
+ * @retval 		Display created, NULL if there are no free displays or no memory for its DMA buffers
+ */
+ili9341_t ILI9341Resume(const ili9341_config_t * config);
+
+/**
+ * @brief  		Puts the LCD in sleep mode keeping its frame memory
+ * @param[in]  	self: Display
+ * @note		Control pins are held so the LCD is not reset while the MCU is in deep sleep
+ */
+void ILI9341Sleep(ili9341_t self);
+
+/**
+ * @brief  		Gets the clock frequency of the LCD bus
+ * @param[in]  	self: Display
+ * @retval 		Clock frequency in Hz, see @ref ILI9341GetBusWidth for the bits moved on each clock
  */
-void ILI9341Init(void);
+uint32_t ILI9341GetBusClock(ili9341_t self);
+
+/**
+ * @brief  		Gets the width of the LCD bus
+ * @param[in]  	self: Display
+ * @retval 		Bits moved per clock, 1 for SPI and 8 for i80
+ */
+uint8_t ILI9341GetBusWidth(ili9341_t self);
+
+/**
+ * @brief  		Gets the bus traffic counters
+ * @param[in]  	self: Display
+ * @param[out]	result: Where the counters are copied
+ * @note		The driver is not thread safe, the copy may be inconsistent if taken while another task draws
+ */
+void ILI9341GetStats(ili9341_t self, ili9341_stats_t * result);
+
+/**
+ * @brief  		Clears the bus traffic counters
+ * @param[in]  	self: Display
+ */
+void ILI9341ResetStats(ili9341_t self);
+
+/**
+ * @brief  		Prepares a canvas over a caller supplied buffer
+ * @param[out]	canvas: Canvas to prepare
+ * @param[in]  	buffer: Buffer with room for width * height pixels, it must be DMA capable (internal RAM,
+ *				for example declared with DMA_ATTR or allocated with MALLOC_CAP_DMA) to be blitted
+ * @param[in]  	width: Canvas width in pixels
+ * @param[in]  	height: Canvas height in pixels
+ * @retval 		None
+ */
+void ILI9341CanvasInit(ili9341_canvas_t * canvas, uint16_t * buffer, uint16_t width, uint16_t height);
+
+/**
+ * @brief  		Selects where the drawing primitives draw
+ * @param[in]  	self: Display
+ * @param[in]  	canvas: Canvas to draw on, with coordinates relative to its top left corner, or NULL to
+ *				draw on the LCD again
+ * @note		Drawings are clipped to the canvas, overlapping primitives cost memory writes only
+ * @retval 		None
+ */
+void ILI9341SetTarget(ili9341_t self, ili9341_canvas_t * canvas);
+
+/**
+ * @brief  		Sends a whole canvas to the LCD in a single address window
+ * @param[in]  	self: Display
+ * @param[in]  	canvas: Canvas to send, it can't be the selected target
+ * @param[in]  	x: X position of top left corner of canvas on the LCD
+ * @param[in]  	y: Y position of top left corner of canvas on the LCD
+ * @note		The canvas is sent with queued DMA transactions straight from its buffer
+ * @retval 		None
+ */
+void ILI9341BlitCanvas(ili9341_t self, const ili9341_canvas_t * canvas, uint16_t x, uint16_t y);
 
 /**
  * @brief  		Draws single pixel to LCD
+ * @param[in]  	self: Display
  * @param[in]  	x: X position for pixel
  * @param[in]  	y: Y position for pixel
  * @param[in]  	color: Color of pixel
  * @retval 		None
  */
-void ILI9341DrawPixel(uint16_t x, uint16_t y, uint16_t color);
+void ILI9341DrawPixel(ili9341_t self, uint16_t x, uint16_t y, uint16_t color);
 
 /**
  * @brief  		Fills entire LCD with color
+ * @param[in]  	self: Display
  * @param[in]	color: Color to be used in fill
  * @retval 		None
  */
-void ILI9341Fill(uint16_t color);
+void ILI9341Fill(ili9341_t self, uint16_t color);
 
 /**
  * @brief  		Rotates LCD to specific orientation
+ * @param[in]  	self: Display
  * @param[in]	orientation: LCD orientation
  * @retval 		None
  */
-void ILI9341Rotate(ili9341_orientation_t orientation);
+void ILI9341Rotate(ili9341_t self, ili9341_orientation_t orientation);
 
 /**
  * @brief  		Draw a single character on the LCD
+ * @param[in]  	self: Display
  * @param[in]  	x: X position of top left corner
  * @param[in]  	y: Y position of top left corner
  * @param[in] 	c: Character to be displayed
@@ -136,10 +301,12 @@ void ILI9341Rotate(ili9341_orientation_t orientation);
  * @param[in]  	background: Color for char background
  * @retval		None
  */
-void ILI9341DrawChar(uint16_t x, uint16_t y, char data, Font_t * font, uint16_t foreground, uint16_t background);
+void ILI9341DrawChar(ili9341_t self, uint16_t x, uint16_t y, char data, Font_t * font, uint16_t foreground,
+                     uint16_t background);
 
 /**
  * @brief  		Draw a string on the LCD
+ * @param[in]  	self: Display
  * @param[in] 	x: X position of top left corner of first character in string
  * @param[in]  	y: Y position of top left corner of first character in string
  * @param[in]  	str: Pointer to first character
@@ -148,7 +315,8 @@ void ILI9341DrawChar(uint16_t x, uint16_t y, char data, Font_t * font, uint16_t
  * @param[in]  	background: Color for string background
  * @retval 		None
  */
-void ILI9341DrawString(uint16_t x, uint16_t y, char * str, Font_t * font, uint16_t foreground, uint16_t background);
+void ILI9341DrawString(ili9341_t self, uint16_t x, uint16_t y, char * str, Font_t * font, uint16_t foreground,
+                       uint16_t background);
 
 /**
  * @brief  		Gets width and height of box with text
@@ -162,6 +330,7 @@ void ILI9341GetStringSize(char * str, Font_t * font, uint16_t * width, uint16_t
 
 /**
  * @brief  		Draws line on the LCD
+ * @param[in]  	self: Display
  * @param[in]  	x0: X coordinate of starting point
  * @param[in]  	y0: Y coordinate of starting point
  * @param[in]  	x1: X coordinate of ending point
@@ -169,10 +338,11 @@ void ILI9341GetStringSize(char * str, Font_t * font, uint16_t * width, uint16_t
  * @param[in]  	color: Line color
  * @retval[in] 	None
  */
-void ILI9341DrawLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color);
+void ILI9341DrawLine(ili9341_t self, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color);
 
 /**
  * @brief  		Draws rectangle on the LCD
+ * @param[in]  	self: Display
  * @param[in]  	x0: X coordinate of top left point
  * @param[in]  	y0: Y coordinate of top left point
  * @param[in]  	x1: X coordinate of bottom right point
@@ -180,10 +350,11 @@ void ILI9341DrawLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_
  * @param[in]  	color: Rectangle color
  * @retval 		None
  */
-void ILI9341DrawRectangle(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color);
+void ILI9341DrawRectangle(ili9341_t self, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color);
 
 /**
  * @brief  		Draws filled rectangle on the LCD
+ * @param[in]  	self: Display
  * @param[in]  	x0: X coordinate of top left point
  * @param[in]  	y0: Y coordinate of top left point
  * @param[in]  	x1: X coordinate of bottom right point
@@ -191,38 +362,75 @@ void ILI9341DrawRectangle(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, ui
  * @param[in]  	color: Rectangle color
  * @retval 		None
  */
-void ILI9341DrawFilledRectangle(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color);
+void ILI9341DrawFilledRectangle(ili9341_t self, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color);
 
 /**
  * @brief  		Draws circle on the LCD
+ * @param[in]  	self: Display
  * @param[in]  	x0: X coordinate of center circle point
  * @param[in]  	y0: Y coordinate of center circle point
  * @param[in]  	r: Circle radius
  * @param[in]  	color: Circle color
  * @retval 		None
  */
-void ILI9341DrawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color);
+void ILI9341DrawCircle(ili9341_t self, int16_t x0, int16_t y0, int16_t r, uint16_t color);
 
 /**
  * @brief  		Draws filled circle on the LCD
+ * @param[in]  	self: Display
  * @param[in]  	x0: X coordinate of center circle point
  * @param[in]  	y0: Y coordinate of center circle point
  * @param[in]  	r: Circle radius
  * @param[in]  	color: Circle color
  * @retval 		None
  */
-void ILI9341DrawFilledCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color);
+void ILI9341DrawFilledCircle(ili9341_t self, int16_t x0, int16_t y0, int16_t r, uint16_t color);
 
 /**
  * @brief  		Draw a picture on the LCD
+ * @param[in]  	self: Display
  * @param[in] 	x: X position of top left corner of picture
  * @param[in]  	y: Y position of top left corner of picture
  * @param[in] 	width: Picture width in pixels
  * @param[in]  	height: Picture height in pixels
  * @param[in]  	pic: Pointer to first byte of picture
+ * @note		Pictures in internal RAM are sent straight by the DMA. Pictures in flash are copied in the largest
+ *				slices a transaction allows into internal buffers, while the previous slice is on the bus
+ * @retval 		None
+ */
+void ILI9341DrawPicture(ili9341_t self, uint16_t x, uint16_t y, uint16_t width, uint16_t hieght, const uint8_t * pic);
+
+/**
+ * @brief  		Draw an indexed color sprite on the LCD
+ * @param[in]  	self: Display
+ * @param[in] 	x: X position of top left corner of sprite
+ * @param[in]  	y: Y position of top left corner of sprite
+ * @param[in]  	sprite: Sprite to draw, generated with tools/sprite565.py or by hand
+ * @param[in]  	palette: RGB565 color of each index, with 2 ^ bpp entries
+ * @note		The same sprite can be drawn with different palettes, the indexes are expanded through a lookup
+ *				table into the DMA buffers. Sprites with other than 1, 2, 4 or 8 bits per pixel are not drawn
+ * @retval 		None
+ */
+void ILI9341DrawSprite(ili9341_t self, uint16_t x, uint16_t y, const ili9341_sprite_t * sprite,
+                       const uint16_t * palette);
+
+/**
+ * @brief  		Draw a run length encoded picture on the LCD
+ * @param[in]  	self: Display
+ * @param[in] 	x: X position of top left corner of picture
+ * @param[in]  	y: Y position of top left corner of picture
+ * @param[in]  	image: Pointer to first byte of the encoded picture, generated with tools/rle565.py
+ * @note		Encoded format, multi byte values high byte first:
+ *				- Width and height in pixels, 16 bits each
+ *				- Palette size, 8 bits, zero means 256 colors
+ *				- Palette, RGB565 colors of 16 bits each
+ *				- Packets until width * height pixels are decoded. A header byte with bit 7 in one is a run of
+ *				  (header & 0x7F) + 1 pixels followed by one palette index. With bit 7 in zero it is followed by
+ *				  header + 1 palette indexes, one per pixel.
+ * @note		The picture is expanded into two DMA buffers that are sent while the other one is decoded
  * @retval 		None
  */
-void ILI9341DrawPicture(uint16_t x, uint16_t y, uint16_t width, uint16_t hieght, const uint8_t * pic);
+void ILI9341DrawRLEPicture(ili9341_t self, uint16_t x, uint16_t y, const uint8_t * image);
 
 /* === End of documentation ==================================================================== */
 
@@ -0,0 +1,164 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+/** @file indicadores.c
+ ** @brief Definiciones de los indicadores luminosos generados por el periférico LEDC
+ **
+ ** Los temporizadores usan el reloj REF_TICK de 1 MHz con 10 bits de resolución, lo que permite frecuencias desde
+ ** 1 Hz (divisor máximo) hasta 976 Hz. El parpadeo usa la frecuencia del patrón y el destello una frecuencia de PWM
+ ** suficientemente alta para que el desvanecimiento no se vea como parpadeo.
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include "indicadores.h"
+#include "driver/ledc.h"
+#include <stddef.h>
+
+/* === Macros definitions ========================================================================================== */
+
+#define MODO         LEDC_LOW_SPEED_MODE
+#define RESOLUCION   LEDC_TIMER_10_BIT
+#define CICLO_MAXIMO (1UL << RESOLUCION) //!< Ciclo de trabajo que mantiene la salida siempre en alto
+#define FRECUENCIA_PWM 500               //!< Frecuencia en Hz de la señal para los niveles de brillo intermedios
+
+/* === Private data type declarations ============================================================================== */
+
+//! @brief Estado de un indicador
+struct indicador_s {
+    ledc_channel_t canal;  //!< Canal del LEDC conectado al pin
+    ledc_timer_t timer;    //!< Temporizador del LEDC exclusivo del indicador
+    uint32_t frecuencia;   //!< Frecuencia actual del temporizador en Hz
+    bool desvaneciendo;    //!< Hay un desvanecimiento en curso que se debe detener antes de cambiar el patrón
+};
+
+/* === Private variable declarations =============================================================================== */
+
+/* === Private function declarations =============================================================================== */
+
+/**
+ * @brief Función que detiene un desvanecimiento en curso y ajusta la frecuencia del temporizador
+ *
+ * @param  self        Puntero al indicador
+ * @param  frecuencia  Frecuencia necesaria para el patrón nuevo en Hz
+ */
+static void Preparar(indicador_t self, uint32_t frecuencia);
+
+/**
+ * @brief Función que cambia el ciclo de trabajo del canal
+ *
+ * @param  self   Puntero al indicador
+ * @param  ciclo  Ciclo de trabajo entre cero y @ref CICLO_MAXIMO
+ */
+static void Aplicar(indicador_t self, uint32_t ciclo);
+
+/* === Public variable definitions ================================================================================= */
+
+/* === Private variable definitions ================================================================================ */
+
+//! @brief Indicadores disponibles
+static struct indicador_s instancias[INDICADORES_MAXIMO];
+
+//! @brief Cantidad de indicadores creados
+static uint8_t creados;
+
+/* === Private function definitions ================================================================================ */
+
+static void Preparar(indicador_t self, uint32_t frecuencia) {
+    if (self->desvaneciendo) {
+        ledc_fade_stop(MODO, self->canal);
+        self->desvaneciendo = false;
+    }
+    if (self->frecuencia != frecuencia) {
+        ledc_set_freq(MODO, self->timer, frecuencia);
+        self->frecuencia = frecuencia;
+    }
+}
+
+static void Aplicar(indicador_t self, uint32_t ciclo) {
+    ledc_set_duty(MODO, self->canal, ciclo);
+    ledc_update_duty(MODO, self->canal);
+}
+
+/* === Public function implementation ============================================================================== */
+
+indicador_t IndicadorCrear(uint8_t gpio) {
+    if (creados >= INDICADORES_MAXIMO) {
+        return NULL;
+    }
+    if (creados == 0 && ledc_fade_func_install(0) != ESP_OK) {
+        return NULL;
+    }
+
+    indicador_t self = &instancias[creados];
+    self->canal = (ledc_channel_t)creados;
+    self->timer = (ledc_timer_t)creados;
+    self->frecuencia = FRECUENCIA_PWM;
+
+    const ledc_timer_config_t temporizador = {
+        .speed_mode = MODO,
+        .duty_resolution = RESOLUCION,
+        .timer_num = self->timer,
+        .freq_hz = FRECUENCIA_PWM,
+        .clk_cfg = LEDC_USE_REF_TICK,
+    };
+    const ledc_channel_config_t canal = {
+        .gpio_num = gpio,
+        .speed_mode = MODO,
+        .channel = self->canal,
+        .intr_type = LEDC_INTR_DISABLE,
+        .timer_sel = self->timer,
+        .duty = 0,
+        .hpoint = 0,
+    };
+    if (ledc_timer_config(&temporizador) != ESP_OK || ledc_channel_config(&canal) != ESP_OK) {
+        return NULL;
+    }
+    creados++;
+    return self;
+}
+
+void IndicadorApagar(indicador_t self) {
+    Preparar(self, self->frecuencia);
+    Aplicar(self, 0);
+}
+
+void IndicadorEncender(indicador_t self) {
+    Preparar(self, self->frecuencia);
+    Aplicar(self, CICLO_MAXIMO);
+}
+
+void IndicadorParpadear(indicador_t self, uint16_t periodo_ms, uint8_t encendido) {
+    uint32_t frecuencia = (periodo_ms == 0 || periodo_ms >= 1000) ? 1 : (1000 + periodo_ms / 2) / periodo_ms;
+
+    Preparar(self, frecuencia);
+    Aplicar(self, (CICLO_MAXIMO * encendido) / 100);
+    /* Reiniciar el contador alinea la fase con la de los otros indicadores configurados al mismo tiempo */
+    ledc_timer_rst(MODO, self->timer);
+}
+
+void IndicadorDestellar(indicador_t self, uint16_t duracion_ms) {
+    Preparar(self, FRECUENCIA_PWM);
+    Aplicar(self, CICLO_MAXIMO);
+    ledc_set_fade_with_time(MODO, self->canal, 0, duracion_ms);
+    ledc_fade_start(MODO, self->canal, LEDC_FADE_NO_WAIT);
+    self->desvaneciendo = true;
+}
+
+/* === End of documentation ======================================================================================== */
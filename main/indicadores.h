@@ -0,0 +1,111 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+#ifndef INDICADORES_H_
+#define INDICADORES_H_
+
+/** @file indicadores.h
+ ** @brief Declaraciones de los indicadores luminosos generados por el periférico LEDC
+ **
+ ** Cada indicador es un LED conectado a un canal del periférico LEDC con su propio temporizador. Los patrones se
+ ** generan completamente por hardware: el parpadeo es una señal PWM de baja frecuencia y el destello es un
+ ** desvanecimiento automático desde el brillo máximo. Después de configurar un patrón el procesador no interviene
+ ** hasta que se pide el siguiente, por lo que solo hay que llamar a estas funciones cuando cambia el estado a mostrar.
+ **
+ ** Las funciones no son reentrantes, el llamador debe serializar el acceso a cada indicador.
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* === Cabecera C++ ================================================================================================ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* === Public macros definitions =================================================================================== */
+
+//! @brief Cantidad máxima de indicadores, cada uno usa un temporizador del LEDC (hay cuatro)
+#ifndef INDICADORES_MAXIMO
+#define INDICADORES_MAXIMO 4
+#endif
+
+/* === Public data type declarations =============================================================================== */
+
+//! @brief Tipo de dato para referenciar a un indicador
+typedef struct indicador_s * indicador_t;
+
+/* === Public variable declarations ================================================================================ */
+
+/* === Public function declarations ================================================================================ */
+
+/**
+ * @brief Función que crea un indicador apagado en un pin
+ *
+ * @param  gpio         Número de pin del LED, se enciende con nivel alto
+ * @return indicador_t  Puntero al indicador creado o NULL si no quedan canales o temporizadores libres
+ */
+indicador_t IndicadorCrear(uint8_t gpio);
+
+/**
+ * @brief Función que apaga un indicador
+ *
+ * @param  self  Puntero al indicador creado con @ref IndicadorCrear
+ */
+void IndicadorApagar(indicador_t self);
+
+/**
+ * @brief Función que enciende un indicador con luz fija
+ *
+ * @param  self  Puntero al indicador creado con @ref IndicadorCrear
+ */
+void IndicadorEncender(indicador_t self);
+
+/**
+ * @brief Función que hace parpadear un indicador
+ *
+ * La frecuencia del parpadeo se redondea a un número entero de hercios, por lo que el período debe estar entre 1 y
+ * 1000 milisegundos. Dos indicadores que se configuran seguidos parpadean en fase.
+ *
+ * @param  self        Puntero al indicador creado con @ref IndicadorCrear
+ * @param  periodo_ms  Período completo del parpadeo (encendido y apagado) en milisegundos
+ * @param  encendido   Fracción del período que el indicador está encendido, en porcentaje
+ */
+void IndicadorParpadear(indicador_t self, uint16_t periodo_ms, uint8_t encendido);
+
+/**
+ * @brief Función que enciende un indicador al máximo y lo apaga gradualmente
+ *
+ * Al terminar el desvanecimiento el indicador queda apagado.
+ *
+ * @param  self         Puntero al indicador creado con @ref IndicadorCrear
+ * @param  duracion_ms  Duración del desvanecimiento en milisegundos
+ */
+void IndicadorDestellar(indicador_t self, uint16_t duracion_ms);
+
+/* === End of documentation ======================================================================================== */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INDICADORES_H_ */
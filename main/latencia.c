@@ -0,0 +1,197 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+/** @file latencia.c
+ ** @brief Definiciones de la medición de latencia desde un botón hasta la pantalla
+ **
+ ** Un valor menor a 16 us tiene su propio casillero. Un valor mayor, cuyo bit más significativo es el e, se guarda en
+ ** el casillero de su potencia de dos según los cuatro bits que siguen al más significativo.
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include "latencia.h"
+#include <stdbool.h>
+#include <string.h>
+
+#ifdef ESP_PLATFORM
+#include "freertos/FreeRTOS.h"
+#endif
+
+/* === Macros definitions ========================================================================================== */
+
+#define SUBDIVISIONES  16 //!< Casilleros por potencia de dos
+#define BITS_SUB       4  //!< Bits de la subdivisión
+#define EXPONENTE_MAX  31 //!< Los valores se limitan a 32 bits (más de una hora)
+#define CASILLEROS     (SUBDIVISIONES + (EXPONENTE_MAX - BITS_SUB + 1) * SUBDIVISIONES)
+
+/* === Private data type declarations ============================================================================== */
+
+//! @brief Histograma de latencias de una etapa
+struct histograma_s {
+    uint32_t casilleros[CASILLEROS];
+    uint64_t maximo;
+};
+
+/* === Private variable declarations =============================================================================== */
+
+/* === Private function declarations =============================================================================== */
+
+/**
+ * @brief Función que calcula el casillero de un valor
+ *
+ * @param  valor     Valor en microsegundos
+ * @return uint16_t  Índice del casillero
+ */
+static uint16_t Casillero(uint32_t valor);
+
+/**
+ * @brief Función que calcula el mayor valor que corresponde a un casillero
+ *
+ * @param  casillero Índice del casillero
+ * @return uint64_t  Límite superior del casillero en microsegundos
+ */
+static uint64_t LimiteSuperior(uint16_t casillero);
+
+/**
+ * @brief Función que agrega la traza completa a los histogramas
+ */
+static void Agregar(void);
+
+/* === Public variable definitions ================================================================================= */
+
+/* === Private variable definitions ================================================================================ */
+
+//! @brief Histogramas de las etapas, el de la etapa del flanco no se usa
+static struct histograma_s histogramas[LATENCIA_ETAPAS];
+
+//! @brief Instantes de la traza en curso
+static uint64_t marcas[LATENCIA_ETAPAS];
+
+//! @brief Última etapa marcada en la traza en curso, @ref LATENCIA_ETAPAS si no hay una traza en curso
+static uint8_t ultima = LATENCIA_ETAPAS;
+
+//! @brief Cantidad de trazas completas
+static uint32_t cantidad;
+
+#ifdef ESP_PLATFORM
+//! @brief Protege la traza, que marcan el lazo de control (controlTask) y la tarea de la pantalla
+static portMUX_TYPE cerrojo = portMUX_INITIALIZER_UNLOCKED;
+#define BLOQUEAR()    portENTER_CRITICAL(&cerrojo)
+#define DESBLOQUEAR() portEXIT_CRITICAL(&cerrojo)
+#else
+#define BLOQUEAR()
+#define DESBLOQUEAR()
+#endif
+
+/* === Private function definitions ================================================================================ */
+
+static uint16_t Casillero(uint32_t valor) {
+    if (valor < SUBDIVISIONES) {
+        return valor;
+    }
+    uint8_t exponente = 31 - __builtin_clz(valor);
+    uint8_t sub = (valor >> (exponente - BITS_SUB)) & (SUBDIVISIONES - 1);
+    return SUBDIVISIONES + (exponente - BITS_SUB) * SUBDIVISIONES + sub;
+}
+
+static uint64_t LimiteSuperior(uint16_t casillero) {
+    if (casillero < SUBDIVISIONES) {
+        return casillero;
+    }
+    uint8_t exponente = (casillero - SUBDIVISIONES) / SUBDIVISIONES + BITS_SUB;
+    uint8_t sub = (casillero - SUBDIVISIONES) % SUBDIVISIONES;
+    uint64_t base = (uint64_t)(SUBDIVISIONES + sub) << (exponente - BITS_SUB);
+    return base + (1ULL << (exponente - BITS_SUB)) - 1;
+}
+
+static void Agregar(void) {
+    for (int etapa = LATENCIA_BOTON; etapa < LATENCIA_ETAPAS; etapa++) {
+        uint64_t valor = marcas[etapa] - marcas[LATENCIA_FLANCO];
+        histogramas[etapa].casilleros[Casillero(valor > UINT32_MAX ? UINT32_MAX : valor)]++;
+        if (valor > histogramas[etapa].maximo) {
+            histogramas[etapa].maximo = valor;
+        }
+    }
+    cantidad++;
+}
+
+/* === Public function implementation ============================================================================== */
+
+void LatenciaIniciar(uint64_t flanco_us) {
+    BLOQUEAR();
+    marcas[LATENCIA_FLANCO] = flanco_us;
+    ultima = LATENCIA_FLANCO;
+    DESBLOQUEAR();
+}
+
+void LatenciaMarcar(latencia_etapa_t etapa, uint64_t instante_us) {
+    BLOQUEAR();
+    if ((ultima < LATENCIA_ETAPAS) && ((int)etapa == ultima + 1)) {
+        /* Un instante anterior al de la etapa previa solo puede venir de relojes distintos, se lo iguala */
+        marcas[etapa] = (instante_us < marcas[ultima]) ? marcas[ultima] : instante_us;
+        ultima = etapa;
+        if (etapa == LATENCIA_PIXEL) {
+            Agregar();
+            ultima = LATENCIA_ETAPAS;
+        }
+    }
+    DESBLOQUEAR();
+}
+
+uint64_t LatenciaPercentil(latencia_etapa_t etapa, uint32_t milesimas) {
+    uint64_t resultado = 0;
+
+    BLOQUEAR();
+    if (cantidad > 0) {
+        /* Cantidad de mediciones que deben quedar en o por debajo del percentil, redondeando hacia arriba */
+        uint32_t objetivo = ((uint64_t)cantidad * milesimas + 999) / 1000;
+        uint32_t acumulado = 0;
+        for (uint16_t casillero = 0; casillero < CASILLEROS; casillero++) {
+            acumulado += histogramas[etapa].casilleros[casillero];
+            if (acumulado >= objetivo && acumulado > 0) {
+                resultado = LimiteSuperior(casillero);
+                break;
+            }
+        }
+        if (resultado > histogramas[etapa].maximo) {
+            resultado = histogramas[etapa].maximo;
+        }
+    }
+    DESBLOQUEAR();
+    return resultado;
+}
+
+uint64_t LatenciaMaximo(latencia_etapa_t etapa) {
+    return histogramas[etapa].maximo;
+}
+
+uint32_t LatenciaCantidad(void) {
+    return cantidad;
+}
+
+void LatenciaReiniciar(void) {
+    BLOQUEAR();
+    memset(histogramas, 0, sizeof(histogramas));
+    cantidad = 0;
+    ultima = LATENCIA_ETAPAS;
+    DESBLOQUEAR();
+}
+
+/* === End of documentation ======================================================================================== */
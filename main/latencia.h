@@ -0,0 +1,118 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+#ifndef LATENCIA_H_
+#define LATENCIA_H_
+
+/** @file latencia.h
+ ** @brief Declaraciones de la medición de latencia desde un botón hasta la pantalla
+ **
+ ** Cada evento de un botón inicia una traza que registra el instante en que pasa por cada etapa del camino hasta la
+ ** pantalla. Al completarse la última etapa se agrega el tiempo transcurrido desde el flanco hasta cada etapa a un
+ ** histograma logarítmico-lineal por etapa, con 16 subdivisiones por potencia de dos (error relativo menor al 7%),
+ ** del que se obtienen percentiles sin guardar las mediciones individuales.
+ **
+ ** Hay una sola traza en curso: un evento nuevo descarta la traza anterior si no se completó. Las etapas se deben
+ ** marcar en orden, una marca fuera de orden o repetida se ignora. Los instantes los indica el llamador, asi el
+ ** módulo no depende del reloj del ESP32 y se puede usar en un simulador en la computadora de desarrollo.
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include <stdint.h>
+
+/* === Cabecera C++ ================================================================================================ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* === Public macros definitions =================================================================================== */
+
+/* === Public data type declarations =============================================================================== */
+
+//! @brief Etapas del camino desde un botón hasta la pantalla, en orden
+typedef enum {
+    LATENCIA_FLANCO,   //!< Cambio de nivel del pulsador
+    LATENCIA_BOTON,    //!< Fin del antirrebote, el evento se confirma
+    LATENCIA_ESTADO,   //!< controlTask actualizó el estado del cronómetro, con xMutexEstado tomado
+    LATENCIA_LECTURA,  //!< La tarea de pantalla leyó el estado nuevo
+    LATENCIA_PANTALLA, //!< La tarea de pantalla obtuvo el acceso a la pantalla
+    LATENCIA_PIXEL,    //!< Terminó la transferencia del primer dígito redibujado
+    LATENCIA_ETAPAS,   //!< Cantidad de etapas
+} latencia_etapa_t;
+
+/* === Public variable declarations ================================================================================ */
+
+/* === Public function declarations ================================================================================ */
+
+/**
+ * @brief Función que inicia una traza nueva, descartando la traza en curso
+ *
+ * @param  flanco_us  Instante del flanco del pulsador en microsegundos
+ */
+void LatenciaIniciar(uint64_t flanco_us);
+
+/**
+ * @brief Función que registra el paso de la traza en curso por una etapa
+ *
+ * Solo tiene efecto si la etapa anterior ya fue marcada y esta todavía no. Al marcar @ref LATENCIA_PIXEL la traza se
+ * completa y se agrega a los histogramas.
+ *
+ * @param  etapa       Etapa alcanzada
+ * @param  instante_us Instante en microsegundos, con la misma referencia que el flanco
+ */
+void LatenciaMarcar(latencia_etapa_t etapa, uint64_t instante_us);
+
+/**
+ * @brief Función que devuelve un percentil del tiempo desde el flanco hasta una etapa
+ *
+ * @param  etapa      Etapa, entre @ref LATENCIA_BOTON y @ref LATENCIA_PIXEL
+ * @param  milesimas  Percentil en milésimas, por ejemplo 500 para la mediana y 990 para el percentil 99
+ * @return uint64_t   Latencia en microsegundos (límite superior del casillero), cero si no hay mediciones
+ */
+uint64_t LatenciaPercentil(latencia_etapa_t etapa, uint32_t milesimas);
+
+/**
+ * @brief Función que devuelve la mayor latencia medida hasta una etapa
+ *
+ * @param  etapa      Etapa, entre @ref LATENCIA_BOTON y @ref LATENCIA_PIXEL
+ * @return uint64_t   Latencia máxima en microsegundos
+ */
+uint64_t LatenciaMaximo(latencia_etapa_t etapa);
+
+/**
+ * @brief Función que devuelve la cantidad de trazas completas
+ *
+ * @return uint32_t  Cantidad de trazas agregadas a los histogramas
+ */
+uint32_t LatenciaCantidad(void);
+
+/**
+ * @brief Función que descarta todas las mediciones y la traza en curso
+ */
+void LatenciaReiniciar(void);
+
+/* === End of documentation ======================================================================================== */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LATENCIA_H_ */
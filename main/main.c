@@ -1,17 +1,41 @@
 #include <stdio.h>
  #include <stdbool.h>
  #include <inttypes.h> // Para PRId32
+ #include <stdlib.h>   // Para llabs
+ #include <string.h>   // Para memset
+#include <stdatomic.h> // Índices de los cortes de las barreras compartidos con su interrupción
  #include "freertos/FreeRTOS.h"
  #include "freertos/task.h"
  #include "freertos/semphr.h" // Para Mutex
- #include "freertos/timers.h" // Para Software Timers
+#include "freertos/queue.h"  // Cola de eventos del lazo de control
  #include "driver/gpio.h"
+#include "soc/gpio_reg.h" // Registros de entrada de los GPIO, se leen de una sola vez
+#include "soc/soc.h"
+ #include "driver/rtc_io.h" // Para el pull-up del pin de despertar durante el sueño profundo
  #include "esp_log.h"
+ #include "esp_sleep.h"
+ #include "esp_timer.h"  // Para medir la duración de los cuadros
+ #include "esp_system.h" // Para esp_reset_reason
  #include "sdkconfig.h" // Para leer la configuración de menuconfig
 
  // Incluir las cabeceras de las librerías
  #include "ili9341.h"
  #include "digitos.h" // Asume que este archivo existe y define Panel_t, CrearPanel, DibujarDigito, etc.
+#include "escena.h"     // Elementos de la pantalla que se redibujan solo cuando cambian
+#include "contador.h"   // Dígitos del tiempo que avanzan con acarreo, sin divisiones
+ #include "cronometro.h" // Estado del cronómetro conservado en la memoria RTC
+ #include "vueltas.h"    // Registro de tiempos de vuelta
+ #include "registro.h"   // Registro persistente de eventos en la memoria flash
+ #include "temporizadores.h" // Temporizadores de cuenta regresiva sobre una rueda jerárquica
+ #include "consola.h"    // Comandos por el puerto serie para consultar estadísticas
+ #include "perfil.h"     // Zonas de perfilado de las primitivas de dibujo
+#include "latencia.h"   // Latencia desde los botones hasta la pantalla
+#include "monitor.h"    // Uso de procesador y de pila de las tareas
+#include "bitacora.h"   // Bitácora de eventos sin bloqueos para las secciones críticas
+#include "indicadores.h" // LEDs con patrones generados por el periférico LEDC
+#include "antirrebote.h" // Antirrebote en paralelo de todas las entradas
+#include "barreras.h"    // Barreras de luz con el instante del corte capturado por hardware
+#include "calibracion.h" // Deriva del reloj local medida contra un pulso de referencia
 
  // Parámetros de dibujo de dígitos
  #define DIGITO_ANCHO     60
@@ -41,6 +65,53 @@
 #define SEP_Y_DEC    (PANEL_Y + DIGITO_ALTO / 2)     // Y para el punto decimal '.'
 #define SEP_RADIUS   5                               // Radio de los círculos separadores
 
+// Formatos del tiempo en pantalla
+#define FORMAT_MM_SS_D   0 // Minutos, segundos y décimas
+#define FORMAT_MM_SS_CC  1 // Minutos, segundos y centésimas
+#define FORMAT_SS_MMM    2 // Segundos y milésimas (los segundos vuelven a cero cada 100 s)
+
+#ifndef DISPLAY_FORMAT
+#define DISPLAY_FORMAT   FORMAT_MM_SS_CC
+#endif
+
+#if DISPLAY_FORMAT == FORMAT_SS_MMM
+#define FRACTION_DIGITS  3
+#define FRACTION_UNIT_US 1000
+#define SECONDS_X        (PANEL_MIN_X + OFFSET_X)          // Los segundos ocupan el lugar de los minutos
+#define FRACTION_X       (PANEL_SEC_X + OFFSET_X - DIGITO_ANCHO) // Termina en el borde derecho de los paneles
+#define DISPLAY_DIGITS   (2 + FRACTION_DIGITS)
+#define DISPLAY_BASES    {10, 10, 10, 10, 10}
+#elif DISPLAY_FORMAT == FORMAT_MM_SS_CC
+#define FRACTION_DIGITS  2
+#define FRACTION_UNIT_US 10000
+#define SECONDS_X        (PANEL_SEC_X + OFFSET_X)
+#define FRACTION_X       (PANEL_DEC_X + OFFSET_X)
+#define DISPLAY_DIGITS   (4 + FRACTION_DIGITS)
+#define DISPLAY_BASES    {10, 10, 6, 10, 10, 10}
+#else
+#define FRACTION_DIGITS  1
+#define FRACTION_UNIT_US 100000
+#define SECONDS_X        (PANEL_SEC_X + OFFSET_X)
+#define FRACTION_X       (PANEL_DEC_X + OFFSET_X)
+#define DISPLAY_DIGITS   (4 + FRACTION_DIGITS)
+#define DISPLAY_BASES    {10, 10, 6, 10, 10}
+#endif
+
+// Línea con la última vuelta registrada (debajo de los paneles)
+#define LAP_X        (PANEL_MIN_X + OFFSET_X)
+#define LAP_Y        218
+#define LAP_FONT     font_11x18
+
+// Indicadores de canal (columna a la derecha de los paneles): uno por canal, encendido si está corriendo y a media
+// intensidad si está detenido con tiempo acumulado
+#define CH_X         305
+#define CH_Y0        12
+#define CH_SIZE      10
+#define CH_STEP      ((210 - CH_Y0) / CRONOMETRO_CANALES)
+#define CH_BOX       (CH_SIZE + 5) // Lado del indicador con su marco
+#define CH_SELECTED  ILI9341_WHITE // Color del marco del canal seleccionado
+#define CH_PAUSED    0x7800        // Color del cuadrado de un canal detenido que no está en cero
+
  // --- Configuración ---
  #define TAG "CRONOMETRO"
 
@@ -51,289 +122,797 @@
 
  // Definición de pines para botones (configurados con pull-up)
  #define PB_Reset   GPIO_NUM_13
- //#define PB_Freeze  GPIO_NUM_12
+ #define PB_Lap     GPIO_NUM_12 // Registra una vuelta (antes PB_Freeze)
  #define PB_Run_Stop  GPIO_NUM_14
+ #define PB_Canal   GPIO_NUM_33 // Selecciona el canal siguiente
+
+// Barreras de luz (receptores con salida activa, los GPIO 34 a 39 no tienen pull-up interno)
+#define GATE_START_PIN   GPIO_NUM_34 // Barrera de largada
+#define GATE_FINISH_PIN  GPIO_NUM_35 // Barrera de llegada
+#define GATE_CHANNEL     0           // Canal del cronómetro que controlan las barreras
+#define GATE_EDGES       BARRERA_BAJADA // La salida del receptor pasa a nivel bajo al cortarse el haz
+
+// Pulso de referencia para calibrar la deriva del cristal (salida 1PPS de un receptor GPS), flanco de subida
+#define PPS_PIN          GPIO_NUM_36
 
 // Tiempos
 #define DEBOUNCE_TIME_MS       50  // Tiempo (ms) para estabilización del botón
+#define DEBOUNCE_SAMPLE_MS     (DEBOUNCE_TIME_MS / ANTIRREBOTE_MUESTRAS) // Periodo de muestreo mientras hay rebotes
 #define BLINK_PERIOD_MS        500 // Periodo total (ON+OFF) del parpadeo del LED verde
-#define TIMER_PERIOD_MS        100 // Periodo (ms) para incrementar décimas (0.1s resol.)
+#define FRAME_RATE_HZ          60   // Cuadros por segundo pedidos al renderizador de la pantalla
+// El periodo se trunca a ticks enteros (16 ms con CONFIG_FREERTOS_HZ=1000, 62.5 cuadros por segundo) y el periodo en
+// microsegundos se obtiene de los ticks, así los cuadros perdidos y el adelanto de la proyección usan el mismo valor
+#define FRAME_PERIOD_TICKS     (configTICK_RATE_HZ / FRAME_RATE_HZ)
+#define FRAME_PERIOD_US        (FRAME_PERIOD_TICKS * 1000000 / configTICK_RATE_HZ) // Mayor adelanto de la proyección
+#define FRAME_BUDGET_US        12000 // Tiempo máximo de bus (us) para dibujar dígitos en cada cuadro
+#define STATS_LOG_MS           10000 // Periodo (ms) del informe de cuadros por segundo
+#define SEGMENT_US_INITIAL     400  // Estimación inicial (us) del tiempo de bus de un segmento, luego se mide
+#define SLEEP_HOLD_MS          3000 // Tiempo (ms) que se mantiene Reset presionado para entrar en sueño profundo
+#define LOG_COMMIT_MS          1000 // Periodo (ms) de escritura de los eventos pendientes en la memoria flash
+#define LOG_PARTITION          "vueltas" // Partición de datos del registro (ver partitions.csv)
+#define REST_TIME_MS           30000 // Descanso (ms) que se cuenta en cada canal después de registrar una vuelta
+#define ALARM_BLINK_MS         2000 // Tiempo (ms) que parpadean ambos LEDs al terminar un descanso
+#define ALARM_PERIOD_MS        100  // Periodo total (ON+OFF) del parpadeo de alarma
+#define LAP_FLASH_MS           300  // Duración del destello del LED rojo al registrar una vuelta
+#define GATE_LOCKOUT_MS        300  // Tiempo (ms) que una barrera ignora los cortes del mismo corredor (brazos)
+
+// Conversión de milisegundos a tics de la rueda de temporizadores
+#define MS_TO_WHEEL(ms)        ((uint32_t)((ms) * 1000ULL / TEMPORIZADORES_RESOLUCION_US))
 
 // Prioridades y Stack (Ajustar si es necesario)
 #define TASK_PRIORITY_HIGH     5
 #define TASK_PRIORITY_MEDIUM   4
 #define TASK_PRIORITY_LOW      3
+#define TASK_PRIORITY_IDLE     1    // Tareas de fondo (escritura en flash)
 #define TASK_STACK_SIZE_MEDIUM 2048 // Stack para tareas de lógica simple
 #define TASK_STACK_SIZE_LARGE  4096 // Stack mayor para tareas con más lógica o librerías (display)
 
 
-// --- Variables Globales para la Pantalla (Punteros a los paneles de dígitos) ---
-panel_t  panel_minutes = NULL;
-panel_t  panel_seconds = NULL;
-panel_t  panel_decimas = NULL;
+// --- Variables Globales para la Pantalla (Escena y sus elementos, solo los usa displayTask) ---
+static escena_t scene = NULL;
+static elemento_t lap_list = NULL;     // Línea con la última vuelta registrada
+static elemento_t rest_label = NULL;   // Aviso de fin de descanso, ocupa el lugar de la línea de vueltas
+static elemento_t channel_markers[CRONOMETRO_CANALES];
+
+// Registro de vueltas de cada canal: lo escribe controlTask (bajo xMutexEstado) y lo lee displayTask sin bloqueos
+vueltas_t lap_logs[CRONOMETRO_CANALES];
+
+// Registro persistente: los eventos se encolan bajo xMutexEstado y registroTask los escribe en lotes
+registro_t event_log = NULL;
+uint32_t session_id = 0; // Sesión actual, se incrementa con cada reset
 
 // --- Variables Globales Compartidas ---
 // volatile: indica al compilador que la variable puede cambiar externamente (otra tarea, timer)
-volatile uint32_t decimas = 0;                  // Contador principal en décimas de segundo
-volatile bool isRunning = false;                // Estado actual del cronómetro (corriendo/detenido)
+// El tiempo y el estado corriendo/detenido se guardan en cronometro.c (memoria RTC)
 volatile bool resetPressedWhileStopped = false; // Flag para indicar solicitud de reset Si esta en Stop
-
-// Guardo los digitos de la pantalla
-// Vector estático para almacenar los últimos dígitos dibujados
-static uint8_t Digitos_Visualizados[] = { -1, -1, -1, -1, -1 };
+volatile uint8_t resetChannel = 0;              // Canal a resetear cuando resetPressedWhileStopped está activo
+volatile uint8_t selectedChannel = 0;           // Canal sobre el que actúan los botones y que se muestra
+
+// Eventos del lazo de control. Los temporizadores publican el tipo y el argumento codificados en su contexto
+typedef enum {
+    EV_EDGE,     // Flanco en un botón (interrupción), arg = botón
+    EV_SAMPLE,   // Muestreo periódico de las entradas mientras alguna no está estable
+    EV_HOLD,     // Reset se mantuvo presionado SLEEP_HOLD_MS
+    EV_ALARM_END, // Terminó el parpadeo de alarma de los LEDs
+    EV_REST,     // Terminó el descanso de un canal, arg = canal
+    EV_GATE,     // Corte de una barrera de luz, arg = barrera, el instante queda en gate_cuts
+    EV_PPS,      // Pulso de referencia durante la calibración, at_us = instante de la interrupción
+} control_event_type_t;
+
+typedef struct {
+    uint8_t type;  // Uno de los valores de control_event_type_t
+    uint8_t arg;   // Botón o canal según el tipo
+    int64_t at_us; // Instante en que se produjo el evento
+} control_event_t;
+
+#define TIMER_EVENT(type, arg) ((void *)(uintptr_t)(((type) << 8) | (arg))) // Contexto de post_timer_event
+#define CONTROL_QUEUE_LENGTH   16
+#define TIMER_RETRY_MS         5 // Espera antes de volver a publicar un vencimiento que no entró en la cola
+
+// Botones, en el orden de button_pins
+enum { BTN_RUN_STOP, BTN_RESET, BTN_LAP, BTN_CHANNEL, BTN_COUNT };
+static const gpio_num_t button_pins[BTN_COUNT] = {PB_Run_Stop, PB_Reset, PB_Lap, PB_Canal};
+
+// Barreras de luz y la acción que realiza cada una sobre su canal, sin importar el canal seleccionado
+enum { GATE_START, GATE_STOP, GATE_LAP };
+static const struct {
+    gpio_num_t pin;
+    uint8_t channel;
+    uint8_t action; // Arranca el canal si está detenido, lo detiene o registra una vuelta si está corriendo
+} gate_config[] = {
+    {GATE_START_PIN, GATE_CHANNEL, GATE_START},
+    {GATE_FINISH_PIN, GATE_CHANNEL, GATE_STOP},
+};
+#define GATE_COUNT ((int)(sizeof(gate_config) / sizeof(gate_config[0])))
+_Static_assert(GATE_COUNT <= BARRERAS_MAXIMO, "No hay canales de captura para todas las barreras");
+
+// Cortes de cada barrera que esperan al lazo de control. La interrupción solo avanza head y el lazo solo avanza tail,
+// asi no hacen falta bloqueos; una ráfaga de flancos de los botones que llena la cola no puede desplazar un corte
+#define GATE_BUFFER 8 // Potencia de dos
+static struct {
+    int64_t cut_us[GATE_BUFFER]; // Instantes capturados por hardware
+    atomic_uint head;            // Cortes escritos por la interrupción
+    atomic_uint tail;            // Cortes leídos por el lazo de control
+    atomic_uint lost;            // Cortes descartados por tener el buffer lleno
+} gate_cuts[GATE_COUNT];
+static barrera_t gates[GATE_COUNT];         // Barreras creadas, NULL si no se pudo configurar
+static uint32_t gate_lost_logged[GATE_COUNT]; // Cortes perdidos ya informados en la bitácora
+
+// Antirrebote de las entradas: un grupo por registro de entrada (GPIO 0 a 31 y GPIO 32 a 39). Solo lo usa
+// controlTask, que muestrea los registros completos mientras alguna entrada está rebotando
+#define INPUT_REGISTERS 2
+static antirrebote_t input_groups[INPUT_REGISTERS];
+static int64_t first_edge_us[BTN_COUNT]; // Instante del primer flanco de cada botón (traza de latencia)
+static bool edges_enabled = true;         // Las interrupciones de todos los botones están habilitadas
+static temporizador_t sample_timer;       // Muestreo periódico durante los rebotes
+
+QueueHandle_t control_queue = NULL; // Eventos para controlTask
+temporizador_t hold_timer;          // Pulsación larga de Reset
+temporizador_t alarm_timer;         // Fin del parpadeo de alarma
+indicador_t green_led;              // LED verde: parpadea con el canal seleccionado corriendo
+indicador_t red_led;                // LED rojo: fijo con el canal seleccionado detenido
+
+// Temporizador de descanso de cada canal: se arma al registrar una vuelta y al vencer controlTask avisa a la
+// pantalla con una notificación que tiene en uno el bit del canal
+temporizador_t rest_timers[CRONOMETRO_CANALES];
+TaskHandle_t display_task = NULL;
+#define NOTIFY_REDRAW (1UL << 31) // Notificación a displayTask para redibujar la pantalla completa
+_Static_assert(CRONOMETRO_CANALES <= 31, "El bit de notificación del último canal coincide con NOTIFY_REDRAW");
+
+// Dígitos del formato configurado, del más significativo al menos significativo. Los usa solo displayTask
+static contador_t display_counter = NULL;
+#define ALL_DIGITS ((1UL << DISPLAY_DIGITS) - 1) // Máscara de cambios con todos los dígitos
+
+static int32_t drift_ppb = 0; // Corrección de la deriva del reloj aplicada al cronómetro, en partes por mil millones
+static bool pps_ready = false; // La entrada del pulso de referencia y su interrupción están configuradas
+
+// Paneles de dígitos de la escena, del más significativo al menos significativo, con la posición de su primer dígito
+// en display_counter y los bits de sus dígitos en la máscara de cambios
+#define DIGIT_GROUPS ((DISPLAY_FORMAT == FORMAT_SS_MMM) ? 2 : 3)
+static struct {
+    elemento_t widget;
+    uint8_t first;
+    uint32_t mask;
+} digit_groups[DIGIT_GROUPS];
+
+// Estadísticas del renderizador de la pantalla, las escribe solo displayTask
+struct {
+    uint32_t frames;         // Cuadros dibujados
+    uint32_t dropped;        // Cuadros descartados porque el anterior terminó tarde
+    uint32_t partial;        // Cuadros en los que no alcanzó el presupuesto para dibujar todos los dígitos
+    uint32_t fps_x10;        // Cuadros por segundo del último segundo, multiplicado por 10
+    uint32_t worst_frame_us; // Duración del cuadro más largo
+    uint32_t worst_projection_us; // Mayor diferencia entre el instante proyectado y el real de un cuadro completo
+} render_stats;
+
+// Eventos de la bitácora: se escriben con los mutex tomados sin formatear texto, BitacoraTask los muestra después
+enum {
+    EVT_SS_PRESSED,     // Start/Stop presionado
+    EVT_CHANNEL_START,  // Canal iniciado (canal)
+    EVT_CHANNEL_STOP,   // Canal detenido (canal)
+    EVT_RST_PRESSED,    // Reset presionado
+    EVT_RST_REQUESTED,  // Reset solicitado con el canal detenido (canal)
+    EVT_RST_IGNORED,    // Reset ignorado con el canal corriendo (canal)
+    EVT_LAP_PRESSED,    // Lap presionado
+    EVT_LAP_RECORDED,   // Vuelta registrada (canal, vuelta)
+    EVT_LAP_IGNORED,    // Vuelta ignorada con el canal detenido (canal)
+    EVT_CHANNEL_SELECT, // Canal seleccionado (canal)
+    EVT_CHANNEL_RESET,  // Canal reseteado por displayTask (canal)
+    EVT_GATE_CUT,       // Corte de una barrera de luz (barrera, canal)
+    EVT_GATE_LOST,      // Cortes perdidos por buffer lleno (barrera, total)
+    EVT_TIMER_RETRY,    // Vencimiento demorado por cola llena (evento, reintentos en total)
+    EVT_COUNT,
+};
+
+static const char * const event_texts[EVT_COUNT] = {
+    [EVT_SS_PRESSED] = "[BTN] Start/Stop PRESIONADO",
+    [EVT_CHANNEL_START] = "[SYS] Canal %" PRId32 " INICIADO",
+    [EVT_CHANNEL_STOP] = "[SYS] Canal %" PRId32 " DETENIDO",
+    [EVT_RST_PRESSED] = "[BTN] Reset PRESIONADO",
+    [EVT_RST_REQUESTED] = "[SYS] Canal %" PRId32 " reset solicitado (cronómetro detenido).",
+    [EVT_RST_IGNORED] = "[SYS] Canal %" PRId32 " reset ignorado (cronómetro corriendo).",
+    [EVT_LAP_PRESSED] = "[BTN] Lap PRESIONADO",
+    [EVT_LAP_RECORDED] = "[SYS] Canal %" PRId32 " vuelta %" PRId32 " registrada.",
+    [EVT_LAP_IGNORED] = "[SYS] Canal %" PRId32 " vuelta ignorada (cronómetro detenido).",
+    [EVT_CHANNEL_SELECT] = "[BTN] Canal %" PRId32 " seleccionado",
+    [EVT_CHANNEL_RESET] = "[DSP] Canal %" PRId32 " reseteado a 0 por solicitud.",
+    [EVT_GATE_CUT] = "[GATE] Barrera %" PRId32 " cortada, canal %" PRId32,
+    [EVT_GATE_LOST] = "[GATE] Barrera %" PRId32 ": %" PRId32 " cortes perdidos en total",
+    [EVT_TIMER_RETRY] = "[SYS] Cola de control llena, evento %" PRId32 " reintentado (%" PRId32 " en total)",
+};
+
+// Pantalla del cronómetro, creada en app_main
+static ili9341_t lcd = NULL;
 
 // Handles para los Mutex
 SemaphoreHandle_t xMutexPantalla = NULL; // Protege acceso a la pantalla (ILI9341, paneles)
-SemaphoreHandle_t xMutexEstado = NULL;   // Protege el ESTADO compartido (decimas, isRunning, 
-SemaphoreHandle_t xMutexLed = NULL;      // Protege el acceso a los LEDs
+SemaphoreHandle_t xMutexEstado = NULL;   // Protege el ESTADO compartido (cronómetro, reset)
+SemaphoreHandle_t xMutexRegistro = NULL; // Serializa las escrituras del registro en la memoria flash
 
 
  // --- Prototipos de Funciones de Tareas y Callbacks ---
-void tecladoTask(void * pvParameters);
-void Manejo_LEDTask(void * pvParameters);
+void controlTask(void * pvParameters);
 void displayTask(void * pvParameters);
-void timerCallback(TimerHandle_t xTimer);
+void registroTask(void * pvParameters);
+static void enter_deep_sleep(void);
+static void post_timer_event(temporizador_t timer, void * context);
 
 //--- Configuración de Pines GPIO ---
 static void configure_gpios(void) {
     ESP_LOGI(TAG, "Configurando pines GPIO...");
     // Configurar Botones como Entrada con Pull-up interno habilitado
     gpio_config_t io_conf_button = {}; // Inicializar a cero
-    io_conf_button.pin_bit_mask = (1ULL << PB_Run_Stop) | (1ULL << PB_Reset);
+    io_conf_button.pin_bit_mask = (1ULL << PB_Run_Stop) | (1ULL << PB_Reset) | (1ULL << PB_Lap) | (1ULL << PB_Canal);
     io_conf_button.mode = GPIO_MODE_INPUT;
     io_conf_button.pull_up_en = GPIO_PULLUP_ENABLE; // Asume botones conectados a GND
     io_conf_button.pull_down_en = GPIO_PULLDOWN_DISABLE;
-    io_conf_button.intr_type = GPIO_INTR_DISABLE; // Sin interrupciones, se usa polling
+    io_conf_button.intr_type = GPIO_INTR_ANYEDGE; // Cada flanco despierta al lazo de control
     esp_err_t err_btn = gpio_config(&io_conf_button);
     if (err_btn != ESP_OK)
         ESP_LOGE(TAG, "Error configurando botones: %s", esp_err_to_name(err_btn));
 
-    // Configurar LEDs como Salida
-    gpio_config_t io_conf_led = {}; // Inicializar a cero
-    io_conf_led.pin_bit_mask = (1ULL << LED_VERDE) | (1ULL << LED_ROJO);
-    io_conf_led.mode = GPIO_MODE_OUTPUT;
-    io_conf_led.pull_up_en = GPIO_PULLUP_DISABLE;
-    io_conf_led.pull_down_en = GPIO_PULLDOWN_DISABLE;
-    io_conf_led.intr_type = GPIO_INTR_DISABLE;
-    esp_err_t err_led = gpio_config(&io_conf_led);
-    if (err_led != ESP_OK)
-        ESP_LOGE(TAG, "Error configurando LEDs: %s", esp_err_to_name(err_led));
-
-    // Estado inicial de los LEDs (apagados)
-    gpio_set_level(LED_VERDE, 0);
-    gpio_set_level(LED_ROJO, 0); // Se encenderá en la tarea si está detenido al inicio
-
-    ESP_LOGI(TAG, "GPIOs configurados (Start/Stop: %d, Reset: %d, Green: %d, Red: %d)", PB_Run_Stop,
-             PB_Reset, LED_VERDE, LED_ROJO);
+    // Conectar los LEDs al periférico LEDC, que genera los patrones sin intervención del procesador.
+    // Quedan apagados hasta que el lazo de control muestre el estado del canal seleccionado
+    green_led = IndicadorCrear(LED_VERDE);
+    red_led = IndicadorCrear(LED_ROJO);
+    if (green_led == NULL || red_led == NULL) {
+        ESP_LOGE(TAG, "¡Error Crítico! No se pudieron configurar los LEDs en el LEDC.");
+        abort();
+    }
+
+    ESP_LOGI(TAG, "GPIOs configurados (Start/Stop: %d, Reset: %d, Lap: %d, Canal: %d, Green: %d, Red: %d)",
+             PB_Run_Stop, PB_Reset, PB_Lap, PB_Canal, LED_VERDE, LED_ROJO);
 }
 
-//--- Tarea para Gestión de Botones (Uso xMutexEstado) ---
-void tecladoTask(void * pvParameters) {
-    ESP_LOGI(TAG, "Inicio Tarea: tecladoTask");
-    // Variables para debounce del botón Start/Stop
-    int current_ss_state = 1;             // Estado actual leído (1=liberado, 0=presionado con pull-up)
-    int last_steady_ss_state = 1;         // Último estado estable confirmado
-    TickType_t last_debounce_ss_time = 0; // Tiempo (en ticks) del último rebote detectado
+// Encola un evento en el registro persistente. Se llama con xMutexEstado tomado, lo que garantiza un único
+// productor a la vez; no accede a la memoria flash así que no demora el camino de medición
+static void log_event(uint8_t channel, registro_tipo_t type, uint32_t number) {
+    if (event_log) {
+        registro_evento_t event = {
+            .tipo = type,
+            .canal = channel,
+            .sesion = session_id,
+            .numero = number,
+            .tiempo_us = CronometroTranscurrido(channel),
+        };
+        RegistroAgregar(event_log, &event);
+    }
+}
 
-    // Variables para debounce del botón Reset
-    int current_rst_state = 1;
-    int last_steady_rst_state = 1;
-    TickType_t last_debounce_rst_time = 0;
+//--- Lazo de control: botones, LEDs y vencimientos en una única tarea dirigida por eventos ---
+
+// Publica en la cola del lazo de control el evento codificado en el contexto del temporizador (tarea esp_timer). Un
+// vencimiento de un solo disparo (fin de alarma, descanso, pulsación larga) no se puede perder: si la cola está llena
+// se vuelve a armar el temporizador para reintentar en TIMER_RETRY_MS. Un temporizador periódico sigue armado y su
+// próximo vencimiento reemplaza al perdido. Si el lazo de control lo volvió a armar, vale el vencimiento nuevo
+static void post_timer_event(temporizador_t timer, void * context) {
+    static uint32_t retries = 0;
+    control_event_t event = {
+        .type = (uintptr_t)context >> 8,
+        .arg = (uintptr_t)context & 0xFF,
+        .at_us = esp_timer_get_time(),
+    };
+
+    if (xQueueSend(control_queue, &event, 0) != pdTRUE && !TemporizadorArmado(timer)) {
+        TemporizadorArmar(timer, MS_TO_WHEEL(TIMER_RETRY_MS), 0);
+        BitacoraEscribir(EVT_TIMER_RETRY, event.type, ++retries);
+    }
+}
 
-    while (1) {
-        TickType_t now = xTaskGetTickCount(); // Tiempo actual en ticks
-
-        // --- Lectura y Debounce Botón Start/Stop ---
-        int leo_PB_Run_Stop = gpio_get_level(PB_Run_Stop);
-
-        // Detectar cambio en la lectura (posible inicio de rebote o cambio real)
-        if (leo_PB_Run_Stop != current_ss_state) {
-            last_debounce_ss_time = now;   // Registrar el tiempo de este cambio
-            current_ss_state = leo_PB_Run_Stop; // Actualizar el estado 'potencialmente inestable'
-        }
-
-        // Verificar si ha pasado suficiente tiempo desde el último cambio detectado (estabilización)
-        if ((now - last_debounce_ss_time) > pdMS_TO_TICKS(DEBOUNCE_TIME_MS)) {
-            // Si el estado actual (ya estable) es diferente del último estado estable confirmado...
-            if (current_ss_state != last_steady_ss_state) {
-                last_steady_ss_state = current_ss_state; // ...confirmar el nuevo estado estable.
-                // Actuar solo en la transición a presionado (flanco descendente con pull-up)
-                if (last_steady_ss_state == 0) {
-                    ESP_LOGI(TAG, "[BTN] Start/Stop PRESIONADO");
-                    // --- Sección Crítica: Modificar estado compartido (Uso xMutexEstado)
-                    if (xSemaphoreTake(xMutexEstado, portMAX_DELAY) == pdTRUE) {
-                        isRunning = !isRunning; // Invertir el estado de ejecución
-                        ESP_LOGI(TAG, "[SYS] Cronómetro %s", isRunning ? "INICIADO" : "DETENIDO");
-                        xSemaphoreGive(xMutexEstado); // Liberar Mutex
-                    } else {
-                         ESP_LOGE(TAG, "TecladoTask: Fallo al tomar Mutex de estado para Start/Stop!");
-                    }
-                    // --- Fin Sección Crítica ---
-                } else {
-                    ESP_LOGD(TAG, "[BTN] Start/Stop LIBERADO"); // Para depuración
-                }
-            }
-        }
+// Interrupción de flanco de un botón: deshabilita la interrupción del pin hasta que las entradas se estabilicen,
+// asi los rebotes no llenan la cola, y publica el flanco con su instante
+static void button_isr(void * arg) {
+    uint8_t button = (uintptr_t)arg;
+    control_event_t event = {.type = EV_EDGE, .arg = button, .at_us = esp_timer_get_time()};
+    BaseType_t woken = pdFALSE;
 
-        // --- Lectura y Debounce Botón Reset ---
-        // (Misma lógica que para Start/Stop)
-        int leo_PB_Reset = gpio_get_level(PB_Reset);
-
-        if (leo_PB_Reset != current_rst_state) {
-            last_debounce_rst_time = now;
-            current_rst_state = leo_PB_Reset;
-        }
-
-        if ((now - last_debounce_rst_time) > pdMS_TO_TICKS(DEBOUNCE_TIME_MS)) {
-            if (current_rst_state != last_steady_rst_state) {
-                last_steady_rst_state = current_rst_state;
-                if (last_steady_rst_state == 0) { // Transición a presionado
-                    ESP_LOGI(TAG, "[BTN] Reset PRESIONADO");
-                    // --- Sección Crítica: Verificar estado y marcar para reset (Uso xMutexEstado)
-                    if (xSemaphoreTake(xMutexEstado, portMAX_DELAY) == pdTRUE) {
-                        // Leer isRunning dentro del mutex para asegurar consistencia
-                       bool current_running_state = isRunning;
-                       if (!current_running_state) { // Solo actuar si el cronómetro está DETENIDO
-                           resetPressedWhileStopped = true; // Indicar a displayTask que resetee
-                           ESP_LOGI(TAG, "[SYS] Reset solicitado (cronómetro detenido).");
-                       } else {
-                           ESP_LOGW(TAG, "[SYS] Reset ignorado (cronómetro corriendo).");
-                       }
-                       xSemaphoreGive(xMutexEstado); // Libero Mutex
-                   } else {
-                        ESP_LOGE(TAG, "TecladoTask: Fallo al tomar Mutex de estado para Reset!");
-                   }
-                    // --- Fin Sección Crítica ---
-                } else {
-                    ESP_LOGD(TAG, "[BTN] Reset LIBERADO"); // Para depuración
-                }
-            }
+    gpio_intr_disable(button_pins[button]);
+    if (xQueueSendFromISR(control_queue, &event, &woken) != pdTRUE) {
+        gpio_intr_enable(button_pins[button]); // Sin lugar en la cola: se atiende el próximo flanco
+    }
+    portYIELD_FROM_ISR(woken);
+}
+
+// Corte aceptado de una barrera de luz (interrupción de captura): guarda el instante capturado por hardware, que no
+// depende de cuándo se atiende la interrupción ni de cuándo lo procesa el lazo de control, y despierta al lazo. Si la
+// cola está llena el corte no se pierde, el lazo lo lee del buffer después del próximo evento
+static bool gate_isr(barrera_t gate, int64_t at_us, void * context) {
+    uint8_t index = (uintptr_t)context;
+    control_event_t event = {.type = EV_GATE, .arg = index, .at_us = at_us};
+    BaseType_t woken = pdFALSE;
+    unsigned head = atomic_load_explicit(&gate_cuts[index].head, memory_order_relaxed);
+
+    if (head - atomic_load_explicit(&gate_cuts[index].tail, memory_order_acquire) >= GATE_BUFFER) {
+        atomic_fetch_add_explicit(&gate_cuts[index].lost, 1, memory_order_relaxed);
+        return false;
+    }
+    gate_cuts[index].cut_us[head % GATE_BUFFER] = at_us;
+    atomic_store_explicit(&gate_cuts[index].head, head + 1, memory_order_release);
+    xQueueSendFromISR(control_queue, &event, &woken);
+    return woken == pdTRUE;
+}
+
+// Pulso de referencia (interrupción de flanco, habilitada solo mientras se calibra): publica el instante según el
+// reloj local. La latencia de la interrupción varía unos microsegundos, pero la calibración solo usa el primer y el
+// último pulso, asi ese error se reparte en todo el tiempo medido
+static void pps_isr(void * arg) {
+    control_event_t event = {.type = EV_PPS, .at_us = esp_timer_get_time()};
+    BaseType_t woken = pdFALSE;
+
+    xQueueSendFromISR(control_queue, &event, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+// Lee los registros de entrada de los GPIO, cada bit es el nivel de un pin
+static void read_inputs(uint32_t samples[INPUT_REGISTERS]) {
+    samples[0] = REG_READ(GPIO_IN_REG);
+    samples[1] = REG_READ(GPIO_IN1_REG) & 0xFF;
+}
+
+// Máscara de los pines de los botones en un registro de entrada
+static uint32_t button_mask(int reg) {
+    uint32_t mask = 0;
+    for (int button = 0; button < BTN_COUNT; button++) {
+        if (button_pins[button] / 32 == reg) {
+            mask |= 1UL << (button_pins[button] % 32);
         }
+    }
+    return mask;
+}
+
+// Modos de los LEDs, cada uno es un patrón de hardware que se configura una sola vez al cambiar de modo
+enum { LEDS_UNKNOWN, LEDS_STOPPED, LEDS_RUNNING, LEDS_ALARM };
+static uint8_t leds_mode = LEDS_UNKNOWN;
+
+// Actualiza los LEDs según el canal seleccionado y la alarma. Solo reconfigura el LEDC si el modo cambió
+static void update_leds(void) {
+    uint8_t mode;
+
+    if (TemporizadorArmado(alarm_timer)) {
+        mode = LEDS_ALARM;
+    } else if (CronometroCorriendo(selectedChannel)) { // Solo el lazo de control modifica estos valores
+        mode = LEDS_RUNNING;
+    } else {
+        mode = LEDS_STOPPED;
+    }
+    if (mode == leds_mode) {
+        return;
+    }
+    leds_mode = mode;
+
+    switch (mode) {
+    case LEDS_ALARM: // Fin de un descanso: parpadear ambos LEDs en fase, sin importar el canal
+        IndicadorParpadear(green_led, ALARM_PERIOD_MS, 50);
+        IndicadorParpadear(red_led, ALARM_PERIOD_MS, 50);
+        break;
+    case LEDS_RUNNING: // Cronómetro corriendo: parpadear LED verde
+        IndicadorApagar(red_led);
+        IndicadorParpadear(green_led, BLINK_PERIOD_MS, 50);
+        break;
+    default: // Cronómetro detenido: LED rojo fijo
+        IndicadorApagar(green_led);
+        IndicadorEncender(red_led);
+        break;
+    }
+}
 
-        // Pausa breve para ceder tiempo de CPU a otras tareas
-        vTaskDelay(pdMS_TO_TICKS(20));
+// Arranca o detiene un canal en el instante indicado. Se llama con xMutexEstado tomado
+static void toggle_channel(uint8_t channel, int64_t at_us) {
+    bool running = CronometroAlternarEn(channel, at_us); // Invertir el estado de ejecución
+    if (!running) {
+        TemporizadorCancelar(rest_timers[channel]); // Detenido no hay descanso que contar
     }
+    log_event(channel, running ? REGISTRO_ARRANQUE : REGISTRO_DETENCION, 0);
+    LatenciaMarcar(LATENCIA_ESTADO, esp_timer_get_time());
+    BitacoraEscribir(running ? EVT_CHANNEL_START : EVT_CHANNEL_STOP, channel + 1, 0);
 }
 
-//--- Tarea para Gestión de LEDs Indicadores (Uso xMutexEstado)
-void Manejo_LEDTask(void * pvParameters) {
-    ESP_LOGI(TAG, "Inicio Tarea: Manejo_LEDTask");
-    bool green_led_on = false;      // Estado actual del LED verde (para parpadeo)
-    TickType_t last_blink_time = 0; // Momento del último cambio de estado del LED verde
+// Registra una vuelta de un canal corriendo con el tiempo parcial indicado. Se llama con xMutexEstado tomado
+static void record_lap(uint8_t channel, uint64_t split_us) {
+    VueltasAgregar(lap_logs[channel], split_us);
+    uint32_t lap = CronometroRegistrarVuelta(channel);
+    log_event(channel, REGISTRO_VUELTA, lap);
+    TemporizadorArmar(rest_timers[channel], MS_TO_WHEEL(REST_TIME_MS), 0);
+    LatenciaMarcar(LATENCIA_ESTADO, esp_timer_get_time());
+    BitacoraEscribir(EVT_LAP_RECORDED, channel + 1, lap);
+    if (channel == selectedChannel && leds_mode == LEDS_RUNNING) {
+        IndicadorDestellar(red_led, LAP_FLASH_MS); // Termina apagado, como corresponde a un canal corriendo
+    }
+}
 
-    while (1) {
-        bool current_status; // Variable local para guardar el estado leído
+// Acción de un botón confirmado como presionado (pressed en true) o liberado después del antirrebote
+static void on_button(uint8_t button, bool pressed, int64_t edge_us) {
+    if (button == BTN_RESET && pressed) {
+        // Se espera a la liberación para distinguir una pulsación corta de una larga
+        BitacoraEscribir(EVT_RST_PRESSED, 0, 0);
+        TemporizadorArmar(hold_timer, MS_TO_WHEEL(SLEEP_HOLD_MS), 0);
+        return;
+    }
+    if (button == BTN_RESET) {
+        if (!TemporizadorArmado(hold_timer)) {
+            return; // La pulsación larga ya se atendió
+        }
+        TemporizadorCancelar(hold_timer); // Liberado antes de SLEEP_HOLD_MS: pulsación corta
+    } else if (!pressed) {
+        ESP_LOGD(TAG, "[BTN] Botón %d LIBERADO", button); // Para depuración
+        return;
+    }
 
-        // --- Sección Crítica: Leer estado compartido -Uso xMutexEstado
-        if (xSemaphoreTake(xMutexEstado, portMAX_DELAY) == pdTRUE) {
-            current_status = isRunning; // Leer el estado actual
-            xSemaphoreGive(xMutexEstado);      // Liberar Mutex
+    LatenciaIniciar(edge_us);
+    LatenciaMarcar(LATENCIA_BOTON, esp_timer_get_time());
+
+    // --- Sección Crítica: Modificar estado compartido con displayTask (Uso xMutexEstado)
+    if (xSemaphoreTake(xMutexEstado, portMAX_DELAY) != pdTRUE) {
+        ESP_LOGE(TAG, "Control: Fallo al tomar Mutex de estado para el botón %d!", button);
+        return;
+    }
+    uint8_t channel = selectedChannel;
+    switch (button) {
+    case BTN_RUN_STOP:
+        BitacoraEscribir(EVT_SS_PRESSED, 0, 0);
+        toggle_channel(channel, esp_timer_get_time());
+        break;
+    case BTN_RESET:
+        if (!CronometroCorriendo(channel)) { // Solo actuar si el cronómetro está DETENIDO
+            resetChannel = channel;
+            resetPressedWhileStopped = true; // Indicar a displayTask que resetee
+            LatenciaMarcar(LATENCIA_ESTADO, esp_timer_get_time());
+            BitacoraEscribir(EVT_RST_REQUESTED, channel + 1, 0);
+        } else {
+            BitacoraEscribir(EVT_RST_IGNORED, channel + 1, 0);
+        }
+        break;
+    case BTN_LAP:
+        BitacoraEscribir(EVT_LAP_PRESSED, 0, 0);
+        if (CronometroCorriendo(channel)) { // Solo se registran vueltas con el canal corriendo
+            record_lap(channel, CronometroTranscurrido(channel));
         } else {
-            ESP_LOGE(TAG, "LED Task: Fallo al tomar Mutex de estado!");
-            vTaskDelay(pdMS_TO_TICKS(100)); // Esperar antes de reintentar
-            continue;                       // Saltar el resto del ciclo
+            BitacoraEscribir(EVT_LAP_IGNORED, channel + 1, 0);
         }
-        // --- Fin Sección Crítica ---
+        break;
+    case BTN_CHANNEL:
+        selectedChannel = (channel + 1) % CRONOMETRO_CANALES;
+        LatenciaMarcar(LATENCIA_ESTADO, esp_timer_get_time());
+        BitacoraEscribir(EVT_CHANNEL_SELECT, selectedChannel + 1, 0);
+        break;
+    }
+    xSemaphoreGive(xMutexEstado); // Liberar Mutex
+    // --- Fin Sección Crítica ---
 
-        TickType_t current_time = xTaskGetTickCount(); // Tiempo actual en ticks
+    update_leds(); // El canal seleccionado pudo arrancar, detenerse o cambiar
+}
 
-        if (current_status) {
-            // --- Cronómetro Corriendo: Parpadear LED Verde ---
-            if (xSemaphoreTake(xMutexLed, portMAX_DELAY) == pdTRUE) {
-                gpio_set_level(LED_ROJO, 0); // Aseguro que el LED Rojo esté apagado
-                xSemaphoreGive(xMutexLed);
-            } else {
-                ESP_LOGE(TAG, "LED Task: Fallo al tomar Mutex de LED!");
-            }
+// Acción de una barrera de luz sobre su canal, con el instante del corte capturado por hardware en lugar del instante
+// en que se atiende el evento
+static void on_gate(uint8_t gate, int64_t cut_us) {
+    uint8_t channel = gate_config[gate].channel;
+
+    if (xSemaphoreTake(xMutexEstado, portMAX_DELAY) != pdTRUE) {
+        ESP_LOGE(TAG, "Control: Fallo al tomar Mutex de estado para la barrera %d!", gate);
+        return;
+    }
+    BitacoraEscribir(EVT_GATE_CUT, gate + 1, channel + 1);
+    bool running = CronometroCorriendo(channel);
+    switch (gate_config[gate].action) {
+    case GATE_START:
+        if (!running) {
+            toggle_channel(channel, cut_us);
+        }
+        break;
+    case GATE_STOP:
+        if (running) {
+            toggle_channel(channel, cut_us);
+        }
+        break;
+    case GATE_LAP:
+        if (running) {
+            record_lap(channel, CronometroTranscurridoEn(channel, cut_us));
+        }
+        break;
+    }
+    xSemaphoreGive(xMutexEstado);
 
+    update_leds(); // El canal de la barrera puede ser el seleccionado
+}
 
-            // Lógica de parpadeo: cambiar estado cada (BLINK_PERIOD_MS / 2)
-            if ((current_time - last_blink_time) >= pdMS_TO_TICKS(BLINK_PERIOD_MS / 2)) {
-                if (xSemaphoreTake(xMutexLed, portMAX_DELAY) == pdTRUE) {
-                    green_led_on = !green_led_on;             // Invertir estado
-                    gpio_set_level(LED_VERDE, green_led_on);  // Aplicar nuevo estado al GPIO
-                    xSemaphoreGive(xMutexLed);                // Libero Mutex 
-                    last_blink_time = current_time;           // Registrar el tiempo del cambio DESPUÉS de dar el mutex
-                } else {
-                    ESP_LOGE(TAG, "LED Task: Fallo al tomar Mutex de LED para parpadeo!");
+// Atiende los cortes pendientes de todas las barreras en el orden en que se produjeron e informa los perdidos
+static void drain_gate_cuts(void) {
+    while (1) {
+        int next = -1;
+        int64_t next_us = 0;
+        for (int gate = 0; gate < GATE_COUNT; gate++) {
+            unsigned tail = atomic_load_explicit(&gate_cuts[gate].tail, memory_order_relaxed);
+            if (tail != atomic_load_explicit(&gate_cuts[gate].head, memory_order_acquire)) {
+                int64_t cut_us = gate_cuts[gate].cut_us[tail % GATE_BUFFER];
+                if (next < 0 || cut_us < next_us) {
+                    next = gate;
+                    next_us = cut_us;
                 }
             }
-            // Pausa corta, necesaria para que el parpadeo sea visible y ceder CPU
-            vTaskDelay(pdMS_TO_TICKS(50));
+        }
+        if (next < 0) {
+            break;
+        }
+        atomic_fetch_add_explicit(&gate_cuts[next].tail, 1, memory_order_release);
+        on_gate(next, next_us);
+    }
+    for (int gate = 0; gate < GATE_COUNT; gate++) {
+        uint32_t lost = atomic_load_explicit(&gate_cuts[gate].lost, memory_order_relaxed);
+        if (lost != gate_lost_logged[gate]) {
+            BitacoraEscribir(EVT_GATE_LOST, gate + 1, lost);
+            gate_lost_logged[gate] = lost;
+        }
+    }
+}
 
-        } else {
-            // --- Cronómetro Detenido: Encender LED Rojo fijo ---
-            if (xSemaphoreTake(xMutexLed, portMAX_DELAY) == pdTRUE) {
-                gpio_set_level(LED_VERDE, 0);   // Asegurar que el LED Verde esté apagado
-                gpio_set_level(LED_ROJO, 1);    // Encender el LED Rojo
-                xSemaphoreGive(xMutexLed);
+// Lazo de control: bloqueado en la cola hasta el próximo evento, no hay esperas de periodo fijo. Los flancos llegan
+// desde la interrupción de los botones y los vencimientos (antirrebote, pulsación larga, descanso y fin de alarma)
+// desde la rueda de temporizadores, que solo programa el temporizador de hardware para el próximo vencimiento
+void controlTask(void * pvParameters) {
+    ESP_LOGI(TAG, "Inicio Tarea: controlTask");
+    control_event_t event;
+
+    update_leds();
+    while (1) {
+        if (xQueueReceive(control_queue, &event, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+        switch (event.type) {
+        case EV_EDGE:
+            // Primer flanco desde que las entradas están estables: comienza la traza de latencia y el muestreo
+            first_edge_us[event.arg] = event.at_us;
+            edges_enabled = false;
+            if (!TemporizadorArmado(sample_timer)) {
+                TemporizadorArmar(sample_timer, MS_TO_WHEEL(DEBOUNCE_SAMPLE_MS), MS_TO_WHEEL(DEBOUNCE_SAMPLE_MS));
+            }
+            break;
+        case EV_SAMPLE: {
+            // Todas las entradas se procesan juntas, cada botón es un bit de uno de los registros
+            uint32_t samples[INPUT_REGISTERS], pressed[INPUT_REGISTERS], released[INPUT_REGISTERS];
+            bool settling = false;
+            read_inputs(samples);
+            for (int reg = 0; reg < INPUT_REGISTERS; reg++) {
+                settling |= AntirreboteMuestrear(input_groups[reg], samples[reg], &pressed[reg], &released[reg]);
+            }
+            for (int button = 0; button < BTN_COUNT; button++) {
+                int reg = button_pins[button] / 32;
+                uint32_t bit = 1UL << (button_pins[button] % 32);
+                if ((pressed[reg] | released[reg]) & bit) {
+                    on_button(button, pressed[reg] & bit, first_edge_us[button]);
+                }
+            }
+            if (settling) {
+                break;
+            }
+            if (!edges_enabled) {
+                // Habilitar los flancos y muestrear una vez más, por si algo cambió antes de habilitarlos
+                for (int button = 0; button < BTN_COUNT; button++) {
+                    gpio_intr_enable(button_pins[button]);
+                }
+                edges_enabled = true;
             } else {
-                ESP_LOGE(TAG, "LED Task: Fallo al tomar Mutex de LED para encender rojo!");
+                TemporizadorCancelar(sample_timer); // Entradas estables, no hay nada que muestrear
             }
+            break;
+        }
+        case EV_HOLD:
+            // Pulsación larga de Reset: entrar en sueño profundo
+            ESP_LOGI(TAG, "[BTN] Reset MANTENIDO, entrando en sueño profundo");
+            enter_deep_sleep(); // No retorna
+            break;
+        case EV_ALARM_END:
+            update_leds();
+            break;
+        case EV_REST:
+            // Fin de un descanso: aviso en la pantalla y parpadeo de ambos LEDs
+            if (display_task) {
+                xTaskNotify(display_task, 1UL << event.arg, eSetBits);
+            }
+            TemporizadorArmar(alarm_timer, MS_TO_WHEEL(ALARM_BLINK_MS), 0);
+            update_leds();
+            break;
+        case EV_GATE:
+            break; // Los cortes se leen de los buffers de las barreras después de cada evento
+        case EV_PPS:
+            CalibracionPulso(event.at_us);
+            break;
+        }
+        drain_gate_cuts();
+    }
+}
+
+//--- Tarea para Actualizar Pantalla LCD (displayTask) ---
 
-            green_led_on = false;           // Resetear estado del LED verde para el próximo ciclo
-            last_blink_time = current_time; // Resetear tiempo de parpadeo
+// Indicador de canal con 2 bits por píxel: 0 es el fondo, 1 el marco del canal seleccionado y 2 el cuadrado que
+// muestra si el canal corre o tiene tiempo acumulado. Los colores se eligen al dibujarlo (generado con
+// tools/sprite565.py)
+_Static_assert(CH_BOX == 15, "El sprite del indicador de canal está dibujado para CH_SIZE igual a 10");
+_Static_assert(CH_STEP >= CH_BOX, "Con tantos canales los indicadores de canal se superponen");
+static const uint8_t marker_data[] = {
+    0x55, 0x55, 0x55, 0x54, 0x40, 0x00, 0x00, 0x04, 0x4A, 0xAA, 0xAA, 0x84, 0x4A, 0xAA, 0xAA, 0x84,
+    0x4A, 0xAA, 0xAA, 0x84, 0x4A, 0xAA, 0xAA, 0x84, 0x4A, 0xAA, 0xAA, 0x84, 0x4A, 0xAA, 0xAA, 0x84,
+    0x4A, 0xAA, 0xAA, 0x84, 0x4A, 0xAA, 0xAA, 0x84, 0x4A, 0xAA, 0xAA, 0x84, 0x4A, 0xAA, 0xAA, 0x84,
+    0x4A, 0xAA, 0xAA, 0x84, 0x40, 0x00, 0x00, 0x04, 0x55, 0x55, 0x55, 0x54,
+};
+static const ili9341_sprite_t marker_sprite = {CH_BOX, CH_BOX, 2, marker_data};
+
+// Elige los dígitos a mostrar proyectando el tiempo medido al instante en que termina de dibujarse el último
+// dígito que cambia. Ese instante depende de cuántos segmentos cambian, que a su vez depende del valor elegido, por
+// eso se estima dos veces. El contador avanza hasta cada proyección sin divisiones y los cambios se acumulan en
+// changed, asi solo se cuentan los segmentos de los paneles con dígitos nuevos. Devuelve el instante proyectado, o
+// cero si no hay nada que dibujar.
+// La proyección se limita a un cuadro: el cuadro siguiente empieza antes de un instante proyectado más lejos y el
+// contador retrocedería. Por la misma razón un canal corriendo nunca muestra menos que shown_us, el valor proyectado
+// en el cuadro anterior, salvo que la diferencia supere un cuadro (reset o cambio de canal)
+static int64_t project_digits(uint64_t elapsed_us, int64_t sampled_at, bool running, uint32_t segment_us_x16,
+                              uint32_t * changed, uint64_t * shown_us) {
+    const uint8_t * digits = ContadorDigitos(display_counter);
+    int64_t now = esp_timer_get_time();
+    int64_t landing = now;
+
+    for (int pass = 0; pass < 2; pass++) {
+        uint64_t projected_us = elapsed_us;
+        if (running) {
+            projected_us += landing - sampled_at; // El tiempo sigue corriendo mientras se dibuja
+            if (projected_us < *shown_us && *shown_us - projected_us < FRAME_PERIOD_US) {
+                projected_us = *shown_us;
+            }
+        }
+        *changed |= ContadorAvanzar(display_counter, projected_us);
+        *shown_us = projected_us;
+        if (*changed == 0) {
+            return 0;
+        }
 
-            // Pausa más larga, ya que el estado es fijo
-            vTaskDelay(pdMS_TO_TICKS(100));
+        uint32_t segments = 0;
+        for (uint8_t group = 0; group < DIGIT_GROUPS; group++) {
+            if (*changed & digit_groups[group].mask) {
+                segments += ElementoSegmentos(digit_groups[group].widget, &digits[digit_groups[group].first]);
+            }
+        }
+        if (segments == 0) {
+            return 0;
+        }
+        landing = now + (segments * segment_us_x16) / 16;
+        if (landing > now + FRAME_PERIOD_US) {
+            landing = now + FRAME_PERIOD_US;
         }
     }
+    return landing;
 }
 
-//--- Tarea para Actualizar Pantalla LCD (displayTask) ---
+// Arma la escena de la pantalla en el orden de dibujo: separadores, paneles de dígitos, línea de vueltas, aviso de
+// fin de descanso e indicadores de canal. Los paneles se dibujan en blanco al crearlos. También crea el contador que
+// alimenta a los paneles. Devuelve falso si no alcanzan los elementos, los paneles o los contadores.
+static bool build_scene(void) {
+    static const uint8_t bases[DISPLAY_DIGITS] = DISPLAY_BASES;
+    bool created = true;
+    uint8_t group = 0;
+    uint8_t first = 0;
+
+    display_counter = ContadorCrear(bases, DISPLAY_DIGITS, FRACTION_UNIT_US);
+    scene = EscenaCrear(lcd, DIGITO_FONDO);
+    if (!display_counter || !scene) {
+        return false;
+    }
+#if DISPLAY_FORMAT == FORMAT_SS_MMM
+    created &= EscenaAgregarSeparador(scene, FRACTION_X - 2 * SEP_RADIUS, PANEL_Y_DEC + DIGITO_ALTO - 2 * SEP_RADIUS,
+                                      SEP_RADIUS, DIGITO_ENCENDIDO) != NULL;
+#else
+    created &= EscenaAgregarSeparador(scene, SEP1_X + OFFSET_X, SEP_Y1, SEP_RADIUS, DIGITO_ENCENDIDO) != NULL;
+    created &= EscenaAgregarSeparador(scene, SEP1_X + OFFSET_X, SEP_Y2, SEP_RADIUS, DIGITO_ENCENDIDO) != NULL;
+
+    // Panel minutos (2 dígitos)
+    digit_groups[group].mask = 0x3;
+    digit_groups[group++].widget = EscenaAgregarDigitos(scene, PANEL_MIN_X + OFFSET_X, PANEL_Y_MIN, 2, DIGITO_ALTO,
+                                                        DIGITO_ANCHO, DIGITO_ENCENDIDO, DIGITO_APAGADO);
+#endif
+    // Panel segundos (2 dígitos)
+    digit_groups[group].mask = 0x3;
+    digit_groups[group++].widget = EscenaAgregarDigitos(scene, SECONDS_X, PANEL_Y_MIN, 2, DIGITO_ALTO, DIGITO_ANCHO,
+                                                        DIGITO_ENCENDIDO, DIGITO_APAGADO);
+    // Panel de la fracción de segundo (décimas, centésimas o milésimas)
+    digit_groups[group].mask = (1UL << FRACTION_DIGITS) - 1;
+    digit_groups[group++].widget = EscenaAgregarDigitos(scene, FRACTION_X, PANEL_Y_DEC, FRACTION_DIGITS, DIGITO_ALTO,
+                                                        DIGITO_ANCHO, DIGITO_ENCENDIDO, DIGITO_APAGADO);
+    for (group = 0; group < DIGIT_GROUPS; group++) {
+        created &= digit_groups[group].widget != NULL;
+        digit_groups[group].first = first;
+        first += __builtin_popcount(digit_groups[group].mask);
+        digit_groups[group].mask <<= digit_groups[group].first;
+    }
+
+    lap_list = EscenaAgregarVueltas(scene, LAP_X, LAP_Y, 1, 24, &LAP_FONT, DIGITO_ENCENDIDO);
+    rest_label = EscenaAgregarTexto(scene, LAP_X, LAP_Y, 24, &LAP_FONT, DIGITO_ENCENDIDO);
+    created &= (lap_list != NULL) && (rest_label != NULL);
+    if (rest_label) {
+        ElementoVisible(rest_label, false);
+    }
+    for (uint8_t channel = 0; channel < CRONOMETRO_CANALES; channel++) {
+        channel_markers[channel] = EscenaAgregarImagen(scene, CH_X - 2, CH_Y0 + channel * CH_STEP - 2, &marker_sprite);
+        created &= channel_markers[channel] != NULL;
+    }
+    return created;
+}
 
-// Adaptada de tu ejemplo, con MUTEX y lógica de estado/reset
+// Renderizador de cuadros: cada FRAME_PERIOD_TICKS actualiza los elementos de la escena con el último valor del canal
+// seleccionado y la escena dibuja solo lo que cambió. Los dígitos se dibujan del más significativo al menos
+// significativo hasta agotar FRAME_BUDGET_US; los que quedan se dibujan en el cuadro siguiente ya con el valor nuevo.
+// Si un cuadro se atrasa no se recuperan los cuadros perdidos: se cuentan como descartados y se sigue con el tiempo
+// actual, asi la pantalla nunca muestra valores viejos en cola.
 void displayTask(void * pvParameters) {
     ESP_LOGI(TAG, "Inicio Tarea: displayTask");
-    uint32_t display_value_decimas = 0;  // Copia local del contador para mostrar
+    uint64_t elapsed[CRONOMETRO_CANALES]; // Tiempo medido por todos los canales en el mismo instante
+    uint64_t elapsed_us = 0;             // Copia local del tiempo medido para mostrar
+    int64_t sampled_at = 0;              // Instante en que se leyó elapsed_us
+    uint64_t shown_us = 0;               // Tiempo que representan los dígitos elegidos en el último cuadro
+    uint32_t segment_us_x16 = SEGMENT_US_INITIAL * 16; // Tiempo de bus medido por segmento (promedio, x16)
     bool perform_reset = false;          // Flag local para indicar si se debe resetear
-    bool initial_draw_needed = true;     // Flag para realizar el primer dibujado (00:00.0)
-
-    // Creación de Paneles (Sección Crítica Inicial de pantalla, Protejo solo con xMutexPantalla)
+    uint32_t lap_number = 0;             // Cantidad de vueltas registradas
+    uint8_t channel = 0;                 // Canal que se muestra
+    uint32_t running = 0;                // Canales corriendo
+    uint32_t alarms = 0;                 // Canales cuyo descanso terminó (notificación de controlTask)
+    bool alarm_shown = false;            // El aviso de fin de descanso tapa la línea de vueltas
+    uint32_t alarm_lap_number = 0;       // Vuelta y canal mostrados al aparecer el aviso, lo borra cualquier cambio
+    uint8_t alarm_channel = 0;
+    escena_dibujo_t drawn;               // Resultado del dibujo de la escena en el cuadro
+    uint32_t changed_digits = ALL_DIGITS; // Dígitos que la escena todavía no dibujó (forzar el primer dibujado)
+    uint32_t fps_frames = 0;             // Cuadros dibujados en la ventana de medición actual
+    int64_t fps_window_start = esp_timer_get_time();
+    int64_t stats_logged = fps_window_start;
+
+    // Creación de la escena (Sección Crítica Inicial de pantalla, Protejo solo con xMutexPantalla)
     if (xSemaphoreTake(xMutexPantalla, portMAX_DELAY) == pdTRUE) {
-        ESP_LOGI(TAG, "Creando paneles de dígitos...");
-        // Crea panel minutos (2 dígitos)
-        panel_minutes = CrearPanel(PANEL_MIN_X + OFFSET_X, PANEL_Y_MIN, 2, DIGITO_ALTO, DIGITO_ANCHO, DIGITO_ENCENDIDO,
-                                   DIGITO_APAGADO, DIGITO_FONDO);
-        // Crea panel segundos (2 dígitos)
-        panel_seconds = CrearPanel(PANEL_SEC_X + OFFSET_X, PANEL_Y_MIN, 2,DIGITO_ALTO, DIGITO_ANCHO, DIGITO_ENCENDIDO,
-                                   DIGITO_APAGADO, DIGITO_FONDO);
-        // Crea panel décimas (1 dígito visual)
-        panel_decimas = CrearPanel(PANEL_DEC_X + OFFSET_X, PANEL_Y_DEC, 1,DIGITO_ALTO, DIGITO_ANCHO, DIGITO_ENCENDIDO,
-                                   DIGITO_APAGADO, DIGITO_FONDO);
-
-        if (!panel_minutes || !panel_seconds || !panel_decimas) {
-            ESP_LOGE(TAG, "¡Error Crítico! No se pudieron crear los paneles de dígitos.");
+        ESP_LOGI(TAG, "Creando la escena de la pantalla...");
+        if (!build_scene()) {
+            ESP_LOGE(TAG, "¡Error Crítico! No se pudieron crear los elementos de la pantalla.");
             xSemaphoreGive(xMutexPantalla); // Libero Mutex
             vTaskDelete(NULL);              // Terminar esta tarea
             return;                         // Asegura que no continúe si vTaskDelete falla por alguna razón
         } else {
-            ESP_LOGI(TAG, "Paneles creados exitosamente.");
+            ESP_LOGI(TAG, "Escena creada exitosamente.");
         }
-        xSemaphoreGive(xMutexPantalla); // Liberar Mutex después de crear paneles
+        xSemaphoreGive(xMutexPantalla); // Liberar Mutex después de crear la escena
     } else {
-        ESP_LOGE(TAG, "DisplayTask: Fallo crítico al tomar Mutex de pantalla para crear paneles!");
+        ESP_LOGE(TAG, "DisplayTask: Fallo crítico al tomar Mutex de pantalla para crear la escena!");
         vTaskDelete(NULL); // Terminar esta tarea
         return;
     }
-    // --- Fin Creación de Paneles ---
+    // --- Fin Creación de la escena ---
 
     // --- Bucle Principal de Actualización ---
+    TickType_t last_wake = xTaskGetTickCount();
     while (1) {
+        int64_t frame_start = esp_timer_get_time();
+
         // 1. Leer estado compartido y verificar reset (Sección Crítica de ESTADO)
         // Uso xMutexEstado
         if (xSemaphoreTake(xMutexEstado, portMAX_DELAY) == pdTRUE) {
             // Leer y potencialmente modificar variables de estado
-            display_value_decimas = decimas; // Copiar valor actual
+            // El valor se calcula a partir del tiempo medido, no se cuenta con un timer
+            channel = selectedChannel;
             perform_reset = resetPressedWhileStopped; // Copiar flag de reset
 
             if (perform_reset) {
-                decimas = 0;                   // Resetear contador global
-                display_value_decimas = 0;       // Actualizar copia local inmediato
+                uint8_t target = resetChannel;
+                CronometroReiniciar(target);    // Resetear contador del canal
+                TemporizadorCancelar(rest_timers[target]);
+                VueltasVaciar(lap_logs[target]); // Descartar las vueltas (bajo xMutexEstado, igual que al agregarlas)
+                session_id++;                  // Las vueltas siguientes pertenecen a una sesión nueva
+                log_event(target, REGISTRO_REINICIO, 0);
                 resetPressedWhileStopped = false; // Limpiar flag de solicitud global
-                ESP_LOGI(TAG, "[DSP] Contador reseteado a 0 por solicitud.");
-                initial_draw_needed = true; // Forzar redibujo completo a 00:00.0
+                BitacoraEscribir(EVT_CHANNEL_RESET, target + 1, 0);
+                if (target == channel) {
+                    alarm_shown = false; // El reset borra el aviso de fin de descanso
+                }
             }
+            // Una sola lectura de todos los canales por cuadro para el canal elegido y los indicadores
+            CronometroTranscurridos(elapsed);
+            sampled_at = esp_timer_get_time();
+            elapsed_us = elapsed[channel];
+            lap_number = CronometroVueltas(channel);
+            running = CronometroCanalesCorriendo();
+            LatenciaMarcar(LATENCIA_LECTURA, sampled_at); // Sin efecto si no hay un evento nuevo
             xSemaphoreGive(xMutexEstado); // Liberar Mutex de Estado
         } else {
             ESP_LOGE(TAG, "DisplayTask: Fallo al tomar Mutex de estado para leer/resetear!");
@@ -342,68 +921,72 @@ void displayTask(void * pvParameters) {
         }
         // --- Fin Sección Crítica (Lectura) ---
 
-        // 2. Calcular valores MM:SS.D a partir de la copia local
-        uint32_t total_tenths = display_value_decimas;
-        uint32_t mins = (total_tenths / 10) / 60;   // Total segundos / 60
-        uint32_t secs = (total_tenths / 10) % 60;   // Resto de segundos
-        uint32_t d = total_tenths % 10;             // Resto de décimas
-        uint8_t min_Decena = (mins / 10) % 10;      // Asegurar que no exceda 9
-        uint8_t min_Unidad = mins % 10;
-        uint8_t sec_Decena = secs / 10;
-        uint8_t sec_Unidad = secs % 10;
-        uint8_t Decima_Unidad = d;
+        // El aviso de fin de descanso queda hasta la próxima vuelta, reset o cambio de canal
+        if (alarms) {
+            char text[32];
+            snprintf(text, sizeof(text), "Canal %d: fin descanso", __builtin_ctz(alarms) + 1);
+            ElementoTexto(rest_label, text);
+            alarm_shown = true;
+            alarm_lap_number = lap_number;
+            alarm_channel = channel;
+            alarms = 0;
+        } else if (lap_number != alarm_lap_number || channel != alarm_channel) {
+            alarm_shown = false;
+        }
+        ElementoVisible(lap_list, !alarm_shown);
+        ElementoVisible(rest_label, alarm_shown);
+        ElementoVueltas(lap_list, lap_logs[channel], lap_number);
+
+        // Cada indicador es el mismo sprite con la paleta del estado del canal
+        for (uint8_t marker = 0; marker < CRONOMETRO_CANALES; marker++) {
+            const uint16_t palette[4] = {
+                DIGITO_FONDO,
+                (marker == channel) ? CH_SELECTED : DIGITO_FONDO,
+                (running & (1UL << marker)) ? DIGITO_ENCENDIDO : (elapsed[marker] ? CH_PAUSED : DIGITO_APAGADO),
+            };
+            ElementoPaleta(channel_markers[marker], palette);
+        }
 
         // 3. Dibujar en pantalla (Sección Crítica de PANTALLA)
         // Uso xMutexPantalla solo para las operaciones de dibujo
         if (xSemaphoreTake(xMutexPantalla, portMAX_DELAY) == pdTRUE) {
+            LatenciaMarcar(LATENCIA_PANTALLA, esp_timer_get_time());
+
+            // 2. Calcular los dígitos para el instante en que el último dígito que cambia llegue a la pantalla
+            int64_t landing = project_digits(elapsed_us, sampled_at, running & (1UL << channel), segment_us_x16,
+                                             &changed_digits, &shown_us);
+            const uint8_t * digits = ContadorDigitos(display_counter);
+            for (uint8_t group = 0; group < DIGIT_GROUPS; group++) {
+                if (changed_digits & digit_groups[group].mask) {
+                    ElementoDigitos(digit_groups[group].widget, &digits[digit_groups[group].first]);
+                }
+            }
 
-            // Realizar el dibujo inicial o si se reseteo
-            if (initial_draw_needed) {
-                // Limpiar/Dibujar todo a 0
-                DibujarDigito(panel_minutes, 0, 0); Digitos_Visualizados[0] = 0;
-                DibujarDigito(panel_minutes, 1, 0); Digitos_Visualizados[1] = 0;
-                DibujarDigito(panel_seconds, 0, 0); Digitos_Visualizados[2] = 0;
-                DibujarDigito(panel_seconds, 1, 0); Digitos_Visualizados[3] = 0;
-                DibujarDigito(panel_decimas, 0, 0); Digitos_Visualizados[4] = 0;
-
-                // Dibujar separadores (estado inicial apagado o como prefieras)
-                ILI9341DrawFilledCircle(SEP1_X + OFFSET_X, SEP_Y1, SEP_RADIUS, DIGITO_ENCENDIDO); // O APAGADO? Decide el estado inicial
-                ILI9341DrawFilledCircle(SEP1_X + OFFSET_X, SEP_Y2, SEP_RADIUS, DIGITO_ENCENDIDO); // O APAGADO?
-                //ILI9341DrawFilledCircle(SEP2_X + OFFSET_X, SEP_Y_DEC, SEP_RADIUS, DIGITO_APAGADO); // Separador décimas si lo hubiera
-
-                initial_draw_needed = false;
-                ESP_LOGD(TAG, "[DSP] Dibujo inicial/reset realizado.");
-            } else {
-                 // Actualizar solo los dígitos que cambiaron
-                 if (Digitos_Visualizados[0] != min_Decena) {
-                    DibujarDigito(panel_minutes, 0, min_Decena);
-                    Digitos_Visualizados[0] = min_Decena;
-                 }
-                 if (Digitos_Visualizados[1] != min_Unidad) {
-                    DibujarDigito(panel_minutes, 1, min_Unidad);
-                    Digitos_Visualizados[1] = min_Unidad;
-                 }
-                 if (Digitos_Visualizados[2] != sec_Decena) {
-                    DibujarDigito(panel_seconds, 0, sec_Decena);
-                    Digitos_Visualizados[2] = sec_Decena;
-                 }
-                 if (Digitos_Visualizados[3] != sec_Unidad) {
-                    DibujarDigito(panel_seconds, 1, sec_Unidad);
-                    Digitos_Visualizados[3] = sec_Unidad;
-                 }
-
-                 if (Digitos_Visualizados[4] != Decima_Unidad) {
-                    // Log para depurar el error de timeout del Mutex. Corregido
-                    // ESP_LOGD(TAG, "[DSP] Update Decima: %d -> %d", Digitos_Visualizados[4], Decima_Unidad); 
-                    DibujarDigito(panel_decimas, 0, Decima_Unidad);
-                    Digitos_Visualizados[4] = Decima_Unidad;
-                 }
+            // Dibujar solo lo que cambió, los dígitos mientras quede presupuesto de bus en el cuadro
+            EscenaDibujar(scene, frame_start + FRAME_BUDGET_US, &drawn);
+            // La latencia termina con el primer dígito que cambió, aunque antes se hayan dibujado textos o indicadores.
+            // Un evento que no cambia ningún dígito no completa su traza
+            if (drawn.primer_digito) {
+                LatenciaMarcar(LATENCIA_PIXEL, drawn.primer_digito); // Solo cuenta el primer dibujo del evento
             }
 
-             if (initial_draw_needed) { // Dibujar solo la primera vez o en reset
-                 ILI9341DrawFilledCircle(SEP1_X + OFFSET_X, SEP_Y1, SEP_RADIUS, DIGITO_ENCENDIDO);
-                 ILI9341DrawFilledCircle(SEP1_X + OFFSET_X, SEP_Y2, SEP_RADIUS, DIGITO_ENCENDIDO);
-             }
+            // Actualizar el promedio del tiempo por segmento con la duración medida (peso 1/8)
+            if (drawn.segmentos) {
+                int32_t sample_x16 = (drawn.segmentos_us * 16) / drawn.segmentos;
+                segment_us_x16 += (sample_x16 - (int32_t)segment_us_x16) / 8;
+            }
+            if (!drawn.completo) {
+                render_stats.partial++; // Los dígitos restantes se dibujan en el próximo cuadro
+            } else {
+                changed_digits = 0;
+                if (landing && drawn.fin_digitos) {
+                    // Error de la proyección: diferencia entre el instante estimado y el real de la última escritura
+                    uint32_t error = llabs(drawn.fin_digitos - landing);
+                    if (error > render_stats.worst_projection_us) {
+                        render_stats.worst_projection_us = error;
+                    }
+                }
+            }
 
             xSemaphoreGive(xMutexPantalla); // Liberar Mutex de Pantalla después de dibujar
         } else {
@@ -411,31 +994,275 @@ void displayTask(void * pvParameters) {
         }
         // --- Fin Sección Crítica (Dibujo) ---
 
-        // 4. Esperar antes de la próxima actualización
-        // Sincronizar con la resolución del timer es una buena práctica
-        // Actualizar un poco más rápido que el timer para asegurar que se vea el cambio de décima a tiempo.
-        vTaskDelay(pdMS_TO_TICKS(TIMER_PERIOD_MS / 2));
+        // 4. Estadísticas del renderizador
+        int64_t frame_end = esp_timer_get_time();
+        uint32_t frame_us = frame_end - frame_start;
+        render_stats.frames++;
+        if (frame_us > render_stats.worst_frame_us) {
+            render_stats.worst_frame_us = frame_us;
+        }
+        fps_frames++;
+        if (frame_end - fps_window_start >= 1000000) {
+            render_stats.fps_x10 = (fps_frames * 10000000ULL) / (frame_end - fps_window_start);
+            fps_frames = 0;
+            fps_window_start = frame_end;
+        }
+        if (frame_end - stats_logged >= STATS_LOG_MS * 1000LL) {
+            ESP_LOGI(TAG, "[DSP] %" PRIu32 ".%" PRIu32 " fps, %" PRIu32 " cuadros descartados, %" PRIu32
+                     " incompletos, peor cuadro %" PRIu32 " us, error de proyección %" PRIu32 " us",
+                     render_stats.fps_x10 / 10, render_stats.fps_x10 % 10, render_stats.dropped, render_stats.partial,
+                     render_stats.worst_frame_us, render_stats.worst_projection_us);
+            stats_logged = frame_end;
+        }
+
+        // 5. Esperar el próximo cuadro. Si ya pasó, se descartan los cuadros perdidos en lugar de recuperarlos
+        if (xTaskDelayUntil(&last_wake, FRAME_PERIOD_TICKS) == pdFALSE) {
+            TickType_t now = xTaskGetTickCount();
+            render_stats.dropped += (now - last_wake) / FRAME_PERIOD_TICKS;
+            last_wake = now;
+        }
+        // Recoger los avisos de fin de descanso sin esperar, se muestran en el próximo cuadro
+        xTaskNotifyWait(0, UINT32_MAX, &alarms, 0);
+        if (alarms & NOTIFY_REDRAW) { // La pantalla se usó para otra cosa, por ejemplo la prueba del comando imagen
+            EscenaInvalidarArea(scene, 0, 0, ILI9341_HEIGHT - 1, ILI9341_WIDTH - 1); // Se dibuja en el próximo cuadro
+            changed_digits = ALL_DIGITS;
+            alarms &= ~NOTIFY_REDRAW;
+        }
+    }
+}
+
+
+//--- Tarea de fondo para escribir el registro en la memoria flash ---
+// Los borrados y escrituras de la flash detienen la caché, por eso se agrupan en lotes y se hacen
+// desde una tarea de baja prioridad. El tiempo medido no se ve afectado porque se calcula con el timer de hardware
+void registroTask(void * pvParameters) {
+    ESP_LOGI(TAG, "Inicio Tarea: registroTask");
+    bool failed = false;
+    while (1) {
+        vTaskDelay(pdMS_TO_TICKS(LOG_COMMIT_MS));
+        if (xSemaphoreTake(xMutexRegistro, portMAX_DELAY) == pdTRUE) {
+            registro_estadisticas_t stats;
+            RegistroConfirmar(event_log);
+            RegistroEstadisticas(event_log, &stats);
+            xSemaphoreGive(xMutexRegistro);
+            // El registro deja de escribir tras varias fallas seguidas de la flash, se avisa una sola vez
+            if (stats.fallas >= REGISTRO_MAXIMO_FALLAS && !failed) {
+                ESP_LOGE(TAG, "Fallas seguidas al escribir la partición del registro, los eventos no se guardarán.");
+            }
+            failed = stats.fallas >= REGISTRO_MAXIMO_FALLAS;
+        }
+    }
+}
+
+// Comando de consola "bus": tráfico enviado a la pantalla y bytes por segundo desde la consulta anterior.
+// "bus reiniciar" pone los contadores en cero
+static int bus_command(int argc, char ** argv) {
+    static ili9341_stats_t previous;
+    static int64_t previous_time = 0;
+    ili9341_stats_t current;
+    int64_t now = esp_timer_get_time();
+
+    if (argc > 1 && strcmp(argv[1], "reiniciar") == 0) {
+        ILI9341ResetStats(lcd);
+        memset(&previous, 0, sizeof(previous));
+        previous_time = now;
+        return 0;
+    }
+
+    ILI9341GetStats(lcd, &current);
+    printf("Comandos: %" PRIu32 ", transacciones de datos: %" PRIu32 ", bytes: %" PRIu64 "\n", current.commands,
+           current.data_transactions, current.bytes);
+    printf("Ventanas: %" PRIu32 " (%" PRIu32 " repetidas)\n", current.window_sets, current.redundant_window_sets);
+    if (previous_time != 0 && now > previous_time && current.bytes >= previous.bytes) {
+        printf("Tráfico: %" PRIu64 " bytes/s en los últimos %" PRId64 " ms\n",
+               (current.bytes - previous.bytes) * 1000000 / (now - previous_time), (now - previous_time) / 1000);
+    }
+    previous = current;
+    previous_time = now;
+    return 0;
+}
+
+// Comando de consola "latencia": percentiles del tiempo desde el flanco de un botón hasta cada etapa del camino a la
+// pantalla, "latencia reiniciar" descarta las mediciones
+static int latencia_command(int argc, char ** argv) {
+    static const char * const stages[LATENCIA_ETAPAS] = {
+        [LATENCIA_BOTON] = "antirrebote", [LATENCIA_ESTADO] = "estado",     [LATENCIA_LECTURA] = "lectura",
+        [LATENCIA_PANTALLA] = "pantalla", [LATENCIA_PIXEL] = "pixel",
+    };
+
+    if (argc > 1 && strcmp(argv[1], "reiniciar") == 0) {
+        LatenciaReiniciar();
+        return 0;
+    }
+
+    printf("Eventos medidos: %" PRIu32 "\n", LatenciaCantidad());
+    printf("%-12s %10s %10s %10s\n", "etapa", "p50 us", "p99 us", "max us");
+    for (int stage = LATENCIA_BOTON; stage < LATENCIA_ETAPAS; stage++) {
+        printf("%-12s %10" PRIu64 " %10" PRIu64 " %10" PRIu64 "\n", stages[stage], LatenciaPercentil(stage, 500),
+               LatenciaPercentil(stage, 990), LatenciaMaximo(stage));
+    }
+    return 0;
+}
+
+// Comando de consola "barreras": cortes ignorados por el bloqueo y cortes perdidos por no poder esperar al lazo de
+// control, que significan un tiempo de carrera perdido
+static int barreras_command(int argc, char ** argv) {
+    for (int gate = 0; gate < GATE_COUNT; gate++) {
+        if (gates[gate] == NULL) {
+            printf("Barrera %d (GPIO %d): no configurada\n", gate + 1, gate_config[gate].pin);
+            continue;
+        }
+        printf("Barrera %d (GPIO %d): %" PRIu32 " cortes bloqueados, %u perdidos\n", gate + 1, gate_config[gate].pin,
+               BarreraDescartados(gates[gate]), atomic_load_explicit(&gate_cuts[gate].lost, memory_order_relaxed));
     }
+    return 0;
+}
+
+// Comando de consola "imagen": copia a la pantalla una imagen guardada en la memoria flash y compara la velocidad
+// obtenida con la del reloj del bus. Al terminar se redibuja la pantalla
+#define BENCH_WIDTH  320
+#define BENCH_HEIGHT 48
+#define BENCH_FRAMES 10
+static int imagen_command(int argc, char ** argv) {
+    static const uint16_t pattern[BENCH_WIDTH * BENCH_HEIGHT] = {0}; // Negro, queda en la flash por ser constante
+    uint64_t bytes = (uint64_t)BENCH_FRAMES * BENCH_WIDTH * ILI9341_WIDTH * 2;
+
+    xSemaphoreTake(xMutexPantalla, portMAX_DELAY);
+    int64_t start = esp_timer_get_time();
+    for (int frame = 0; frame < BENCH_FRAMES; frame++) {
+        for (int y = 0; y < ILI9341_WIDTH; y += BENCH_HEIGHT) { // En horizontal el alto es ILI9341_WIDTH
+            ILI9341DrawPicture(lcd, 0, y, BENCH_WIDTH, BENCH_HEIGHT, (const uint8_t *)pattern);
+        }
+    }
+    int64_t elapsed = esp_timer_get_time() - start;
+    xSemaphoreGive(xMutexPantalla);
+    xTaskNotify(display_task, NOTIFY_REDRAW, eSetBits);
+
+    uint32_t achieved = bytes * 1000 / elapsed; // Kilobytes por segundo (bytes por milisegundo)
+    uint32_t theoretical = ILI9341GetBusClock(lcd) / 1000 * ILI9341GetBusWidth(lcd) / 8; // Bits por ciclo de reloj
+    printf("%d cuadros de %dx%d en %" PRId64 " ms: %" PRIu32 ".%03" PRIu32 " MB/s\n", BENCH_FRAMES, BENCH_WIDTH,
+           ILI9341_WIDTH, elapsed / 1000, achieved / 1000, achieved % 1000);
+    printf("Bus de %u bits a %" PRIu32 " MHz: %" PRIu32 ".%03" PRIu32 " MB/s teóricos, %" PRIu32 "%% aprovechado\n",
+           ILI9341GetBusWidth(lcd), ILI9341GetBusClock(lcd) / 1000000, theoretical / 1000, theoretical % 1000,
+           achieved * 100 / theoretical);
+    return 0;
+}
+
+// Comando de consola "tareas": uso de procesador y pila libre de cada tarea en las últimas muestras del monitor
+static int tareas_command(int argc, char ** argv) {
+    MonitorVolcar();
+    return 0;
 }
 
+// Muestra una deriva en partes por mil millones como partes por millón con tres decimales
+static void print_drift(const char * label, int32_t ppb) {
+    int32_t magnitude = ppb < 0 ? -ppb : ppb;
+    printf("%s: %c%" PRId32 ".%03" PRId32 " ppm\n", label, ppb < 0 ? '-' : '+', magnitude / 1000, magnitude % 1000);
+}
+
+// Aplica una corrección de la deriva a los tiempos del cronómetro, incluso a los de los canales que están corriendo
+static void apply_drift(int32_t ppb) {
+    xSemaphoreTake(xMutexEstado, portMAX_DELAY);
+    CronometroCorregir(ppb);
+    xSemaphoreGive(xMutexEstado);
+    drift_ppb = ppb;
+}
+
+// Comando de consola "calibrar": mide la deriva del cristal contra el pulso de referencia conectado a PPS_PIN.
+// "calibrar iniciar" comienza la medición, sin argumentos muestra el avance, "calibrar guardar" termina la medición
+// y guarda el resultado en la memoria no volátil. Sin pulso de referencia, "calibrar fijar <ppm>" guarda la deriva
+// obtenida comparando contra otro cronómetro de confianza y "calibrar borrar" quita la corrección
+static int calibrar_command(int argc, char ** argv) {
+    static bool measuring = false;
+    int32_t ppb = 0;
+
+    if (argc == 1) {
+        print_drift("Corrección aplicada", drift_ppb);
+        if (measuring) {
+            printf("Midiendo: %" PRIu32 " s de referencia, %" PRIu32 " pulsos descartados\n", CalibracionSegundos(),
+                   CalibracionDescartados());
+            if (CalibracionResultado(&ppb)) {
+                print_drift("Deriva medida", ppb);
+            } else {
+                printf("Se necesitan al menos %d s para un resultado\n", CALIBRACION_MINIMO_S);
+            }
+        }
+        return 0;
+    }
+    if (strcmp(argv[1], "iniciar") == 0) {
+        if (!pps_ready) {
+            printf("La entrada del pulso de referencia (GPIO %d) no está configurada\n", PPS_PIN);
+            return 1;
+        }
+        CalibracionIniciar();
+        gpio_intr_enable(PPS_PIN);
+        measuring = true;
+        return 0;
+    } else if (strcmp(argv[1], "guardar") == 0) {
+        if (!measuring || !CalibracionResultado(&ppb)) {
+            printf("No hay una medición válida\n");
+            return 1;
+        }
+        gpio_intr_disable(PPS_PIN);
+        measuring = false;
+    } else if (strcmp(argv[1], "fijar") == 0 && argc > 2) {
+        char * end;
+        double ppm = strtod(argv[2], &end);
+        if (*end != '\0' || ppm > CALIBRACION_MAXIMO_PPM || ppm < -CALIBRACION_MAXIMO_PPM) {
+            printf("La deriva debe estar entre -%d y %d ppm\n", CALIBRACION_MAXIMO_PPM, CALIBRACION_MAXIMO_PPM);
+            return 1;
+        }
+        ppb = (int32_t)(ppm * 1000 + (ppm < 0 ? -0.5 : 0.5));
+    } else if (strcmp(argv[1], "borrar") != 0) {
+        printf("Uso: calibrar [iniciar | guardar | fijar <ppm> | borrar]\n");
+        return 1;
+    }
+
+    if (!CalibracionGuardar(ppb)) {
+        printf("No se pudo guardar la corrección, se aplica hasta el próximo reinicio\n");
+    }
+    apply_drift(ppb);
+    print_drift("Corrección aplicada", drift_ppb);
+    return 0;
+}
 
-// Se ejecuta periódicamente para incrementar el contador
-// Callback del Timer de FreeRTOS (Uso xMutexEstado)
-void timerCallback(TimerHandle_t xTimer) {
-    bool should_increment = false;
-    // Intentar tomar el mutex de ESTADO (muy rápido)
-    // CAMBIO: Usar xMutexEstado, no xMutexPantalla
-    if (xSemaphoreTake(xMutexEstado, pdMS_TO_TICKS(5)) == pdTRUE) {
-        // Leer isRunning DENTRO del mutex
-        should_increment = isRunning;
-        if (should_increment) { // Solo incrementar si el cronómetro está activo
-            decimas++;
-            // re pensar una lógica de overflow si es necesario (if -> decimas > MAX_VALUE)
-        }
-        xSemaphoreGive(xMutexEstado); // Liberar Mutex de Estado
+#if PERFIL_HABILITADO
+// Comando de consola "perfil": muestra el tiempo de cada primitiva de dibujo, "perfil reiniciar" lo pone en cero
+static int perfil_command(int argc, char ** argv) {
+    if (argc > 1 && strcmp(argv[1], "reiniciar") == 0) {
+        PerfilReiniciar();
     } else {
-        ESP_LOGW(TAG, "Timer CB: Fallo al tomar xMutexEstado!");
+        PerfilVolcar();
+    }
+    return 0;
+}
+#endif
+
+// Guarda el estado del cronómetro en la memoria RTC y duerme hasta que se presione Start/Stop
+// Si el cronómetro está corriendo sigue contando: al despertar se suma el tiempo dormido medido por el RTC
+static void enter_deep_sleep(void) {
+    // Tomar ambos mutex para que ninguna tarea modifique el estado ni dibuje mientras se suspende
+    xSemaphoreTake(xMutexEstado, portMAX_DELAY);
+    xSemaphoreTake(xMutexPantalla, portMAX_DELAY);
+
+    // Escribir en la flash los eventos que todavía estén pendientes
+    if (event_log && xSemaphoreTake(xMutexRegistro, portMAX_DELAY) == pdTRUE) {
+        RegistroConfirmar(event_log);
     }
+
+    CronometroSuspender();
+    ILI9341Sleep(lcd); // La pantalla conserva la imagen hasta que al despertar se redibuja toda la escena
+
+    IndicadorApagar(green_led);
+    IndicadorApagar(red_led);
+
+    // Despertar con Start/Stop (nivel bajo). Durante el sueño solo funciona el pull-up del dominio RTC
+    rtc_gpio_pullup_en(PB_Run_Stop);
+    rtc_gpio_pulldown_dis(PB_Run_Stop);
+    esp_sleep_enable_ext0_wakeup(PB_Run_Stop, 0);
+
+    ESP_LOGI(TAG, "[SYS] Sueño profundo, presionar Start/Stop para despertar.");
+    esp_deep_sleep_start();
 }
 
 //--- Función Principal de la Aplicación (app_main) ---
@@ -443,9 +1270,28 @@ void app_main(void) {
     ESP_LOGI(TAG, " === Inicio Aplicación Cronómetro FreeRTOS Curso ESE ===");
 
     // 1. Inicializar Hardware Básico
-    configure_gpios();                  // Configurar pines para botones y LEDs
-    ILI9341Init();                      // Inicializar controlador de pantalla y bus SPI
-    ILI9341Rotate(ILI9341_Landscape_1); // Roto la pantalla
+    configure_gpios(); // Configurar pines para botones y LEDs
+
+    // Recuperar el estado del cronómetro de la memoria RTC. Si se vuelve de un sueño profundo la pantalla
+    // todavía muestra la imagen anterior y no se la borra, asi la reanudación parece instantánea
+    const ili9341_config_t lcd_config = ILI9341_DEFAULT_CONFIG();
+    bool restored = CronometroRestaurar();
+    if (CalibracionCargar(&drift_ppb)) {
+        CronometroCorregir(drift_ppb); // Deriva del cristal calibrada con el comando "calibrar"
+        ESP_LOGI(TAG, "Corrección de la deriva del reloj: %" PRId32 " ppb.", drift_ppb);
+    }
+    if (restored && esp_reset_reason() == ESP_RST_DEEPSLEEP) {
+        lcd = ILI9341Resume(&lcd_config); // Sin reiniciarla ni borrarla, muestra la imagen anterior
+        ESP_LOGI(TAG, "Reanudando desde sueño profundo (canales corriendo: 0x%02" PRIx32 ").",
+                 CronometroCanalesCorriendo());
+    } else {
+        lcd = ILI9341Init(&lcd_config); // Inicializar controlador de pantalla y bus SPI
+    }
+    if (lcd == NULL) {
+        ESP_LOGE(TAG, "¡Error Crítico! No se pudo inicializar la pantalla.");
+        abort();
+    }
+    ILI9341Rotate(lcd, ILI9341_Landscape_1); // Roto la pantalla
     ESP_LOGI(TAG, "Hardware Básico Inicializado (GPIOs, SPI, ILI9341).");
 
     // 2. Crear los Mutex (Fundamental para la sincronización)
@@ -462,58 +1308,136 @@ void app_main(void) {
         vSemaphoreDelete(xMutexPantalla);
         abort();// Detener ejecución si el mutex no se puede crear
     }
-    ESP_LOGI(TAG, "Mutex de teclado creado correctamente.");
+    ESP_LOGI(TAG, "Mutex de estado creado correctamente.");
 
-    xMutexLed = xSemaphoreCreateMutex();
-    if (xMutexLed == NULL) {
-        ESP_LOGE(TAG, "¡Error Crítico! Creación de Mutex de LED fallida.");
-        vSemaphoreDelete(xMutexPantalla);
-        vSemaphoreDelete(xMutexEstado);
-        abort(); // Detener ejecución si el mutex no se puede crear
+    control_queue = xQueueCreate(CONTROL_QUEUE_LENGTH, sizeof(control_event_t));
+    if (control_queue == NULL) {
+        ESP_LOGE(TAG, "¡Error Crítico! Creación de la cola de eventos fallida.");
+        abort();
+    }
+
+    for (int channel = 0; channel < CRONOMETRO_CANALES; channel++) {
+        lap_logs[channel] = VueltasCrear();
+        if (lap_logs[channel] == NULL) {
+            ESP_LOGE(TAG, "¡Error Crítico! Creación del registro de vueltas fallida.");
+            abort();
+        }
+    }
+
+    // Un único temporizador de hardware atiende todos los vencimientos del lazo de control
+    if (!TemporizadoresIniciar(0)) {
+        ESP_LOGE(TAG, "¡Error Crítico! Inicialización de la rueda de temporizadores fallida.");
+        abort();
+    }
+    for (int channel = 0; channel < CRONOMETRO_CANALES; channel++) {
+        rest_timers[channel] = TemporizadorCrear(post_timer_event, TIMER_EVENT(EV_REST, channel));
+    }
+    hold_timer = TemporizadorCrear(post_timer_event, TIMER_EVENT(EV_HOLD, 0));
+    alarm_timer = TemporizadorCrear(post_timer_event, TIMER_EVENT(EV_ALARM_END, 0));
+
+    // Se parte del nivel actual para no tomar como pulsación el botón que despertó al equipo
+    uint32_t samples[INPUT_REGISTERS];
+    read_inputs(samples);
+    for (int reg = 0; reg < INPUT_REGISTERS; reg++) {
+        uint32_t mask = button_mask(reg);
+        input_groups[reg] = AntirreboteCrear(mask, mask, samples[reg]); // Botones activos en nivel bajo (pull-up)
+    }
+    sample_timer = TemporizadorCrear(post_timer_event, TIMER_EVENT(EV_SAMPLE, 0));
+    gpio_install_isr_service(0);
+    for (int button = 0; button < BTN_COUNT; button++) {
+        gpio_isr_handler_add(button_pins[button], button_isr, (void *)(uintptr_t)button);
+    }
+
+    // El pulso de referencia solo interrumpe mientras se calibra la deriva del reloj
+    gpio_config_t io_conf_pps = {
+        .pin_bit_mask = 1ULL << PPS_PIN,
+        .mode = GPIO_MODE_INPUT,
+        .intr_type = GPIO_INTR_POSEDGE,
+    };
+    if (gpio_config(&io_conf_pps) == ESP_OK && gpio_isr_handler_add(PPS_PIN, pps_isr, NULL) == ESP_OK) {
+        gpio_intr_disable(PPS_PIN);
+        pps_ready = true;
+    } else {
+        ESP_LOGW(TAG, "No se pudo configurar la entrada del pulso de referencia (GPIO %d).", PPS_PIN);
+    }
+
+    // Las barreras de luz no son imprescindibles: sin el periférico de captura se sigue solo con los botones
+    if (BarrerasIniciar(0)) {
+        for (int gate = 0; gate < GATE_COUNT; gate++) {
+            gates[gate] = BarreraCrear(gate_config[gate].pin, GATE_EDGES, GATE_LOCKOUT_MS * 1000, gate_isr,
+                                       (void *)(uintptr_t)gate);
+            if (gates[gate] == NULL) {
+                ESP_LOGW(TAG, "No se pudo configurar la barrera %d (GPIO %d).", gate + 1, gate_config[gate].pin);
+            }
+        }
+    } else {
+        ESP_LOGW(TAG, "Periférico de captura no disponible, las barreras de luz no funcionarán.");
+    }
+
+    // El registro persistente no es imprescindible: si falta la partición se sigue sin guardar eventos
+    xMutexRegistro = xSemaphoreCreateMutex();
+    event_log = RegistroMontarParticion(LOG_PARTITION);
+    if (event_log == NULL || xMutexRegistro == NULL) {
+        ESP_LOGW(TAG, "Registro en flash no disponible, los eventos no se guardarán.");
+        event_log = NULL;
+    } else {
+        registro_evento_t last;
+        if (RegistroUltimo(event_log, &last)) {
+            session_id = last.sesion; // Continuar la sesión en curso antes del reinicio
+        }
+        ESP_LOGI(TAG, "Registro montado: %" PRIu32 " eventos, sesión %" PRIu32 ".", RegistroCantidad(event_log),
+                 session_id);
     }
-    ESP_LOGI(TAG, "Mutex de LED creado correctamente.");
 
     // 3. Crear las Tareas de la Aplicación
     ESP_LOGI(TAG, "Creando tareas...");
     BaseType_t task_status;
-    task_status = xTaskCreate(tecladoTask, "TecladoTask", TASK_STACK_SIZE_MEDIUM, NULL, TASK_PRIORITY_MEDIUM, NULL);
-    if (task_status != pdPASS) {
-        ESP_LOGE(TAG, "Fallo al crear tecladoTask!");
+    // La bitácora se vacía con la prioridad de las tareas de fondo para no competir con el camino de medición
+    if (!BitacoraIniciar(TAG, event_texts, EVT_COUNT, TASK_PRIORITY_IDLE)) {
+        ESP_LOGE(TAG, "Fallo al crear la tarea de la bitácora!");
         abort();
     }
-
-    task_status = xTaskCreate(Manejo_LEDTask, "ManejoLEDTask", TASK_STACK_SIZE_MEDIUM, NULL, TASK_PRIORITY_LOW, NULL);
+    // El lazo de control tiene más prioridad que el renderizador para que los botones no esperen un cuadro
+    task_status = xTaskCreate(controlTask, "ControlTask", TASK_STACK_SIZE_MEDIUM, NULL, TASK_PRIORITY_HIGH, NULL);
     if (task_status != pdPASS) {
-        ESP_LOGE(TAG, "Fallo al crear Manejo_LEDTask!");
+        ESP_LOGE(TAG, "Fallo al crear controlTask!");
         abort();
     }
 
-    task_status = xTaskCreate(displayTask, "DisplayTask", TASK_STACK_SIZE_LARGE, NULL, TASK_PRIORITY_MEDIUM, NULL);
+    task_status = xTaskCreate(displayTask, "DisplayTask", TASK_STACK_SIZE_LARGE, NULL, TASK_PRIORITY_MEDIUM, &display_task);
     if (task_status != pdPASS) {
         ESP_LOGE(TAG, "Fallo al crear displayTask!");
         abort();
     }
+    if (event_log) {
+        task_status = xTaskCreate(registroTask, "RegistroTask", TASK_STACK_SIZE_MEDIUM, NULL, TASK_PRIORITY_IDLE, NULL);
+        if (task_status != pdPASS) {
+            ESP_LOGE(TAG, "Fallo al crear registroTask!");
+            abort();
+        }
+    }
     ESP_LOGI(TAG, "Tareas creadas.");
 
-    // 4. Crear e Iniciar el Timer Periódico para el Cronómetro
-    ESP_LOGI(TAG, "Creo e inicio el timer del cronómetro...");
-    TimerHandle_t xStopwatchTimer = xTimerCreate("CronometroTimer",              // Nombre para debugging
-                                                 pdMS_TO_TICKS(TIMER_PERIOD_MS), // Periodo en ticks
-                                                 pdTRUE,       // Auto-recarga habilitada (es periódico)
-                                                 (void *)0,    // ID del timer (no se usa aquí)
-                                                 timerCallback // Función a llamar cada periodo
-    );
-
-    if (xStopwatchTimer == NULL) {
-        ESP_LOGE(TAG, "¡Error Crítico! Creación del Timer fallida.");
-        abort(); // Detener si el timer no se puede crear
-    } else {
-        if (xTimerStart(xStopwatchTimer, 0) != pdPASS) {
-            ESP_LOGE(TAG, "¡Error Crítico! No se pudo iniciar el Timer.");
-            abort(); // Detener si el timer no arranca
-        } else {
-            ESP_LOGI(TAG, "Timer del cronómetro iniciado (Periodo: %d ms).", TIMER_PERIOD_MS);
+    // 4. Consola de diagnóstico por el puerto serie y monitor de tareas (no son imprescindibles para el cronómetro)
+    bool monitor = MonitorIniciar();
+    if (!monitor) {
+        ESP_LOGW(TAG, "No se pudo iniciar el monitor de tareas.");
+    }
+    if (ConsolaIniciar()) {
+        ConsolaRegistrar("bus", "Tráfico enviado a la pantalla y bytes por segundo [reiniciar]", bus_command);
+        ConsolaRegistrar("latencia", "Latencia desde los botones hasta la pantalla [reiniciar]", latencia_command);
+        ConsolaRegistrar("barreras", "Cortes bloqueados y perdidos de cada barrera de luz", barreras_command);
+        ConsolaRegistrar("imagen", "Velocidad de copia de una imagen de la flash a la pantalla", imagen_command);
+        ConsolaRegistrar("calibrar", "Deriva del reloj contra un pulso de referencia [iniciar|guardar|fijar|borrar]",
+                         calibrar_command);
+        if (monitor) {
+            ConsolaRegistrar("tareas", "Uso de procesador y pila libre de cada tarea", tareas_command);
         }
+#if PERFIL_HABILITADO
+        ConsolaRegistrar("perfil", "Tiempo de las primitivas de dibujo [reiniciar]", perfil_command);
+#endif
+    } else {
+        ESP_LOGW(TAG, "No se pudo iniciar la consola.");
     }
 
     ESP_LOGI(TAG, "=== Sistema Inicializado y Corriendo ===");
@@ -0,0 +1,203 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+/** @file monitor.c
+ ** @brief Definiciones del monitor de uso de procesador y de pila de las tareas
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include "monitor.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+/* === Macros definitions ========================================================================================== */
+
+#define PRIORIDAD 1    //!< Prioridad de la tarea del monitor, apenas por encima de la tarea inactiva
+#define PILA      2048 //!< Tamaño de la pila de la tarea del monitor
+
+/* === Private data type declarations ============================================================================== */
+
+//! @brief Historia de una tarea
+struct tarea_s {
+    TaskHandle_t tarea;                  //!< Tarea seguida, NULL si la entrada está libre
+    char nombre[configMAX_TASK_NAME_LEN]; //!< Copia del nombre, la tarea puede terminar antes de mostrarlo
+    uint32_t ejecucion;                  //!< Contador de tiempo de ejecución en la muestra anterior
+    uint16_t uso[MONITOR_VENTANA];       //!< Uso del procesador de cada muestra en décimas de porcentaje
+    uint8_t muestras;                    //!< Cantidad de muestras válidas en la ventana
+    bool presente;                       //!< La tarea apareció en la última muestra
+    uint32_t pila_libre;                 //!< Mínimo de pila libre desde la creación de la tarea
+    UBaseType_t prioridad;               //!< Prioridad actual
+    BaseType_t nucleo;                   //!< Núcleo al que está fijada la tarea
+};
+
+/* === Private variable declarations =============================================================================== */
+
+/* === Private function declarations =============================================================================== */
+
+/**
+ * @brief Función que toma una muestra de todas las tareas
+ */
+static void Muestrear(void);
+
+/**
+ * @brief Tarea que toma las muestras periódicamente
+ *
+ * @param  parametros  No se utiliza
+ */
+static void MonitorTask(void * parametros);
+
+/* === Public variable definitions ================================================================================= */
+
+/* === Private variable definitions ================================================================================ */
+
+//! @brief Historia de las tareas seguidas
+static struct tarea_s tareas[MONITOR_TAREAS];
+
+//! @brief Estado de todas las tareas en la muestra actual
+static TaskStatus_t estados[MONITOR_TAREAS];
+
+//! @brief Tiempo de ejecución total en la muestra anterior
+static uint32_t total_anterior;
+
+//! @brief Posición de la ventana donde se guarda la próxima muestra, común a todas las tareas
+static uint8_t posicion;
+
+//! @brief Protege la historia, que la escribe el monitor y la lee la consola
+static SemaphoreHandle_t cerrojo;
+
+/* === Private function definitions ================================================================================ */
+
+static void Muestrear(void) {
+    uint32_t total;
+    UBaseType_t cantidad = uxTaskGetSystemState(estados, MONITOR_TAREAS, &total);
+
+    /* Si hay más tareas que lugares uxTaskGetSystemState no devuelve ninguna, se conserva la historia anterior */
+    if (cantidad == 0) {
+        return;
+    }
+
+    /* El contador total avanza una vez por núcleo, cada tarea solo mientras se ejecuta en alguno de ellos */
+    uint32_t periodo = (total - total_anterior) * portNUM_PROCESSORS;
+    bool primera = (total_anterior == 0);
+    total_anterior = total;
+
+    xSemaphoreTake(cerrojo, portMAX_DELAY);
+    for (int indice = 0; indice < MONITOR_TAREAS; indice++) {
+        tareas[indice].presente = false;
+    }
+    for (UBaseType_t actual = 0; actual < cantidad; actual++) {
+        TaskStatus_t * estado = &estados[actual];
+        struct tarea_s * self = NULL;
+        struct tarea_s * libre = NULL;
+
+        for (int indice = 0; indice < MONITOR_TAREAS; indice++) {
+            if (tareas[indice].tarea == estado->xHandle) {
+                self = &tareas[indice];
+                break;
+            } else if (libre == NULL && tareas[indice].tarea == NULL) {
+                libre = &tareas[indice];
+            }
+        }
+        if (self == NULL) {
+            if (libre == NULL) {
+                continue;
+            }
+            /* Tarea nueva: su primera muestra solo sirve como referencia del contador de ejecución */
+            self = libre;
+            memset(self, 0, sizeof(*self));
+            self->tarea = estado->xHandle;
+            strncpy(self->nombre, estado->pcTaskName, sizeof(self->nombre) - 1);
+        } else {
+            if (!primera && periodo) {
+                uint32_t uso = ((uint64_t)(estado->ulRunTimeCounter - self->ejecucion) * 1000) / periodo;
+                self->uso[posicion] = (uso > 1000) ? 1000 : uso;
+                if (self->muestras < MONITOR_VENTANA) {
+                    self->muestras++;
+                }
+            }
+        }
+        self->presente = true;
+        self->ejecucion = estado->ulRunTimeCounter;
+        self->pila_libre = estado->usStackHighWaterMark;
+        self->prioridad = estado->uxCurrentPriority;
+        self->nucleo = estado->xCoreID;
+    }
+    for (int indice = 0; indice < MONITOR_TAREAS; indice++) {
+        if (!tareas[indice].presente) {
+            tareas[indice].tarea = NULL; // La tarea terminó, se libera su lugar
+        }
+    }
+    posicion = (posicion + 1) % MONITOR_VENTANA;
+    xSemaphoreGive(cerrojo);
+}
+
+static void MonitorTask(void * parametros) {
+    TickType_t ultimo = xTaskGetTickCount();
+
+    while (1) {
+        Muestrear();
+        xTaskDelayUntil(&ultimo, pdMS_TO_TICKS(MONITOR_PERIODO_MS));
+    }
+}
+
+/* === Public function implementation ============================================================================== */
+
+bool MonitorIniciar(void) {
+    cerrojo = xSemaphoreCreateMutex();
+    if (cerrojo == NULL) {
+        return false;
+    }
+    return xTaskCreate(MonitorTask, "MonitorTask", PILA, NULL, PRIORIDAD, NULL) == pdPASS;
+}
+
+void MonitorVolcar(void) {
+    static struct tarea_s copia[MONITOR_TAREAS];
+
+    /* Se copia la historia para no retener al monitor mientras se escribe por el puerto serie */
+    xSemaphoreTake(cerrojo, portMAX_DELAY);
+    memcpy(copia, tareas, sizeof(copia));
+    xSemaphoreGive(cerrojo);
+
+    printf("%-16s %6s %4s %8s %8s %10s\n", "tarea", "nucleo", "prio", "cpu prom", "cpu max", "pila libre");
+    for (int indice = 0; indice < MONITOR_TAREAS; indice++) {
+        struct tarea_s * self = &copia[indice];
+        uint32_t suma = 0, maximo = 0;
+
+        if (self->tarea == NULL) {
+            continue;
+        }
+        /* La ventana es común a todas las tareas, las muestras válidas de una tarea son las últimas que se tomaron */
+        for (uint8_t muestra = 1; muestra <= self->muestras; muestra++) {
+            uint16_t uso = self->uso[(posicion + MONITOR_VENTANA - muestra) % MONITOR_VENTANA];
+            suma += uso;
+            maximo = (uso > maximo) ? uso : maximo;
+        }
+        uint32_t promedio = self->muestras ? suma / self->muestras : 0;
+        printf("%-16s %6s %4u %6" PRIu32 ".%" PRIu32 "%% %6" PRIu32 ".%" PRIu32 "%% %10" PRIu32 "\n", self->nombre,
+               (self->nucleo == 0) ? "0" : (self->nucleo == 1) ? "1" : "-", (unsigned)self->prioridad, promedio / 10,
+               promedio % 10, maximo / 10, maximo % 10, self->pila_libre);
+    }
+}
+
+/* === End of documentation ======================================================================================== */
@@ -0,0 +1,90 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+#ifndef MONITOR_H_
+#define MONITOR_H_
+
+/** @file monitor.h
+ ** @brief Declaraciones del monitor de uso de procesador y de pila de las tareas
+ **
+ ** Una tarea de baja prioridad toma cada @ref MONITOR_PERIODO_MS una muestra de las estadísticas de ejecución de
+ ** FreeRTOS y guarda, para cada tarea, el uso del procesador en ese período dentro de una ventana circular de
+ ** @ref MONITOR_VENTANA muestras y el mínimo de pila libre desde su creación. Con estos datos se puede ajustar el
+ ** tamaño de la pila de cada tarea.
+ **
+ ** Requiere CONFIG_FREERTOS_USE_TRACE_FACILITY, CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS y, para el núcleo de cada
+ ** tarea, CONFIG_FREERTOS_VTASKLIST_INCLUDE_COREID en la configuración (ver sdkconfig.defaults).
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include <stdbool.h>
+
+/* === Cabecera C++ ================================================================================================ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* === Public macros definitions =================================================================================== */
+
+//! @brief Período de muestreo en milisegundos
+#ifndef MONITOR_PERIODO_MS
+#define MONITOR_PERIODO_MS 1000
+#endif
+
+//! @brief Cantidad de muestras que se conservan de cada tarea
+#ifndef MONITOR_VENTANA
+#define MONITOR_VENTANA 10
+#endif
+
+//! @brief Cantidad máxima de tareas que se siguen, incluidas las del sistema
+#ifndef MONITOR_TAREAS
+#define MONITOR_TAREAS 24
+#endif
+
+/* === Public data type declarations =============================================================================== */
+
+/* === Public variable declarations ================================================================================ */
+
+/* === Public function declarations ================================================================================ */
+
+/**
+ * @brief Función que crea la tarea del monitor con la prioridad más baja por encima de la tarea inactiva
+ *
+ * @return true   El monitor está funcionando
+ * @return false  No se pudo crear la tarea
+ */
+bool MonitorIniciar(void);
+
+/**
+ * @brief Función que muestra por la salida estándar el uso de procesador y de pila de cada tarea
+ *
+ * Para cada tarea informa el promedio y el máximo del uso de procesador en la ventana, como porcentaje de la
+ * capacidad de todos los núcleos, y la menor cantidad de bytes de pila que quedaron libres.
+ */
+void MonitorVolcar(void);
+
+/* === End of documentation ======================================================================================== */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MONITOR_H_ */
@@ -0,0 +1,178 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+/** @file perfil.c
+ ** @brief Definiciones de las zonas de perfilado de las primitivas de dibujo
+ **
+ ** Una tarea puede ser desalojada mientras actualiza una zona y otra tarea del mismo núcleo actualizar la misma
+ ** zona, por eso los campos se actualizan con operaciones atómicas. Como cada núcleo escribe solo en su tabla esas
+ ** operaciones nunca compiten entre núcleos. El total se guarda en dos palabras de 32 bits para no depender de
+ ** operaciones atómicas de 64 bits, que en el ESP32 se implementan con secciones críticas.
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include "perfil.h"
+
+#if PERFIL_HABILITADO
+
+#include "esp_cpu.h"
+#include "esp_rom_sys.h"
+#include "freertos/FreeRTOS.h"
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <stdio.h>
+
+/* === Macros definitions ========================================================================================== */
+
+#define CASILLEROS 32 //!< Casilleros del histograma, uno por potencia de dos de la duración en ciclos
+
+/* === Private data type declarations ============================================================================== */
+
+//! @brief Estadísticas de una zona en un núcleo
+struct zona_s {
+    atomic_uint cantidad;               //!< Cantidad de mediciones
+    atomic_uint total_bajo;             //!< Palabra menos significativa del total de ciclos
+    atomic_uint total_alto;             //!< Palabra más significativa del total de ciclos
+    atomic_uint minimo_invertido;       //!< Complemento del mínimo, asi el valor inicial cero no es un mínimo
+    atomic_uint maximo;                 //!< Máximo en ciclos
+    atomic_uint histograma[CASILLEROS]; //!< Casillero n: duraciones entre 2^n y 2^(n+1) - 1 ciclos
+};
+
+/* === Private variable declarations =============================================================================== */
+
+/* === Private function declarations =============================================================================== */
+
+/**
+ * @brief Función que reemplaza un valor si el nuevo es mayor
+ *
+ * @param  valor  Variable a actualizar
+ * @param  nuevo  Valor candidato
+ */
+static void ActualizarMaximo(atomic_uint * valor, uint32_t nuevo);
+
+/* === Public variable definitions ================================================================================= */
+
+/* === Private variable definitions ================================================================================ */
+
+//! @brief Tablas de estadísticas de cada núcleo
+static struct zona_s tablas[portNUM_PROCESSORS][PERFIL_ZONAS];
+
+//! @brief Nombres de las zonas para mostrar en la consola
+static const char * const NOMBRES[PERFIL_ZONAS] = {
+    [PERFIL_CURSOR] = "SetCursorPosition",
+    [PERFIL_FILL] = "Fill",
+    [PERFIL_PIXEL] = "DrawPixel",
+    [PERFIL_CHAR] = "DrawChar",
+    [PERFIL_STRING] = "DrawString",
+    [PERFIL_LINEA] = "DrawLine",
+    [PERFIL_RECTANGULO] = "DrawRectangle",
+    [PERFIL_CIRCULO] = "DrawCircle",
+    [PERFIL_CIRCULO_RELLENO] = "DrawFilledCircle",
+    [PERFIL_IMAGEN] = "DrawPicture",
+    [PERFIL_BLIT] = "BlitCanvas",
+    [PERFIL_IMAGEN_RLE] = "DrawRLEPicture",
+    [PERFIL_SPRITE] = "DrawSprite",
+    [PERFIL_DIGITO] = "DibujarDigito",
+};
+
+/* === Private function definitions ================================================================================ */
+
+static void ActualizarMaximo(atomic_uint * valor, uint32_t nuevo) {
+    unsigned int actual = atomic_load_explicit(valor, memory_order_relaxed);
+    while ((nuevo > actual) &&
+           !atomic_compare_exchange_weak_explicit(valor, &actual, nuevo, memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+/* === Public function implementation ============================================================================== */
+
+void PerfilRegistrar(perfil_zona_t zona, uint32_t ciclos) {
+    struct zona_s * self = &tablas[esp_cpu_get_core_id()][zona];
+
+    atomic_fetch_add_explicit(&self->cantidad, 1, memory_order_relaxed);
+    if (atomic_fetch_add_explicit(&self->total_bajo, ciclos, memory_order_relaxed) + ciclos < ciclos) {
+        atomic_fetch_add_explicit(&self->total_alto, 1, memory_order_relaxed);
+    }
+    ActualizarMaximo(&self->minimo_invertido, ~ciclos);
+    ActualizarMaximo(&self->maximo, ciclos);
+    atomic_fetch_add_explicit(&self->histograma[31 - __builtin_clz(ciclos | 1)], 1, memory_order_relaxed);
+}
+
+void PerfilVolcar(void) {
+    uint32_t ciclos_us = esp_rom_get_cpu_ticks_per_us();
+
+    printf("%-18s %8s %10s %8s %8s %8s  %s\n", "zona", "llamadas", "total us", "min us", "prom us", "max us",
+           "histograma (log2 ciclos:llamadas)");
+    for (int zona = 0; zona < PERFIL_ZONAS; zona++) {
+        uint32_t cantidad = 0, minimo = UINT32_MAX, maximo = 0;
+        uint64_t total = 0;
+        uint32_t histograma[CASILLEROS] = {0};
+
+        for (int nucleo = 0; nucleo < portNUM_PROCESSORS; nucleo++) {
+            struct zona_s * self = &tablas[nucleo][zona];
+            uint32_t n = atomic_load_explicit(&self->cantidad, memory_order_relaxed);
+            if (n == 0) {
+                continue;
+            }
+            cantidad += n;
+            total += ((uint64_t)atomic_load_explicit(&self->total_alto, memory_order_relaxed) << 32) |
+                     atomic_load_explicit(&self->total_bajo, memory_order_relaxed);
+            uint32_t valor = ~atomic_load_explicit(&self->minimo_invertido, memory_order_relaxed);
+            minimo = (valor < minimo) ? valor : minimo;
+            valor = atomic_load_explicit(&self->maximo, memory_order_relaxed);
+            maximo = (valor > maximo) ? valor : maximo;
+            for (int casillero = 0; casillero < CASILLEROS; casillero++) {
+                histograma[casillero] += atomic_load_explicit(&self->histograma[casillero], memory_order_relaxed);
+            }
+        }
+        if (cantidad == 0) {
+            continue;
+        }
+
+        printf("%-18s %8" PRIu32 " %10" PRIu64 " %8" PRIu32 " %8" PRIu64 " %8" PRIu32 " ", NOMBRES[zona], cantidad,
+               total / ciclos_us, minimo / ciclos_us, total / cantidad / ciclos_us, maximo / ciclos_us);
+        for (int casillero = 0; casillero < CASILLEROS; casillero++) {
+            if (histograma[casillero]) {
+                printf(" %d:%" PRIu32, casillero, histograma[casillero]);
+            }
+        }
+        printf("\n");
+    }
+}
+
+void PerfilReiniciar(void) {
+    for (int nucleo = 0; nucleo < portNUM_PROCESSORS; nucleo++) {
+        for (int zona = 0; zona < PERFIL_ZONAS; zona++) {
+            struct zona_s * self = &tablas[nucleo][zona];
+            atomic_store_explicit(&self->cantidad, 0, memory_order_relaxed);
+            atomic_store_explicit(&self->total_bajo, 0, memory_order_relaxed);
+            atomic_store_explicit(&self->total_alto, 0, memory_order_relaxed);
+            atomic_store_explicit(&self->minimo_invertido, 0, memory_order_relaxed);
+            atomic_store_explicit(&self->maximo, 0, memory_order_relaxed);
+            for (int casillero = 0; casillero < CASILLEROS; casillero++) {
+                atomic_store_explicit(&self->histograma[casillero], 0, memory_order_relaxed);
+            }
+        }
+    }
+}
+
+#endif /* PERFIL_HABILITADO */
+
+/* === End of documentation ======================================================================================== */
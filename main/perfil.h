@@ -0,0 +1,116 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+#ifndef PERFIL_H_
+#define PERFIL_H_
+
+/** @file perfil.h
+ ** @brief Declaraciones de las zonas de perfilado de las primitivas de dibujo
+ **
+ ** Cada primitiva de dibujo se encierra entre @ref PERFIL_INICIO y @ref PERFIL_FIN, que miden su duración con el
+ ** contador de ciclos del procesador. Por cada zona se acumulan la cantidad de llamadas, el total, el mínimo, el
+ ** máximo y un histograma con un casillero por potencia de dos. Cada núcleo tiene su propia tabla, por lo que
+ ** registrar una medición no requiere bloqueos ni compite con el otro núcleo.
+ **
+ ** El perfilado se habilita compilando con @ref PERFIL_HABILITADO en uno. En caso contrario las macros no generan
+ ** código y las funciones de esta biblioteca no existen.
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include <stdint.h>
+
+/* === Cabecera C++ ================================================================================================ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* === Public macros definitions =================================================================================== */
+
+//! @brief Habilita la medición de las zonas de perfilado
+#ifndef PERFIL_HABILITADO
+#define PERFIL_HABILITADO 0
+#endif
+
+#if PERFIL_HABILITADO
+#include "esp_cpu.h"
+
+//! @brief Marca el comienzo de una zona, se usa una sola vez por función antes de @ref PERFIL_FIN
+#define PERFIL_INICIO() uint32_t perfil_inicio = esp_cpu_get_cycle_count()
+
+//! @brief Marca el final de una zona y registra su duración
+#define PERFIL_FIN(zona) PerfilRegistrar((zona), esp_cpu_get_cycle_count() - perfil_inicio)
+#else
+#define PERFIL_INICIO()  ((void)0)
+#define PERFIL_FIN(zona) ((void)0)
+#endif
+
+/* === Public data type declarations =============================================================================== */
+
+//! @brief Zonas de perfilado, una por primitiva de dibujo
+typedef enum {
+    PERFIL_CURSOR,          //!< SetCursorPosition
+    PERFIL_FILL,            //!< Fill
+    PERFIL_PIXEL,           //!< ILI9341DrawPixel
+    PERFIL_CHAR,            //!< ILI9341DrawChar
+    PERFIL_STRING,          //!< ILI9341DrawString
+    PERFIL_LINEA,           //!< ILI9341DrawLine
+    PERFIL_RECTANGULO,      //!< ILI9341DrawRectangle
+    PERFIL_CIRCULO,         //!< ILI9341DrawCircle
+    PERFIL_CIRCULO_RELLENO, //!< ILI9341DrawFilledCircle
+    PERFIL_IMAGEN,          //!< ILI9341DrawPicture
+    PERFIL_BLIT,            //!< ILI9341BlitCanvas
+    PERFIL_IMAGEN_RLE,      //!< ILI9341DrawRLEPicture
+    PERFIL_SPRITE,          //!< ILI9341DrawSprite
+    PERFIL_DIGITO,          //!< DibujarDigito
+    PERFIL_ZONAS,           //!< Cantidad de zonas
+} perfil_zona_t;
+
+/* === Public variable declarations ================================================================================ */
+
+/* === Public function declarations ================================================================================ */
+
+#if PERFIL_HABILITADO
+/**
+ * @brief Función que registra una medición en la tabla del núcleo actual
+ *
+ * @param  zona    Zona medida
+ * @param  ciclos  Duración en ciclos del procesador
+ */
+void PerfilRegistrar(perfil_zona_t zona, uint32_t ciclos);
+
+/**
+ * @brief Función que muestra por la consola las estadísticas de todas las zonas, sumando ambos núcleos
+ */
+void PerfilVolcar(void);
+
+/**
+ * @brief Función que pone en cero las estadísticas de todas las zonas
+ */
+void PerfilReiniciar(void);
+#endif
+
+/* === End of documentation ======================================================================================== */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PERFIL_H_ */
@@ -0,0 +1,479 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+/** @file registro.c
+ ** @brief Definiciones del registro persistente de eventos del cronómetro en una partición de la memoria flash
+ **
+ ** Formato de un sector: una cabecera de 16 bytes seguida de eventos de 24 bytes. Los eventos se escriben en orden y
+ ** un evento sin escribir tiene todos sus bytes en 0xFF, por lo que la cantidad de eventos de un sector se obtiene con
+ ** una búsqueda binaria sobre el primer byte de cada evento. Los sectores se usan en orden circular, el sector que
+ ** sigue al activo es siempre el más antiguo.
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include "registro.h"
+#include <stdatomic.h>
+#include <string.h>
+
+#ifdef ESP_PLATFORM
+#include "esp_partition.h"
+#else
+#include <stdio.h>
+#endif
+
+/* === Macros definitions ========================================================================================== */
+
+#define MARCA_SECTOR       0x474F4C56 //!< Identifica un sector del registro ("VLOG")
+#define EVENTO_LIBRE       0xFF       //!< Valor del campo tipo de un evento sin escribir
+#define SIN_SECTOR         UINT32_MAX //!< Indica que todavía no hay un sector activo
+#define EVENTOS_POR_SECTOR ((REGISTRO_SECTOR - sizeof(struct cabecera_s)) / sizeof(struct evento_flash_s))
+#define EVENTOS_POR_LOTE   16         //!< Cantidad máxima de eventos en una operación de escritura
+#define BLOQUE_IMAGEN      256        //!< Bytes que se leen y escriben de una vez en una imagen en un archivo
+
+_Static_assert((REGISTRO_PENDIENTES & (REGISTRO_PENDIENTES - 1)) == 0, "La cola debe ser una potencia de dos");
+
+/* === Private data type declarations ============================================================================== */
+
+//! @brief Cabecera de un sector del registro
+struct cabecera_s {
+    uint32_t marca;     //!< Igual a @ref MARCA_SECTOR
+    uint32_t secuencia; //!< Se incrementa cada vez que se abre un sector, nunca vale cero
+    uint32_t reservado; //!< Queda en 0xFFFFFFFF
+    uint32_t crc;       //!< CRC de los campos anteriores
+};
+
+//! @brief Formato de un evento en la memoria flash
+struct evento_flash_s {
+    uint8_t tipo;
+    uint8_t canal;
+    uint16_t reservado;
+    uint32_t sesion;
+    uint32_t numero;
+    uint32_t crc; //!< CRC de todos los campos del evento, calculado con este campo en cero
+    uint64_t tiempo_us;
+};
+
+_Static_assert(sizeof(struct cabecera_s) == 16, "Cabecera de sector con relleno inesperado");
+_Static_assert(sizeof(struct evento_flash_s) == 24, "Evento con relleno inesperado");
+
+struct registro_s {
+    registro_medio_t medio;                         //!< Medio de almacenamiento
+    uint32_t sectores;                              //!< Cantidad de sectores utilizados
+    uint32_t activo;                                //!< Sector en el que se escriben los eventos
+    uint32_t ultima_secuencia;                      //!< Secuencia del sector activo
+    uint32_t secuencia[REGISTRO_MAXIMO_SECTORES];   //!< Secuencia de cada sector, cero si está libre
+    uint16_t cantidad[REGISTRO_MAXIMO_SECTORES];    //!< Cantidad de eventos escritos en cada sector
+    registro_evento_t pendientes[REGISTRO_PENDIENTES]; //!< Cola de eventos a escribir
+    atomic_uint_fast32_t cabeza;                    //!< Posición de escritura en la cola, solo la modifica el productor
+    atomic_uint_fast32_t cola;                      //!< Posición de lectura en la cola, solo la modifica el consumidor
+    atomic_uint_fast32_t perdidos;                  //!< Eventos descartados con la cola llena
+    uint32_t corruptos;                             //!< Eventos con CRC inválido encontrados al montar
+    uint32_t borrados;                              //!< Sectores borrados desde el montaje
+    uint32_t escrituras;                            //!< Operaciones de escritura desde el montaje
+    uint32_t fallas;                                //!< Escrituras o borrados fallidos seguidos
+};
+
+/* === Private variable declarations =============================================================================== */
+
+/* === Private function declarations =============================================================================== */
+
+/**
+ * @brief Función que calcula el CRC-32 (polinomio 0xEDB88320) de un bloque de datos
+ */
+static uint32_t Crc32(const void * datos, size_t largo);
+
+/**
+ * @brief Función que lee un evento del medio y verifica su CRC
+ */
+static bool LeerEvento(registro_t self, uint32_t sector, uint32_t posicion, registro_evento_t * evento);
+
+/**
+ * @brief Función que borra el sector más antiguo y lo convierte en el sector activo
+ */
+static bool AbrirSector(registro_t self);
+
+/* === Public variable definitions ================================================================================= */
+
+/* === Private variable definitions ================================================================================ */
+
+/* === Private function definitions ================================================================================ */
+
+static uint32_t Crc32(const void * datos, size_t largo) {
+    const uint8_t * byte = datos;
+    uint32_t crc = 0xFFFFFFFF;
+
+    while (largo--) {
+        crc ^= *byte++;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+static uint32_t Direccion(uint32_t sector, uint32_t posicion) {
+    return sector * REGISTRO_SECTOR + sizeof(struct cabecera_s) + posicion * sizeof(struct evento_flash_s);
+}
+
+static bool LeerEvento(registro_t self, uint32_t sector, uint32_t posicion, registro_evento_t * evento) {
+    struct evento_flash_s leido;
+
+    if (self->medio.leer(self->medio.contexto, Direccion(sector, posicion), &leido, sizeof(leido))) {
+        return false;
+    }
+    uint32_t crc = leido.crc;
+    leido.crc = 0;
+    if (Crc32(&leido, sizeof(leido)) != crc) {
+        return false;
+    }
+
+    evento->tipo = leido.tipo;
+    evento->canal = leido.canal;
+    evento->sesion = leido.sesion;
+    evento->numero = leido.numero;
+    evento->tiempo_us = leido.tiempo_us;
+    return true;
+}
+
+static bool AbrirSector(registro_t self) {
+    uint32_t sector = (self->activo == SIN_SECTOR) ? 0 : (self->activo + 1) % self->sectores;
+    struct cabecera_s cabecera = {
+        .marca = MARCA_SECTOR,
+        .secuencia = self->ultima_secuencia + 1,
+        .reservado = UINT32_MAX,
+    };
+    cabecera.crc = Crc32(&cabecera, offsetof(struct cabecera_s, crc));
+
+    /* El sector deja de formar parte del registro antes de borrarlo */
+    self->secuencia[sector] = 0;
+    self->cantidad[sector] = 0;
+    if (self->medio.borrar(self->medio.contexto, sector * REGISTRO_SECTOR, REGISTRO_SECTOR)) {
+        return false;
+    }
+    self->borrados++;
+    if (self->medio.escribir(self->medio.contexto, sector * REGISTRO_SECTOR, &cabecera, sizeof(cabecera))) {
+        return false;
+    }
+    self->escrituras++;
+
+    self->secuencia[sector] = cabecera.secuencia;
+    self->ultima_secuencia = cabecera.secuencia;
+    self->activo = sector;
+    return true;
+}
+
+#ifdef ESP_PLATFORM
+static int LeerParticion(void * contexto, uint32_t direccion, void * datos, size_t largo) {
+    return esp_partition_read(contexto, direccion, datos, largo) != ESP_OK;
+}
+
+static int EscribirParticion(void * contexto, uint32_t direccion, const void * datos, size_t largo) {
+    return esp_partition_write(contexto, direccion, datos, largo) != ESP_OK;
+}
+
+static int BorrarParticion(void * contexto, uint32_t direccion, size_t largo) {
+    return esp_partition_erase_range(contexto, direccion, largo) != ESP_OK;
+}
+#else
+static int LeerImagen(void * contexto, uint32_t direccion, void * datos, size_t largo) {
+    FILE * archivo = contexto;
+    return fseek(archivo, direccion, SEEK_SET) || (fread(datos, 1, largo, archivo) != largo);
+}
+
+static int EscribirImagen(void * contexto, uint32_t direccion, const void * datos, size_t largo) {
+    FILE * archivo = contexto;
+    const uint8_t * nuevos = datos;
+    uint8_t bloque[BLOQUE_IMAGEN];
+
+    while (largo > 0) {
+        size_t parte = (largo < sizeof(bloque)) ? largo : sizeof(bloque);
+        if (fseek(archivo, direccion, SEEK_SET) || (fread(bloque, 1, parte, archivo) != parte)) {
+            return -1;
+        }
+        /* Como en la memoria flash, una escritura solo puede pasar bits de uno a cero */
+        for (size_t indice = 0; indice < parte; indice++) {
+            bloque[indice] &= nuevos[indice];
+        }
+        if (fseek(archivo, direccion, SEEK_SET) || (fwrite(bloque, 1, parte, archivo) != parte)) {
+            return -1;
+        }
+        direccion += parte;
+        nuevos += parte;
+        largo -= parte;
+    }
+    return fflush(archivo);
+}
+
+static int BorrarImagen(void * contexto, uint32_t direccion, size_t largo) {
+    FILE * archivo = contexto;
+    uint8_t bloque[BLOQUE_IMAGEN];
+
+    memset(bloque, 0xFF, sizeof(bloque));
+    if (fseek(archivo, direccion, SEEK_SET)) {
+        return -1;
+    }
+    while (largo > 0) {
+        size_t parte = (largo < sizeof(bloque)) ? largo : sizeof(bloque);
+        if (fwrite(bloque, 1, parte, archivo) != parte) {
+            return -1;
+        }
+        largo -= parte;
+    }
+    return fflush(archivo);
+}
+#endif
+
+/* === Public function implementation ============================================================================== */
+
+registro_t RegistroMontar(const registro_medio_t * medio) {
+    static struct registro_s instancia;
+    registro_t self = &instancia;
+
+    memset(self, 0, sizeof(*self));
+    self->medio = *medio;
+    self->activo = SIN_SECTOR;
+    self->sectores = medio->tamano / REGISTRO_SECTOR;
+    if (self->sectores > REGISTRO_MAXIMO_SECTORES) {
+        self->sectores = REGISTRO_MAXIMO_SECTORES;
+    }
+    if (self->sectores < 2) {
+        return NULL;
+    }
+
+    for (uint32_t sector = 0; sector < self->sectores; sector++) {
+        struct cabecera_s cabecera;
+        if (medio->leer(medio->contexto, sector * REGISTRO_SECTOR, &cabecera, sizeof(cabecera)) ||
+            (cabecera.marca != MARCA_SECTOR) || (cabecera.secuencia == 0) ||
+            (cabecera.crc != Crc32(&cabecera, offsetof(struct cabecera_s, crc)))) {
+            continue;
+        }
+
+        /* Búsqueda binaria del primer evento sin escribir */
+        uint32_t desde = 0, hasta = EVENTOS_POR_SECTOR;
+        while (desde < hasta) {
+            uint32_t medio_rango = (desde + hasta) / 2;
+            uint8_t tipo;
+            if (medio->leer(medio->contexto, Direccion(sector, medio_rango), &tipo, sizeof(tipo)) ||
+                (tipo == EVENTO_LIBRE)) {
+                hasta = medio_rango;
+            } else {
+                desde = medio_rango + 1;
+            }
+        }
+
+        self->secuencia[sector] = cabecera.secuencia;
+        self->cantidad[sector] = desde;
+        if (cabecera.secuencia > self->ultima_secuencia) {
+            self->ultima_secuencia = cabecera.secuencia;
+            self->activo = sector;
+        }
+    }
+
+    /* Un corte de energía solo puede dejar eventos incompletos al final del sector activo */
+    if (self->activo != SIN_SECTOR) {
+        registro_evento_t evento;
+        for (uint32_t posicion = 0; posicion < self->cantidad[self->activo]; posicion++) {
+            if (!LeerEvento(self, self->activo, posicion, &evento)) {
+                self->corruptos++;
+            }
+        }
+    }
+    return self;
+}
+
+#ifdef ESP_PLATFORM
+registro_t RegistroMontarParticion(const char * etiqueta) {
+    const esp_partition_t * particion =
+        esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, etiqueta);
+    if (particion == NULL) {
+        return NULL;
+    }
+
+    registro_medio_t medio = {
+        .leer = LeerParticion,
+        .escribir = EscribirParticion,
+        .borrar = BorrarParticion,
+        .contexto = (void *)particion,
+        .tamano = particion->size,
+    };
+    return RegistroMontar(&medio);
+}
+#else
+bool RegistroAbrirImagen(registro_medio_t * medio, const char * ruta, uint32_t tamano) {
+    FILE * archivo = fopen(ruta, "r+b");
+    if (archivo == NULL) {
+        archivo = fopen(ruta, "w+b");
+    }
+    if (archivo == NULL) {
+        return false;
+    }
+
+    /* Una imagen nueva o más corta se completa como si estuviera borrada */
+    long largo = (fseek(archivo, 0, SEEK_END) == 0) ? ftell(archivo) : -1;
+    if ((largo < 0) || ((largo < tamano) && BorrarImagen(archivo, largo, tamano - largo))) {
+        fclose(archivo);
+        return false;
+    }
+
+    *medio = (registro_medio_t){
+        .leer = LeerImagen,
+        .escribir = EscribirImagen,
+        .borrar = BorrarImagen,
+        .contexto = archivo,
+        .tamano = tamano,
+    };
+    return true;
+}
+
+void RegistroCerrarImagen(registro_medio_t * medio) {
+    if (medio->contexto) {
+        fclose(medio->contexto);
+        medio->contexto = NULL;
+    }
+}
+#endif
+
+bool RegistroAgregar(registro_t self, const registro_evento_t * evento) {
+    uint32_t cabeza = atomic_load_explicit(&self->cabeza, memory_order_relaxed);
+
+    if (cabeza - atomic_load_explicit(&self->cola, memory_order_acquire) >= REGISTRO_PENDIENTES) {
+        atomic_fetch_add_explicit(&self->perdidos, 1, memory_order_relaxed);
+        return false;
+    }
+    self->pendientes[cabeza % REGISTRO_PENDIENTES] = *evento;
+    atomic_store_explicit(&self->cabeza, cabeza + 1, memory_order_release);
+    return true;
+}
+
+uint32_t RegistroConfirmar(registro_t self) {
+    uint32_t cola = atomic_load_explicit(&self->cola, memory_order_relaxed);
+    uint32_t cabeza = atomic_load_explicit(&self->cabeza, memory_order_acquire);
+    uint32_t escritos = 0;
+
+    while ((cola != cabeza) && (self->fallas < REGISTRO_MAXIMO_FALLAS)) {
+        if ((self->activo == SIN_SECTOR) || (self->cantidad[self->activo] >= EVENTOS_POR_SECTOR)) {
+            if (!AbrirSector(self)) {
+                self->fallas++;
+                break;
+            }
+        }
+
+        uint32_t lote = cabeza - cola;
+        if (lote > EVENTOS_POR_SECTOR - self->cantidad[self->activo]) {
+            lote = EVENTOS_POR_SECTOR - self->cantidad[self->activo];
+        }
+        if (lote > EVENTOS_POR_LOTE) {
+            lote = EVENTOS_POR_LOTE;
+        }
+
+        struct evento_flash_s datos[EVENTOS_POR_LOTE];
+        for (uint32_t indice = 0; indice < lote; indice++) {
+            const registro_evento_t * evento = &self->pendientes[(cola + indice) % REGISTRO_PENDIENTES];
+            datos[indice] = (struct evento_flash_s){
+                .tipo = evento->tipo,
+                .canal = evento->canal,
+                .reservado = UINT16_MAX,
+                .sesion = evento->sesion,
+                .numero = evento->numero,
+                .crc = 0,
+                .tiempo_us = evento->tiempo_us,
+            };
+            datos[indice].crc = Crc32(&datos[indice], sizeof(datos[indice]));
+        }
+
+        if (self->medio.escribir(self->medio.contexto, Direccion(self->activo, self->cantidad[self->activo]), datos,
+                                 lote * sizeof(datos[0]))) {
+            /* Se descarta el espacio, una escritura parcial no se puede volver a escribir */
+            self->cantidad[self->activo] = EVENTOS_POR_SECTOR;
+            self->fallas++;
+            continue;
+        }
+        self->fallas = 0;
+        self->escrituras++;
+        self->cantidad[self->activo] += lote;
+        cola += lote;
+        escritos += lote;
+        atomic_store_explicit(&self->cola, cola, memory_order_release);
+    }
+    return escritos;
+}
+
+uint32_t RegistroCantidad(registro_t self) {
+    uint32_t cantidad = 0;
+
+    for (uint32_t sector = 0; sector < self->sectores; sector++) {
+        if (self->secuencia[sector]) {
+            cantidad += self->cantidad[sector];
+        }
+    }
+    return cantidad;
+}
+
+bool RegistroLeer(registro_t self, uint32_t indice, registro_evento_t * evento) {
+    if (self->activo == SIN_SECTOR) {
+        return false;
+    }
+
+    /* Recorrer los sectores desde el más antiguo, que es el siguiente al activo */
+    for (uint32_t paso = 1; paso <= self->sectores; paso++) {
+        uint32_t sector = (self->activo + paso) % self->sectores;
+        if (self->secuencia[sector] == 0) {
+            continue;
+        }
+        if (indice < self->cantidad[sector]) {
+            return LeerEvento(self, sector, indice, evento);
+        }
+        indice -= self->cantidad[sector];
+    }
+    return false;
+}
+
+bool RegistroUltimo(registro_t self, registro_evento_t * evento) {
+    if (self->activo == SIN_SECTOR) {
+        return false;
+    }
+
+    /* Recorrer los sectores desde el activo hacia atrás */
+    for (uint32_t paso = 0; paso < self->sectores; paso++) {
+        uint32_t sector = (self->activo + self->sectores - paso) % self->sectores;
+        if (self->secuencia[sector] == 0) {
+            continue;
+        }
+        for (uint32_t posicion = self->cantidad[sector]; posicion > 0; posicion--) {
+            if (LeerEvento(self, sector, posicion - 1, evento)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void RegistroEstadisticas(registro_t self, registro_estadisticas_t * estadisticas) {
+    estadisticas->eventos = RegistroCantidad(self);
+    estadisticas->pendientes = atomic_load_explicit(&self->cabeza, memory_order_acquire) -
+                               atomic_load_explicit(&self->cola, memory_order_acquire);
+    estadisticas->perdidos = atomic_load_explicit(&self->perdidos, memory_order_relaxed);
+    estadisticas->corruptos = self->corruptos;
+    estadisticas->borrados = self->borrados;
+    estadisticas->escrituras = self->escrituras;
+    estadisticas->fallas = self->fallas;
+}
+
+/* === End of documentation ======================================================================================== */
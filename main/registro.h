@@ -0,0 +1,232 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+#ifndef REGISTRO_H_
+#define REGISTRO_H_
+
+/** @file registro.h
+ ** @brief Declaraciones del registro persistente de eventos del cronómetro en una partición de la memoria flash
+ **
+ ** Los eventos se agregan al final de un registro circular formado por los sectores de la partición. Cada sector
+ ** comienza con una cabecera con número de secuencia y cada evento tiene su propio CRC, por lo que un corte de energía
+ ** durante una escritura solo invalida el evento que se estaba escribiendo. Al llenarse la partición se borra el
+ ** sector más antiguo, de modo que el desgaste se reparte uniformemente entre todos los sectores.
+ **
+ ** @ref RegistroAgregar solo copia el evento a una cola en memoria y se puede llamar desde el camino de medición. La
+ ** escritura y el borrado de la memoria flash se realizan en lotes al llamar a @ref RegistroConfirmar desde una tarea
+ ** de baja prioridad. Ambas funciones pueden ser llamadas concurrentemente por un único productor y un único
+ ** consumidor; el resto de las funciones deben llamarse desde el mismo contexto que @ref RegistroConfirmar.
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* === Cabecera C++ ================================================================================================ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* === Public macros definitions =================================================================================== */
+
+//! @brief Cantidad de eventos que se pueden acumular en memoria entre dos confirmaciones
+#ifndef REGISTRO_PENDIENTES
+#define REGISTRO_PENDIENTES 64
+#endif
+
+//! @brief Cantidad máxima de sectores de la partición que se utilizan
+#ifndef REGISTRO_MAXIMO_SECTORES
+#define REGISTRO_MAXIMO_SECTORES 64
+#endif
+
+//! @brief Cantidad de fallas seguidas del medio tras las que se deja de escribir, para no borrar todo el registro
+#ifndef REGISTRO_MAXIMO_FALLAS
+#define REGISTRO_MAXIMO_FALLAS 2
+#endif
+
+//! @brief Tamaño de un sector de la memoria flash, es la unidad mínima de borrado
+#define REGISTRO_SECTOR 4096
+
+/* === Public data type declarations =============================================================================== */
+
+//! @brief Tipos de eventos que se guardan en el registro
+typedef enum {
+    REGISTRO_VUELTA = 1,    //!< Se registró una vuelta
+    REGISTRO_ARRANQUE = 2,  //!< El cronómetro comenzó a correr
+    REGISTRO_DETENCION = 3, //!< El cronómetro se detuvo
+    REGISTRO_REINICIO = 4,  //!< El cronómetro se puso en cero, comienza una sesión nueva
+} registro_tipo_t;
+
+//! @brief Evento guardado en el registro
+typedef struct {
+    uint8_t tipo;       //!< Tipo de evento, uno de los valores de @ref registro_tipo_t
+    uint8_t canal;      //!< Canal del cronómetro que generó el evento
+    uint32_t sesion;    //!< Número de sesión, se incrementa con cada reinicio
+    uint32_t numero;    //!< Número de vuelta, cero para los eventos que no son vueltas
+    uint64_t tiempo_us; //!< Tiempo del cronómetro en el momento del evento, en microsegundos
+} registro_evento_t;
+
+/**
+ * @brief Operaciones sobre el medio de almacenamiento
+ *
+ * Permite utilizar el registro sobre una partición de la memoria flash o sobre una imagen de la partición en un
+ * archivo cuando se compila para la computadora de desarrollo. Las direcciones son relativas al comienzo del medio.
+ * Las funciones devuelven cero si la operación fue exitosa.
+ */
+typedef struct {
+    int (*leer)(void * contexto, uint32_t direccion, void * datos, size_t largo);
+    int (*escribir)(void * contexto, uint32_t direccion, const void * datos, size_t largo);
+    int (*borrar)(void * contexto, uint32_t direccion, size_t largo); //!< Pone en 0xFF sectores completos
+    void * contexto;                                                    //!< Parámetro para las funciones anteriores
+    uint32_t tamano;                                                    //!< Tamaño del medio en bytes
+} registro_medio_t;
+
+//! @brief Estadísticas del registro
+typedef struct {
+    uint32_t eventos;    //!< Cantidad de eventos válidos guardados en la memoria flash
+    uint32_t pendientes; //!< Cantidad de eventos esperando ser escritos
+    uint32_t perdidos;   //!< Eventos descartados porque la cola de pendientes estaba llena
+    uint32_t corruptos;  //!< Eventos con CRC inválido encontrados durante el montaje
+    uint32_t borrados;   //!< Cantidad de sectores borrados desde el montaje
+    uint32_t escrituras; //!< Cantidad de operaciones de escritura desde el montaje
+    uint32_t fallas;     //!< Escrituras o borrados fallidos seguidos, vuelve a cero con una escritura exitosa
+} registro_estadisticas_t;
+
+//! @brief Tipo de dato para referenciar a un registro de eventos
+typedef struct registro_s * registro_t;
+
+/* === Public variable declarations ================================================================================ */
+
+/* === Public function declarations ================================================================================ */
+
+/**
+ * @brief Función que monta el registro sobre un medio de almacenamiento
+ *
+ * Lee la cabecera de cada sector para encontrar el más reciente y reconstruye el índice en memoria. Los sectores con
+ * una cabecera inválida se consideran libres.
+ *
+ * @param  medio      Operaciones sobre el medio de almacenamiento, se copia en el registro
+ * @return registro_t Puntero al registro montado o NULL si el medio no es adecuado
+ */
+registro_t RegistroMontar(const registro_medio_t * medio);
+
+#ifdef ESP_PLATFORM
+/**
+ * @brief Función que monta el registro sobre una partición de datos de la memoria flash
+ *
+ * @param  etiqueta   Nombre de la partición en la tabla de particiones
+ * @return registro_t Puntero al registro montado o NULL si la partición no existe
+ */
+registro_t RegistroMontarParticion(const char * etiqueta);
+#else
+/**
+ * @brief Función que prepara un medio de almacenamiento sobre una imagen de la partición en un archivo
+ *
+ * Si el archivo no existe o es más corto se completa con 0xFF, como una memoria flash borrada. Las escrituras solo
+ * pueden pasar bits de uno a cero, igual que en la memoria flash, así una escritura sobre un evento ya escrito o un
+ * corte simulado a mitad de una escritura dejan la imagen en el mismo estado que quedaría la partición.
+ *
+ * @param[out] medio  Operaciones sobre la imagen, para usar con @ref RegistroMontar
+ * @param  ruta       Nombre del archivo con la imagen
+ * @param  tamano     Tamaño de la imagen en bytes
+ * @return true       La imagen quedó abierta
+ * @return false      No se pudo abrir o completar el archivo
+ */
+bool RegistroAbrirImagen(registro_medio_t * medio, const char * ruta, uint32_t tamano);
+
+/**
+ * @brief Función que cierra la imagen abierta con @ref RegistroAbrirImagen
+ *
+ * @param  medio  Medio preparado con @ref RegistroAbrirImagen
+ */
+void RegistroCerrarImagen(registro_medio_t * medio);
+#endif
+
+/**
+ * @brief Función que agrega un evento a la cola de escritura
+ *
+ * No accede a la memoria flash, el evento se guarda al llamar a @ref RegistroConfirmar.
+ *
+ * @param  self    Puntero al registro creado con @ref RegistroMontar
+ * @param  evento  Evento a agregar
+ * @return true    El evento se agregó a la cola
+ * @return false   La cola estaba llena y el evento se descartó
+ */
+bool RegistroAgregar(registro_t self, const registro_evento_t * evento);
+
+/**
+ * @brief Función que escribe en la memoria flash los eventos pendientes
+ *
+ * Los eventos se escriben en la menor cantidad de operaciones posible. Si es necesario abrir un sector nuevo se borra
+ * el sector más antiguo. Una escritura fallida descarta el resto del sector activo y se reintenta en el siguiente,
+ * pero después de @ref REGISTRO_MAXIMO_FALLAS fallas seguidas el registro deja de acceder al medio: una memoria dañada
+ * o protegida contra escritura no borra todos los sectores y los eventos nuevos se descartan al llenarse la cola.
+ *
+ * @param  self      Puntero al registro creado con @ref RegistroMontar
+ * @return uint32_t  Cantidad de eventos escritos
+ */
+uint32_t RegistroConfirmar(registro_t self);
+
+/**
+ * @brief Función que devuelve la cantidad de eventos guardados en la memoria flash
+ *
+ * @param  self      Puntero al registro creado con @ref RegistroMontar
+ * @return uint32_t  Cantidad de eventos que se pueden leer, incluyendo los eventos con CRC inválido
+ */
+uint32_t RegistroCantidad(registro_t self);
+
+/**
+ * @brief Función que lee un evento guardado en la memoria flash
+ *
+ * @param  self    Puntero al registro creado con @ref RegistroMontar
+ * @param  indice  Índice del evento, cero es el evento más antiguo que se conserva
+ * @param  evento  Puntero donde se devuelve el evento leído
+ * @return true    El evento se leyó correctamente
+ * @return false   El índice no existe o el evento tiene un CRC inválido
+ */
+bool RegistroLeer(registro_t self, uint32_t indice, registro_evento_t * evento);
+
+/**
+ * @brief Función que devuelve el último evento guardado en la memoria flash
+ *
+ * @param  self    Puntero al registro creado con @ref RegistroMontar
+ * @param  evento  Puntero donde se devuelve el evento leído
+ * @return true    Se encontró un evento válido
+ * @return false   El registro está vacío
+ */
+bool RegistroUltimo(registro_t self, registro_evento_t * evento);
+
+/**
+ * @brief Función que devuelve las estadísticas del registro
+ *
+ * @param  self         Puntero al registro creado con @ref RegistroMontar
+ * @param  estadisticas Puntero donde se devuelven las estadísticas
+ */
+void RegistroEstadisticas(registro_t self, registro_estadisticas_t * estadisticas);
+
+/* === End of documentation ======================================================================================== */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* REGISTRO_H_ */
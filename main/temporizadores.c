@@ -0,0 +1,488 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+/** @file temporizadores.c
+ ** @brief Definiciones de los temporizadores de cuenta regresiva y alarmas sobre una rueda jerárquica
+ **
+ ** @c actual es el próximo tic que se debe procesar. Un temporizador que vence dentro de los 64 tics siguientes se
+ ** guarda en el casillero del primer nivel que corresponde a su tic de vencimiento. Si vence más adelante se guarda
+ ** en el nivel más bajo que lo alcanza, en el casillero que se redistribuye justo antes de su vencimiento. El nivel n
+ ** se redistribuye cuando el tic procesado es múltiplo de 64 elevado a n.
+ **
+ ** Cada nivel tiene un mapa de bits con los casilleros ocupados, con el que se calcula el próximo tic en que hay algo
+ ** que hacer. Los tics sin trabajo se saltean, tanto al avanzar la rueda como al programar el temporizador de
+ ** hardware.
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include "temporizadores.h"
+#include <stddef.h>
+
+#ifdef ESP_PLATFORM
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#endif
+
+/* === Macros definitions ========================================================================================== */
+
+#define BITS_NIVEL      6                       //!< Bits del tic que corresponden a cada nivel
+#define CASILLEROS      (1 << BITS_NIVEL)       //!< Casilleros de cada nivel
+#define MASCARA_NIVEL   (CASILLEROS - 1)        //!< Máscara para obtener el casillero de un nivel
+#define ALCANCE         (1ULL << (BITS_NIVEL * TEMPORIZADORES_NIVELES)) //!< Tics que cubre la rueda completa
+#define NIVEL_VENCIDOS  0xFF                    //!< Nivel de los temporizadores vencidos que esperan su aviso
+#define NINGUNO         UINT64_MAX              //!< Indica que no hay un vencimiento
+
+/* === Private data type declarations ============================================================================== */
+
+//! @brief Enlace de una lista circular doblemente enlazada
+struct enlace_s {
+    struct enlace_s * siguiente;
+    struct enlace_s * anterior;
+};
+
+//! @brief Estados de un temporizador
+typedef enum {
+    LIBRE = 0, //!< No fue asignado por @ref TemporizadorCrear
+    DESARMADO, //!< Asignado pero sin vencimiento pendiente
+    ARMADO,    //!< En uno de los casilleros de la rueda
+    VENCIDO,   //!< En la lista de vencidos, esperando que se llame a su aviso
+} estado_t;
+
+struct temporizador_s {
+    struct enlace_s enlace;       //!< Enlace en la lista del casillero, debe ser el primer campo
+    temporizador_aviso_t aviso;   //!< Función que se llama al vencer
+    void * contexto;              //!< Parámetro de la función de aviso
+    uint64_t vence;               //!< Tic del próximo vencimiento
+    uint32_t periodo;             //!< Tics entre vencimientos, cero si es de un solo disparo
+    uint8_t nivel;                //!< Nivel de la rueda en el que está guardado
+    uint8_t casillero;            //!< Casillero del nivel en el que está guardado
+    uint8_t estado;               //!< Uno de los valores de @ref estado_t
+};
+
+/* === Private variable declarations =============================================================================== */
+
+/* === Private function declarations =============================================================================== */
+
+/**
+ * @brief Función que toma el acceso exclusivo a la rueda
+ */
+static void Bloquear(void);
+
+/**
+ * @brief Función que libera el acceso exclusivo a la rueda
+ */
+static void Desbloquear(void);
+
+/**
+ * @brief Función que devuelve el tic actual
+ *
+ * @return uint64_t  Tic actual según el reloj de alta resolución, o el último tic procesado en la computadora de
+ *                   desarrollo
+ */
+static uint64_t Ahora(void);
+
+/**
+ * @brief Función que agrega un temporizador al final de una lista
+ *
+ * @param lista  Cabecera de la lista
+ * @param self   Temporizador a agregar
+ */
+static void Enlazar(struct enlace_s * lista, temporizador_t self);
+
+/**
+ * @brief Función que quita un temporizador de la lista en la que está y actualiza el mapa de ocupados
+ *
+ * @param self  Temporizador a quitar
+ */
+static void Desenlazar(temporizador_t self);
+
+/**
+ * @brief Función que guarda un temporizador en el casillero que corresponde a su vencimiento
+ *
+ * @param self  Temporizador a guardar, el campo vence debe estar actualizado
+ */
+static void Insertar(temporizador_t self);
+
+/**
+ * @brief Función que reubica los temporizadores de un casillero en los niveles inferiores
+ *
+ * @param nivel      Nivel del casillero, mayor que cero
+ * @param casillero  Casillero a redistribuir
+ */
+static void Redistribuir(uint8_t nivel, uint8_t casillero);
+
+/**
+ * @brief Función que procesa el tic actual, redistribuyendo los niveles superiores y pasando a la lista de vencidos
+ * los temporizadores del casillero del primer nivel
+ *
+ * @return uint32_t  Cantidad de temporizadores vencidos
+ */
+static uint32_t Procesar(void);
+
+/**
+ * @brief Función que calcula el próximo tic en el que hay que procesar algún casillero
+ *
+ * @return uint64_t  Tic del próximo evento o @ref NINGUNO si la rueda está vacía
+ */
+static uint64_t Proximo(void);
+
+#ifdef ESP_PLATFORM
+/**
+ * @brief Función que programa el temporizador de hardware para el próximo evento de la rueda
+ */
+static void Reprogramar(void);
+
+/**
+ * @brief Función que llama el temporizador de hardware al dispararse
+ *
+ * @param contexto  No utilizado
+ */
+static void Disparar(void * contexto);
+#endif
+
+/* === Public variable definitions ================================================================================= */
+
+/* === Private variable definitions ================================================================================ */
+
+//! @brief Conjunto de temporizadores que se asignan con @ref TemporizadorCrear
+static struct temporizador_s instancias[TEMPORIZADORES_MAXIMO];
+
+//! @brief Listas de temporizadores de cada casillero
+static struct enlace_s casilleros[TEMPORIZADORES_NIVELES][CASILLEROS];
+
+//! @brief Mapa de casilleros con temporizadores de cada nivel
+static uint64_t ocupados[TEMPORIZADORES_NIVELES];
+
+//! @brief Temporizadores vencidos cuya función de aviso todavía no se llamó
+static struct enlace_s vencidos;
+
+//! @brief Próximo tic que se debe procesar
+static uint64_t actual;
+
+//! @brief Último tic indicado en @ref TemporizadoresAvanzar
+static uint64_t reloj;
+
+#ifdef ESP_PLATFORM
+//! @brief Serializa el acceso a la rueda entre las tareas y el servicio esp_timer
+static SemaphoreHandle_t cerrojo;
+
+//! @brief Temporizador de hardware de un disparo que hace avanzar la rueda
+static esp_timer_handle_t disparo;
+
+//! @brief Tic para el que está programado el temporizador de hardware
+static uint64_t programado = NINGUNO;
+#endif
+
+/* === Private function definitions ================================================================================ */
+
+static void Bloquear(void) {
+#ifdef ESP_PLATFORM
+    xSemaphoreTake(cerrojo, portMAX_DELAY);
+#endif
+}
+
+static void Desbloquear(void) {
+#ifdef ESP_PLATFORM
+    xSemaphoreGive(cerrojo);
+#endif
+}
+
+static uint64_t Ahora(void) {
+#ifdef ESP_PLATFORM
+    return esp_timer_get_time() / TEMPORIZADORES_RESOLUCION_US;
+#else
+    return reloj;
+#endif
+}
+
+static void Enlazar(struct enlace_s * lista, temporizador_t self) {
+    self->enlace.siguiente = lista;
+    self->enlace.anterior = lista->anterior;
+    lista->anterior->siguiente = &self->enlace;
+    lista->anterior = &self->enlace;
+}
+
+static void Desenlazar(temporizador_t self) {
+    self->enlace.anterior->siguiente = self->enlace.siguiente;
+    self->enlace.siguiente->anterior = self->enlace.anterior;
+
+    if (self->nivel != NIVEL_VENCIDOS) {
+        struct enlace_s * lista = &casilleros[self->nivel][self->casillero];
+        if (lista->siguiente == lista) {
+            ocupados[self->nivel] &= ~(1ULL << self->casillero);
+        }
+    }
+}
+
+static void Insertar(temporizador_t self) {
+    uint64_t vence = (self->vence < actual) ? actual : self->vence;
+    uint64_t demora = vence - actual;
+    uint8_t nivel = 0;
+
+    while ((nivel < TEMPORIZADORES_NIVELES - 1) && (demora >= (1ULL << (BITS_NIVEL * (nivel + 1))))) {
+        nivel++;
+    }
+    if (demora >= ALCANCE) {
+        /* Fuera del alcance de la rueda, se vuelve a ubicar cuando se redistribuya el último casillero */
+        vence = actual + ALCANCE - 1;
+    }
+
+    self->nivel = nivel;
+    self->casillero = (vence >> (BITS_NIVEL * nivel)) & MASCARA_NIVEL;
+    Enlazar(&casilleros[nivel][self->casillero], self);
+    ocupados[nivel] |= 1ULL << self->casillero;
+}
+
+static void Redistribuir(uint8_t nivel, uint8_t casillero) {
+    struct enlace_s * lista = &casilleros[nivel][casillero];
+    struct enlace_s * enlace = lista->siguiente;
+
+    lista->siguiente = lista;
+    lista->anterior = lista;
+    ocupados[nivel] &= ~(1ULL << casillero);
+
+    while (enlace != lista) {
+        temporizador_t temporizador = (temporizador_t)enlace;
+        enlace = enlace->siguiente;
+        Insertar(temporizador);
+    }
+}
+
+static uint32_t Procesar(void) {
+    uint32_t cantidad = 0;
+
+    for (uint8_t nivel = 1; nivel < TEMPORIZADORES_NIVELES; nivel++) {
+        if (actual & ((1ULL << (BITS_NIVEL * nivel)) - 1)) {
+            break;
+        }
+        Redistribuir(nivel, (actual >> (BITS_NIVEL * nivel)) & MASCARA_NIVEL);
+    }
+
+    uint8_t casillero = actual & MASCARA_NIVEL;
+    struct enlace_s * lista = &casilleros[0][casillero];
+    while (lista->siguiente != lista) {
+        temporizador_t temporizador = (temporizador_t)lista->siguiente;
+        Desenlazar(temporizador);
+        temporizador->nivel = NIVEL_VENCIDOS;
+        temporizador->estado = VENCIDO;
+        Enlazar(&vencidos, temporizador);
+        cantidad++;
+    }
+    return cantidad;
+}
+
+static uint64_t Proximo(void) {
+    uint64_t resultado = NINGUNO;
+
+    for (uint8_t nivel = 0; nivel < TEMPORIZADORES_NIVELES; nivel++) {
+        if (ocupados[nivel] == 0) {
+            continue;
+        }
+        /* Primer tic en que se procesa el nivel y casillero que se procesa en ese tic */
+        uint8_t bits = BITS_NIVEL * nivel;
+        uint64_t paso = 1ULL << bits;
+        uint64_t base = (actual + paso - 1) & ~(paso - 1);
+        uint8_t indice = (base >> bits) & MASCARA_NIVEL;
+
+        /* Rotar el mapa para que el casillero del primer tic quede en el bit cero */
+        uint64_t mapa = ocupados[nivel];
+        if (indice) {
+            mapa = (mapa >> indice) | (mapa << (CASILLEROS - indice));
+        }
+        uint64_t tic = base + (uint64_t)__builtin_ctzll(mapa) * paso;
+        if (tic < resultado) {
+            resultado = tic;
+        }
+    }
+    return resultado;
+}
+
+#ifdef ESP_PLATFORM
+static void Reprogramar(void) {
+    uint64_t proximo = Proximo();
+
+    if (proximo == programado) {
+        return;
+    }
+    esp_timer_stop(disparo);
+    programado = proximo;
+    if (proximo != NINGUNO) {
+        int64_t demora = (int64_t)(proximo * TEMPORIZADORES_RESOLUCION_US) - esp_timer_get_time();
+        esp_timer_start_once(disparo, (demora > 0) ? demora : 0);
+    }
+}
+
+static void Disparar(void * contexto) {
+    Bloquear();
+    programado = NINGUNO;
+    Desbloquear();
+
+    TemporizadoresAvanzar(Ahora());
+
+    Bloquear();
+    Reprogramar();
+    Desbloquear();
+}
+#endif
+
+/* === Public function implementation ============================================================================== */
+
+bool TemporizadoresIniciar(uint64_t ahora) {
+#ifdef ESP_PLATFORM
+    cerrojo = xSemaphoreCreateMutex();
+    esp_timer_create_args_t argumentos = {
+        .callback = Disparar,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "temporizadores",
+    };
+    if ((cerrojo == NULL) || (esp_timer_create(&argumentos, &disparo) != ESP_OK)) {
+        return false;
+    }
+    ahora = Ahora();
+#endif
+
+    for (uint8_t nivel = 0; nivel < TEMPORIZADORES_NIVELES; nivel++) {
+        for (uint8_t casillero = 0; casillero < CASILLEROS; casillero++) {
+            casilleros[nivel][casillero].siguiente = &casilleros[nivel][casillero];
+            casilleros[nivel][casillero].anterior = &casilleros[nivel][casillero];
+        }
+        ocupados[nivel] = 0;
+    }
+    vencidos.siguiente = &vencidos;
+    vencidos.anterior = &vencidos;
+    reloj = ahora;
+    actual = ahora;
+    return true;
+}
+
+uint32_t TemporizadoresAvanzar(uint64_t ahora) {
+    uint32_t cantidad = 0;
+
+    Bloquear();
+    reloj = ahora;
+    while (actual <= ahora) {
+        uint64_t proximo = Proximo();
+        if (proximo > ahora) {
+            actual = ahora + 1;
+            break;
+        }
+        actual = proximo;
+        cantidad += Procesar();
+        actual++;
+    }
+
+    /* Los avisos se llaman sin el acceso exclusivo, asi pueden volver a armar o cancelar temporizadores */
+    while (vencidos.siguiente != &vencidos) {
+        temporizador_t temporizador = (temporizador_t)vencidos.siguiente;
+        Desenlazar(temporizador);
+        if (temporizador->periodo) {
+            /* El período se cuenta desde el vencimiento anterior para no acumular retrasos */
+            temporizador->vence += temporizador->periodo;
+            temporizador->estado = ARMADO;
+            Insertar(temporizador);
+        } else {
+            temporizador->estado = DESARMADO;
+        }
+        temporizador_aviso_t aviso = temporizador->aviso;
+        void * contexto = temporizador->contexto;
+        Desbloquear();
+
+        aviso(temporizador, contexto);
+        Bloquear();
+    }
+    Desbloquear();
+    return cantidad;
+}
+
+uint64_t TemporizadoresProximo(void) {
+    Bloquear();
+    uint64_t resultado = Proximo();
+    Desbloquear();
+    return resultado;
+}
+
+temporizador_t TemporizadorCrear(temporizador_aviso_t aviso, void * contexto) {
+    temporizador_t self = NULL;
+
+    Bloquear();
+    for (int indice = 0; indice < TEMPORIZADORES_MAXIMO; indice++) {
+        if (instancias[indice].estado == LIBRE) {
+            self = &instancias[indice];
+            self->aviso = aviso;
+            self->contexto = contexto;
+            self->periodo = 0;
+            self->estado = DESARMADO;
+            break;
+        }
+    }
+    Desbloquear();
+    return self;
+}
+
+void TemporizadorLiberar(temporizador_t self) {
+    TemporizadorCancelar(self);
+    self->estado = LIBRE;
+}
+
+void TemporizadorArmar(temporizador_t self, uint32_t demora, uint32_t periodo) {
+    Bloquear();
+    if ((self->estado == ARMADO) || (self->estado == VENCIDO)) {
+        Desenlazar(self);
+    }
+    self->vence = Ahora() + demora;
+    self->periodo = periodo;
+    self->estado = ARMADO;
+    Insertar(self);
+#ifdef ESP_PLATFORM
+    if (Proximo() < programado) {
+        Reprogramar();
+    }
+#endif
+    Desbloquear();
+}
+
+void TemporizadorCancelar(temporizador_t self) {
+    Bloquear();
+    if ((self->estado == ARMADO) || (self->estado == VENCIDO)) {
+        /* El temporizador de hardware no se reprograma, si se dispara sin vencimientos solo se vuelve a programar */
+        Desenlazar(self);
+        self->estado = DESARMADO;
+    }
+    Desbloquear();
+}
+
+bool TemporizadorArmado(temporizador_t self) {
+    return self->estado == ARMADO;
+}
+
+uint64_t TemporizadorRestante(temporizador_t self) {
+    uint64_t resultado = 0;
+
+    Bloquear();
+    if (self->estado == ARMADO) {
+        uint64_t ahora = Ahora();
+        resultado = (self->vence > ahora) ? self->vence - ahora : 0;
+    }
+    Desbloquear();
+    return resultado;
+}
+
+/* === End of documentation ======================================================================================== */
@@ -0,0 +1,171 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+#ifndef TEMPORIZADORES_H_
+#define TEMPORIZADORES_H_
+
+/** @file temporizadores.h
+ ** @brief Declaraciones de los temporizadores de cuenta regresiva y alarmas sobre una rueda jerárquica
+ **
+ ** Todos los temporizadores comparten una rueda de @ref TEMPORIZADORES_NIVELES niveles de 64 casilleros cada uno. El
+ ** primer nivel tiene la resolución de un tic y cada nivel siguiente cubre 64 veces más tiempo que el anterior. Armar
+ ** y cancelar un temporizador solo enlaza o desenlaza un nodo de una lista, por lo que el costo no depende de la
+ ** cantidad de temporizadores activos. Al avanzar, los casilleros de los niveles superiores se redistribuyen en los
+ ** inferiores a medida que se acercan sus vencimientos.
+ **
+ ** En el ESP32 la rueda avanza con un único temporizador de hardware de un disparo, que siempre se reprograma para el
+ ** próximo vencimiento, de modo que no hay interrupciones periódicas mientras no hay temporizadores por vencer. Las
+ ** funciones de aviso se llaman desde la tarea del servicio esp_timer y deben ser breves (por ejemplo notificar a una
+ ** tarea). Cuando se compila para la computadora de desarrollo la rueda avanza llamando a @ref TemporizadoresAvanzar.
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* === Cabecera C++ ================================================================================================ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* === Public macros definitions =================================================================================== */
+
+//! @brief Cantidad máxima de temporizadores que se pueden crear
+#ifndef TEMPORIZADORES_MAXIMO
+#define TEMPORIZADORES_MAXIMO 64
+#endif
+
+//! @brief Duración de un tic de la rueda en microsegundos
+#ifndef TEMPORIZADORES_RESOLUCION_US
+#define TEMPORIZADORES_RESOLUCION_US 1000
+#endif
+
+//! @brief Cantidad de niveles de la rueda, con 64 casilleros cada uno cubren 64 elevado a esta cantidad de tics
+#define TEMPORIZADORES_NIVELES 4
+
+/* === Public data type declarations =============================================================================== */
+
+//! @brief Tipo de dato para referenciar a un temporizador
+typedef struct temporizador_s * temporizador_t;
+
+/**
+ * @brief Función que se llama cuando vence un temporizador
+ *
+ * @param  temporizador  Temporizador que venció
+ * @param  contexto      Parámetro indicado al crear el temporizador
+ */
+typedef void (*temporizador_aviso_t)(temporizador_t temporizador, void * contexto);
+
+/* === Public variable declarations ================================================================================ */
+
+/* === Public function declarations ================================================================================ */
+
+/**
+ * @brief Función que inicializa la rueda de temporizadores
+ *
+ * En el ESP32 crea el temporizador de hardware que hace avanzar la rueda. Se debe llamar una única vez antes de
+ * armar cualquier temporizador.
+ *
+ * @param  ahora  Tic actual, solo se utiliza cuando se compila para la computadora de desarrollo
+ * @return true   La rueda se inicializó correctamente
+ * @return false  No se pudo crear el temporizador de hardware
+ */
+bool TemporizadoresIniciar(uint64_t ahora);
+
+/**
+ * @brief Función que procesa los vencimientos hasta el tic indicado inclusive
+ *
+ * Los tics en los que no vence ningún temporizador se saltean, por lo que el costo no depende del tiempo transcurrido
+ * desde la llamada anterior. En el ESP32 la llama el temporizador de hardware.
+ *
+ * @param  ahora     Tic actual
+ * @return uint32_t  Cantidad de temporizadores que vencieron
+ */
+uint32_t TemporizadoresAvanzar(uint64_t ahora);
+
+/**
+ * @brief Función que devuelve el tic en que se debe volver a avanzar la rueda
+ *
+ * Para los temporizadores de los niveles superiores devuelve el tic en que se redistribuye su casillero, que nunca es
+ * posterior a su vencimiento.
+ *
+ * @return uint64_t  Tic del próximo evento de la rueda o UINT64_MAX si no hay temporizadores armados
+ */
+uint64_t TemporizadoresProximo(void);
+
+/**
+ * @brief Función que crea un temporizador desarmado
+ *
+ * @param  aviso          Función que se llama cuando vence el temporizador
+ * @param  contexto       Parámetro para la función de aviso
+ * @return temporizador_t Puntero al temporizador creado o NULL si no quedan temporizadores libres
+ */
+temporizador_t TemporizadorCrear(temporizador_aviso_t aviso, void * contexto);
+
+/**
+ * @brief Función que devuelve un temporizador al conjunto de temporizadores libres
+ *
+ * @param  self  Puntero al temporizador creado con @ref TemporizadorCrear, se cancela si estaba armado
+ */
+void TemporizadorLiberar(temporizador_t self);
+
+/**
+ * @brief Función que arma un temporizador, si ya estaba armado se reemplaza el vencimiento anterior
+ *
+ * @param  self     Puntero al temporizador creado con @ref TemporizadorCrear
+ * @param  demora   Tics hasta el primer vencimiento
+ * @param  periodo  Tics entre vencimientos sucesivos, cero para un temporizador de cuenta regresiva de un solo disparo
+ */
+void TemporizadorArmar(temporizador_t self, uint32_t demora, uint32_t periodo);
+
+/**
+ * @brief Función que cancela un temporizador armado
+ *
+ * Si el temporizador ya venció pero todavía no se llamó a su función de aviso, el aviso se descarta.
+ *
+ * @param  self  Puntero al temporizador creado con @ref TemporizadorCrear
+ */
+void TemporizadorCancelar(temporizador_t self);
+
+/**
+ * @brief Función que informa si un temporizador está armado
+ *
+ * @param  self   Puntero al temporizador creado con @ref TemporizadorCrear
+ * @return true   El temporizador está armado
+ * @return false  El temporizador está desarmado
+ */
+bool TemporizadorArmado(temporizador_t self);
+
+/**
+ * @brief Función que devuelve el tiempo que falta para el próximo vencimiento
+ *
+ * @param  self      Puntero al temporizador creado con @ref TemporizadorCrear
+ * @return uint64_t  Tics hasta el vencimiento, cero si el temporizador está desarmado o ya venció
+ */
+uint64_t TemporizadorRestante(temporizador_t self);
+
+/* === End of documentation ======================================================================================== */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TEMPORIZADORES_H_ */
@@ -0,0 +1,208 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+/** @file vueltas.c
+ ** @brief Definiciones del registro de vueltas con tiempos codificados como diferencias de largo variable
+ **
+ ** El productor publica cada vuelta incrementando @c cantidad después de escribirla. Antes de reutilizar el espacio
+ ** de un bloque incrementa @c primera, de modo que un lector que encuentra @c primera modificada al terminar de
+ ** decodificar sabe que los datos que leyó pudieron ser sobrescritos y descarta el resultado.
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include "vueltas.h"
+#include <stdatomic.h>
+#include <stddef.h>
+
+/* === Macros definitions ========================================================================================== */
+
+#define VARINT_MAXIMO 10 //!< Cantidad máxima de bytes de una diferencia de 64 bits codificada
+
+//! @brief Cantidad de bloques, alcanza para el peor caso de diferencias de un byte
+#define VUELTAS_BLOQUES (VUELTAS_CAPACIDAD / (VUELTAS_POR_BLOQUE - 1) + 2)
+
+_Static_assert(VUELTAS_POR_BLOQUE > 1, "Un bloque debe contener al menos dos vueltas");
+_Static_assert((VUELTAS_CAPACIDAD & (VUELTAS_CAPACIDAD - 1)) == 0, "La capacidad debe ser una potencia de dos");
+_Static_assert(VUELTAS_CAPACIDAD >= 2 * VUELTAS_POR_BLOQUE * VARINT_MAXIMO,
+               "La capacidad debe alcanzar para dos bloques completos");
+
+/* === Private data type declarations ============================================================================== */
+
+//! @brief Punto de partida para decodificar un bloque de vueltas
+struct bloque_s {
+    uint64_t base_us;       //!< Tiempo absoluto de la primera vuelta del bloque
+    uint32_t desplazamiento; //!< Posición en los datos de la diferencia de la segunda vuelta del bloque
+};
+
+struct vueltas_s {
+    bool ocupado;                             //!< Indica que la instancia fue asignada
+    uint8_t datos[VUELTAS_CAPACIDAD];         //!< Diferencias codificadas, usado como buffer circular
+    struct bloque_s bloques[VUELTAS_BLOQUES]; //!< Comienzo de cada bloque, usado como buffer circular
+    uint64_t ultima_us;                       //!< Tiempo de la última vuelta agregada
+    uint32_t escritura;                       //!< Posición de escritura en los datos, crece sin límite
+    atomic_uint_fast32_t primera;             //!< Índice de la vuelta más antigua, siempre inicio de un bloque
+    atomic_uint_fast32_t cantidad;            //!< Cantidad de vueltas publicadas
+};
+
+/* === Private variable declarations =============================================================================== */
+
+/* === Private function declarations =============================================================================== */
+
+/**
+ * @brief Función que descarta el bloque más antiguo para liberar espacio
+ *
+ * @param self Puntero al registro de vueltas
+ */
+static void DescartarBloque(vueltas_t self);
+
+/* === Public variable definitions ================================================================================= */
+
+/* === Private variable definitions ================================================================================ */
+
+/* === Private function definitions ================================================================================ */
+
+static vueltas_t CrearInstancia(void) {
+    static struct vueltas_s instancias[MAXIMO_REGISTROS_VUELTAS];
+
+    for (int indice = 0; indice < MAXIMO_REGISTROS_VUELTAS; indice++) {
+        if (!instancias[indice].ocupado) {
+            instancias[indice].ocupado = true;
+            return &(instancias[indice]);
+        }
+    }
+    return NULL;
+}
+
+static void DescartarBloque(vueltas_t self) {
+    uint32_t primera = atomic_load_explicit(&self->primera, memory_order_relaxed);
+
+    atomic_store_explicit(&self->primera, primera + VUELTAS_POR_BLOQUE, memory_order_relaxed);
+    /* El nuevo valor de primera debe ser visible antes que cualquier escritura sobre el bloque descartado */
+    atomic_thread_fence(memory_order_release);
+}
+
+/* === Public function implementation ============================================================================== */
+
+vueltas_t VueltasCrear(void) {
+    vueltas_t self = CrearInstancia();
+    if (self) {
+        VueltasVaciar(self);
+    }
+    return self;
+}
+
+uint32_t VueltasAgregar(vueltas_t self, uint64_t tiempo_us) {
+    uint32_t indice = atomic_load_explicit(&self->cantidad, memory_order_relaxed);
+    uint32_t bloque = indice / VUELTAS_POR_BLOQUE;
+
+    if ((indice % VUELTAS_POR_BLOQUE) == 0) {
+        /* Primera vuelta de un bloque: se guarda el tiempo absoluto y no ocupa espacio en los datos */
+        if (bloque - atomic_load_explicit(&self->primera, memory_order_relaxed) / VUELTAS_POR_BLOQUE >=
+            VUELTAS_BLOQUES) {
+            DescartarBloque(self);
+        }
+        struct bloque_s * actual = &self->bloques[bloque % VUELTAS_BLOQUES];
+        actual->base_us = tiempo_us;
+        actual->desplazamiento = self->escritura;
+    } else {
+        uint8_t codificado[VARINT_MAXIMO];
+        uint32_t largo = 0;
+        uint64_t diferencia = (tiempo_us > self->ultima_us) ? tiempo_us - self->ultima_us : 0;
+
+        do {
+            codificado[largo] = (diferencia & 0x7F) | (diferencia > 0x7F ? 0x80 : 0x00);
+            diferencia >>= 7;
+            largo++;
+        } while (diferencia);
+
+        /* Liberar bloques antiguos hasta que entre la diferencia, el bloque actual nunca se descarta */
+        for (;;) {
+            uint32_t primera = atomic_load_explicit(&self->primera, memory_order_relaxed);
+            uint32_t ocupados =
+                self->escritura - self->bloques[(primera / VUELTAS_POR_BLOQUE) % VUELTAS_BLOQUES].desplazamiento;
+            if (ocupados + largo <= VUELTAS_CAPACIDAD) {
+                break;
+            }
+            DescartarBloque(self);
+        }
+
+        for (uint32_t i = 0; i < largo; i++) {
+            self->datos[(self->escritura + i) % VUELTAS_CAPACIDAD] = codificado[i];
+        }
+        self->escritura += largo;
+    }
+
+    if (tiempo_us > self->ultima_us) {
+        self->ultima_us = tiempo_us;
+    }
+    atomic_store_explicit(&self->cantidad, indice + 1, memory_order_release);
+    return indice;
+}
+
+bool VueltasLeer(vueltas_t self, uint32_t indice, uint64_t * tiempo_us) {
+    if (indice >= atomic_load_explicit(&self->cantidad, memory_order_acquire)) {
+        return false;
+    }
+    if (indice < atomic_load_explicit(&self->primera, memory_order_acquire)) {
+        return false;
+    }
+
+    const struct bloque_s * bloque = &self->bloques[(indice / VUELTAS_POR_BLOQUE) % VUELTAS_BLOQUES];
+    uint64_t tiempo = bloque->base_us;
+    uint32_t posicion = bloque->desplazamiento;
+
+    for (uint32_t vuelta = indice % VUELTAS_POR_BLOQUE; vuelta > 0; vuelta--) {
+        uint64_t diferencia = 0;
+        uint8_t byte;
+        uint32_t desplazamiento = 0;
+        do {
+            byte = self->datos[posicion % VUELTAS_CAPACIDAD];
+            diferencia |= (uint64_t)(byte & 0x7F) << desplazamiento;
+            desplazamiento += 7;
+            posicion++;
+        } while ((byte & 0x80) && (desplazamiento < 7 * VARINT_MAXIMO));
+        tiempo += diferencia;
+    }
+
+    /* Si el bloque se descartó mientras se decodificaba el resultado no es válido */
+    atomic_thread_fence(memory_order_acquire);
+    if (indice < atomic_load_explicit(&self->primera, memory_order_relaxed)) {
+        return false;
+    }
+    *tiempo_us = tiempo;
+    return true;
+}
+
+uint32_t VueltasCantidad(vueltas_t self) {
+    return atomic_load_explicit(&self->cantidad, memory_order_acquire);
+}
+
+uint32_t VueltasPrimera(vueltas_t self) {
+    return atomic_load_explicit(&self->primera, memory_order_acquire);
+}
+
+void VueltasVaciar(vueltas_t self) {
+    self->escritura = 0;
+    self->ultima_us = 0;
+    atomic_store_explicit(&self->primera, 0, memory_order_relaxed);
+    atomic_store_explicit(&self->cantidad, 0, memory_order_release);
+}
+
+/* === End of documentation ======================================================================================== */
@@ -0,0 +1,133 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+#ifndef VUELTAS_H_
+#define VUELTAS_H_
+
+/** @file vueltas.h
+ ** @brief Declaraciones del registro de vueltas con tiempos codificados como diferencias de largo variable
+ **
+ ** Cada vuelta se guarda como la diferencia con la vuelta anterior codificada en 7 bits por byte (varint), por lo
+ ** que una vuelta de un minuto ocupa 4 bytes. Las vueltas se agrupan en bloques de @ref VUELTAS_POR_BLOQUE que
+ ** comienzan con el tiempo absoluto de su primera vuelta, lo que permite leer cualquier vuelta decodificando a lo sumo
+ ** un bloque. Cuando se agota la capacidad se descarta el bloque más antiguo, nunca se rechaza una vuelta nueva.
+ **
+ ** Un único productor agrega vueltas en tiempo constante, sin bloqueos ni reserva de memoria, por lo que se puede
+ ** llamar desde una interrupción. Cualquier cantidad de lectores pueden consultar las vueltas concurrentemente.
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* === Cabecera C++ ================================================================================================ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* === Public macros definitions =================================================================================== */
+
+//! @brief Cantidad máxima de registros de vueltas que se pueden crear
+#ifndef MAXIMO_REGISTROS_VUELTAS
+#define MAXIMO_REGISTROS_VUELTAS 1
+#endif
+
+//! @brief Cantidad de bytes de cada registro reservados para las diferencias codificadas
+#ifndef VUELTAS_CAPACIDAD
+#define VUELTAS_CAPACIDAD 4096
+#endif
+
+//! @brief Cantidad de vueltas de cada bloque, es la cantidad máxima de diferencias a decodificar en una lectura
+#ifndef VUELTAS_POR_BLOQUE
+#define VUELTAS_POR_BLOQUE 32
+#endif
+
+/* === Public data type declarations =============================================================================== */
+
+//! @brief Tipo de dato para referenciar a un registro de vueltas
+typedef struct vueltas_s * vueltas_t;
+
+/* === Public variable declarations ================================================================================ */
+
+/* === Public function declarations ================================================================================ */
+
+/**
+ * @brief Función que crea un registro de vueltas vacío
+ *
+ * @return vueltas_t  Puntero al registro creado o NULL si no quedan registros disponibles
+ */
+vueltas_t VueltasCrear(void);
+
+/**
+ * @brief Función que agrega una vuelta al registro
+ *
+ * Solo puede ser llamada por un único productor. Los tiempos deben ser crecientes, si una vuelta tiene un tiempo
+ * menor que la anterior se registra con el mismo tiempo que la anterior.
+ *
+ * @param  self      Puntero al registro creado con la función @ref VueltasCrear
+ * @param  tiempo_us Tiempo del cronómetro en el momento de la vuelta, en microsegundos
+ * @return uint32_t  Índice de la vuelta agregada, comenzando en 0
+ */
+uint32_t VueltasAgregar(vueltas_t self, uint64_t tiempo_us);
+
+/**
+ * @brief Función que lee el tiempo de una vuelta
+ *
+ * @param  self      Puntero al registro creado con la función @ref VueltasCrear
+ * @param  indice    Índice de la vuelta a leer
+ * @param  tiempo_us Puntero donde se devuelve el tiempo de la vuelta, en microsegundos
+ * @return true      La vuelta existe y se devolvió su tiempo
+ * @return false     La vuelta todavía no se registró o ya fue descartada para liberar espacio
+ */
+bool VueltasLeer(vueltas_t self, uint32_t indice, uint64_t * tiempo_us);
+
+/**
+ * @brief Función que devuelve la cantidad de vueltas agregadas desde la creación o el último vaciado
+ *
+ * @param  self      Puntero al registro creado con la función @ref VueltasCrear
+ * @return uint32_t  Cantidad de vueltas agregadas, incluyendo las descartadas
+ */
+uint32_t VueltasCantidad(vueltas_t self);
+
+/**
+ * @brief Función que devuelve el índice de la vuelta más antigua que se conserva
+ *
+ * @param  self      Puntero al registro creado con la función @ref VueltasCrear
+ * @return uint32_t  Índice de la vuelta más antigua que todavía se puede leer
+ */
+uint32_t VueltasPrimera(vueltas_t self);
+
+/**
+ * @brief Función que descarta todas las vueltas del registro
+ *
+ * Solo puede ser llamada desde el mismo contexto que agrega las vueltas.
+ *
+ * @param  self      Puntero al registro creado con la función @ref VueltasCrear
+ */
+void VueltasVaciar(vueltas_t self);
+
+/* === End of documentation ======================================================================================== */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* VUELTAS_H_ */
@@ -0,0 +1,2 @@
+/* Reemplazo del encabezado de ESP-IDF para las pruebas en la computadora de desarrollo */
+#include "esp_idf.h"
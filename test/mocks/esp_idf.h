@@ -0,0 +1,202 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+#ifndef ESP_IDF_H_
+#define ESP_IDF_H_
+
+/** @file esp_idf.h
+ ** @brief Parte de la interfaz de ESP-IDF que usa el controlador del ILI9341, para compilarlo en la computadora de
+ ** desarrollo
+ **
+ ** Los encabezados de ESP-IDF que incluye ili9341.c se reemplazan por archivos del mismo nombre en esta carpeta, que
+ ** solo incluyen este. Las funciones se implementan en panel_simulado.c, que registra lo que se envía al panel en
+ ** lugar de usar el bus.
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/* === Cabecera C++ ================================================================================================ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* === Public macros definitions =================================================================================== */
+
+#define ESP_OK                0
+#define ESP_FAIL              -1
+#define ESP_ERR_NO_MEM        0x101
+
+//! @brief Como en ESP-IDF, un error termina el programa
+#define ESP_ERROR_CHECK(x)                                                                                             \
+    do {                                                                                                               \
+        if ((x) != ESP_OK) {                                                                                           \
+            abort();                                                                                                   \
+        }                                                                                                              \
+    } while (0)
+
+#define IRAM_ATTR
+#define DRAM_ATTR
+
+#define pdFALSE               0
+#define pdTRUE                1
+#define portMAX_DELAY         0xFFFFFFFFU
+#define portTICK_PERIOD_MS    1
+
+#define MALLOC_CAP_8BIT       (1 << 2)
+#define MALLOC_CAP_DMA        (1 << 3)
+#define MALLOC_CAP_INTERNAL   (1 << 11)
+
+#define SOC_LCD_I80_SUPPORTED 1
+#define SOC_LCD_I80_BUS_WIDTH 8
+
+#define SPI2_HOST             1
+#define SPI3_HOST             2
+#define SPI_DMA_CH_AUTO       3
+
+#define GPIO_MODE_OUTPUT      2
+
+/* === Public data type declarations =============================================================================== */
+
+typedef int esp_err_t;
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+typedef struct semaforo_simulado_s * SemaphoreHandle_t;
+
+typedef int gpio_num_t;
+typedef int gpio_mode_t;
+
+typedef struct {
+    uint64_t pin_bit_mask;
+    gpio_mode_t mode;
+    bool pull_up_en;
+    bool pull_down_en;
+    int intr_type;
+} gpio_config_t;
+
+typedef int spi_host_device_t;
+
+typedef struct {
+    int mosi_io_num;
+    int miso_io_num;
+    int sclk_io_num;
+    int quadwp_io_num;
+    int quadhd_io_num;
+    int max_transfer_sz;
+    uint32_t flags;
+} spi_bus_config_t;
+
+typedef struct esp_lcd_panel_io_t * esp_lcd_panel_io_handle_t;
+typedef struct esp_lcd_i80_bus_t * esp_lcd_i80_bus_handle_t;
+typedef int esp_lcd_spi_bus_handle_t;
+
+typedef struct {
+    int reservado;
+} esp_lcd_panel_io_event_data_t;
+
+typedef bool (*esp_lcd_panel_io_color_trans_done_cb_t)(esp_lcd_panel_io_handle_t io,
+                                                       esp_lcd_panel_io_event_data_t * event, void * context);
+
+typedef enum {
+    LCD_CLK_SRC_DEFAULT,
+} lcd_clock_source_t;
+
+typedef struct {
+    int cs_gpio_num;
+    int dc_gpio_num;
+    int spi_mode;
+    unsigned int pclk_hz;
+    size_t trans_queue_depth;
+    esp_lcd_panel_io_color_trans_done_cb_t on_color_trans_done;
+    void * user_ctx;
+    int lcd_cmd_bits;
+    int lcd_param_bits;
+} esp_lcd_panel_io_spi_config_t;
+
+typedef struct {
+    int dc_gpio_num;
+    int wr_gpio_num;
+    lcd_clock_source_t clk_src;
+    int data_gpio_nums[SOC_LCD_I80_BUS_WIDTH];
+    size_t bus_width;
+    size_t max_transfer_bytes;
+    size_t psram_trans_align;
+    size_t sram_trans_align;
+} esp_lcd_i80_bus_config_t;
+
+typedef struct {
+    int cs_gpio_num;
+    uint32_t pclk_hz;
+    size_t trans_queue_depth;
+    esp_lcd_panel_io_color_trans_done_cb_t on_color_trans_done;
+    void * user_ctx;
+    int lcd_cmd_bits;
+    int lcd_param_bits;
+    struct {
+        unsigned int dc_idle_level : 1;
+        unsigned int dc_cmd_level : 1;
+        unsigned int dc_dummy_level : 1;
+        unsigned int dc_data_level : 1;
+    } dc_levels;
+} esp_lcd_panel_io_i80_config_t;
+
+/* === Public function declarations ================================================================================ */
+
+void vTaskDelay(TickType_t ticks);
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t maximo, UBaseType_t inicial);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaforo, TickType_t espera);
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t semaforo, BaseType_t * despertada);
+void vSemaphoreDelete(SemaphoreHandle_t semaforo);
+
+void * heap_caps_malloc(size_t largo, uint32_t capacidades);
+void heap_caps_free(void * bloque);
+bool esp_ptr_dma_capable(const void * puntero);
+
+esp_err_t gpio_config(const gpio_config_t * configuracion);
+esp_err_t gpio_set_level(gpio_num_t pin, uint32_t nivel);
+esp_err_t gpio_hold_en(gpio_num_t pin);
+esp_err_t gpio_hold_dis(gpio_num_t pin);
+void gpio_deep_sleep_hold_en(void);
+void gpio_deep_sleep_hold_dis(void);
+
+esp_err_t spi_bus_initialize(spi_host_device_t host, const spi_bus_config_t * configuracion, int dma);
+
+esp_err_t esp_lcd_new_panel_io_spi(esp_lcd_spi_bus_handle_t bus, const esp_lcd_panel_io_spi_config_t * configuracion,
+                                   esp_lcd_panel_io_handle_t * io);
+esp_err_t esp_lcd_new_i80_bus(const esp_lcd_i80_bus_config_t * configuracion, esp_lcd_i80_bus_handle_t * bus);
+esp_err_t esp_lcd_new_panel_io_i80(esp_lcd_i80_bus_handle_t bus, const esp_lcd_panel_io_i80_config_t * configuracion,
+                                   esp_lcd_panel_io_handle_t * io);
+esp_err_t esp_lcd_panel_io_tx_param(esp_lcd_panel_io_handle_t io, int comando, const void * parametros, size_t largo);
+esp_err_t esp_lcd_panel_io_tx_color(esp_lcd_panel_io_handle_t io, int comando, const void * pixeles, size_t largo);
+
+/* === End of documentation ======================================================================================== */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ESP_IDF_H_ */
@@ -0,0 +1,331 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+/** @file panel_simulado.c
+ ** @brief Implementación de la interfaz de ESP-IDF que usa el controlador del ILI9341 sobre un panel simulado
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include "panel_simulado.h"
+#include "esp_idf.h"
+#include <string.h>
+
+/* === Macros definitions ========================================================================================== */
+
+//! @brief Cantidad de paneles y de semáforos que se pueden crear
+#define SIMULADOS_MAXIMO   4
+
+//! @brief Comando de escritura de la memoria del panel, los píxeles siguientes continúan esta escritura
+#define ESCRIBIR_MEMORIA   0x2C
+
+/* === Private data type declarations ============================================================================== */
+
+//! @brief Estado de un panel simulado
+struct esp_lcd_panel_io_t {
+    esp_lcd_panel_io_color_trans_done_cb_t terminada; //!< Función que se llama al terminar una transacción de píxeles
+    void * contexto;                                  //!< Parámetro de la función que se llama al terminar
+    size_t profundidad;                               //!< Transacciones de píxeles que se pueden poner en cola
+    size_t en_cola;                                   //!< Transacciones de píxeles en cola sin terminar
+};
+
+//! @brief Estado de un semáforo contador simulado
+struct semaforo_simulado_s {
+    UBaseType_t cuenta; //!< Valor actual del semáforo
+    UBaseType_t maximo; //!< Valor máximo del semáforo
+};
+
+/* === Private variable declarations =============================================================================== */
+
+/* === Private function declarations =============================================================================== */
+
+/**
+ * @brief Función que termina la transacción de píxeles más antigua de un panel y avisa al controlador
+ *
+ * @param  io  Panel con transacciones en cola
+ */
+static void Terminar(esp_lcd_panel_io_handle_t io);
+
+/**
+ * @brief Función que termina todas las transacciones de píxeles en cola, como hace ESP-IDF antes de un comando
+ *
+ * @param  io  Panel que envía el comando
+ */
+static void Vaciar(esp_lcd_panel_io_handle_t io);
+
+/**
+ * @brief Función que registra una transacción enviada al panel
+ *
+ * @param  comando  Comando enviado o @ref PANEL_SIMULADO_SIN_COMANDO
+ * @param  pixeles  Transacción de píxeles o comando con sus parámetros
+ * @param  datos    Parámetros o píxeles enviados
+ * @param  largo    Cantidad de bytes de los datos
+ */
+static void Registrar(int comando, bool pixeles, const void * datos, size_t largo);
+
+/* === Public variable definitions ================================================================================= */
+
+/* === Private variable definitions ================================================================================ */
+
+static struct esp_lcd_panel_io_t paneles[SIMULADOS_MAXIMO];         //!< Paneles que se pueden crear
+static uint32_t paneles_creados;                                    //!< Cantidad de paneles creados
+static struct semaforo_simulado_s semaforos[SIMULADOS_MAXIMO];     //!< Semáforos que se pueden crear
+static uint32_t semaforos_creados;                                  //!< Cantidad de semáforos creados
+
+static transaccion_simulada_t transacciones[PANEL_SIMULADO_TRANSACCIONES]; //!< Transacciones registradas
+static uint32_t cantidad;                                                  //!< Cantidad de transacciones registradas
+static uint8_t flujo[PANEL_SIMULADO_PIXELES];   //!< Píxeles enviados desde la última escritura de memoria
+static uint32_t bytes_flujo;                    //!< Cantidad de bytes de píxeles enviados
+static bool escribiendo;                        //!< Hay una escritura de memoria que los píxeles pueden continuar
+static uint32_t maximo_en_cola;                 //!< Mayor cantidad de transacciones de píxeles en cola
+static uint32_t errores;                        //!< Usos incorrectos de la interfaz
+static bool memoria_dma;                        //!< El DMA puede leer la memoria de los datos enviados
+
+/* === Private function definitions ================================================================================ */
+
+static void Terminar(esp_lcd_panel_io_handle_t io) {
+    esp_lcd_panel_io_event_data_t evento = {0};
+
+    io->en_cola--;
+    if (io->terminada != NULL) {
+        io->terminada(io, &evento, io->contexto);
+    }
+}
+
+static void Vaciar(esp_lcd_panel_io_handle_t io) {
+    while (io->en_cola > 0) {
+        Terminar(io);
+    }
+}
+
+static void Registrar(int comando, bool pixeles, const void * datos, size_t largo) {
+    if (cantidad < PANEL_SIMULADO_TRANSACCIONES) {
+        transaccion_simulada_t * transaccion = &transacciones[cantidad++];
+        transaccion->comando = comando;
+        transaccion->pixeles = pixeles;
+        transaccion->bytes = largo;
+        transaccion->origen = datos;
+        memset(transaccion->parametros, 0, sizeof(transaccion->parametros));
+        if (!pixeles && datos != NULL) {
+            memcpy(transaccion->parametros, datos,
+                   (largo < sizeof(transaccion->parametros)) ? largo : sizeof(transaccion->parametros));
+        }
+    } else {
+        errores++;
+    }
+
+    if (comando != PANEL_SIMULADO_SIN_COMANDO) {
+        escribiendo = (comando == ESCRIBIR_MEMORIA);
+        bytes_flujo = 0;
+    } else if (!escribiendo) {
+        errores++;
+    }
+    if (pixeles) {
+        if (bytes_flujo + largo <= sizeof(flujo)) {
+            memcpy(&flujo[bytes_flujo], datos, largo);
+        } else {
+            errores++;
+        }
+        bytes_flujo += largo;
+    }
+}
+
+/* === Public function implementation ============================================================================== */
+
+void PanelSimuladoReiniciar(void) {
+    cantidad = 0;
+    bytes_flujo = 0;
+    maximo_en_cola = 0;
+    errores = 0;
+}
+
+uint32_t PanelSimuladoTransacciones(const transaccion_simulada_t ** resultado) {
+    *resultado = transacciones;
+    return cantidad;
+}
+
+uint32_t PanelSimuladoPixeles(const uint8_t ** resultado) {
+    *resultado = flujo;
+    return bytes_flujo;
+}
+
+uint32_t PanelSimuladoMaximoEnCola(void) {
+    return maximo_en_cola;
+}
+
+uint32_t PanelSimuladoErrores(void) {
+    return errores;
+}
+
+void PanelSimuladoMemoriaDma(bool capaz) {
+    memoria_dma = capaz;
+}
+
+void vTaskDelay(TickType_t ticks) {
+    (void)ticks;
+}
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t maximo, UBaseType_t inicial) {
+    if (semaforos_creados >= SIMULADOS_MAXIMO) {
+        return NULL;
+    }
+    SemaphoreHandle_t semaforo = &semaforos[semaforos_creados++];
+    semaforo->cuenta = inicial;
+    semaforo->maximo = maximo;
+    return semaforo;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaforo, TickType_t espera) {
+    (void)espera;
+    /* El semáforo se libera cuando el DMA termina una transacción, se termina la más antigua de algún panel */
+    for (uint32_t indice = 0; semaforo->cuenta == 0 && indice < paneles_creados; indice++) {
+        if (paneles[indice].en_cola > 0) {
+            Terminar(&paneles[indice]);
+        }
+    }
+    if (semaforo->cuenta == 0) {
+        /* Sin transacciones en cola la tarea quedaría bloqueada para siempre */
+        errores++;
+        return pdFALSE;
+    }
+    semaforo->cuenta--;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t semaforo, BaseType_t * despertada) {
+    if (semaforo->cuenta >= semaforo->maximo) {
+        /* Una transacción terminada que no se cuenta */
+        errores++;
+        return pdFALSE;
+    }
+    semaforo->cuenta++;
+    *despertada = pdTRUE;
+    return pdTRUE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaforo) {
+    (void)semaforo;
+}
+
+void * heap_caps_malloc(size_t largo, uint32_t capacidades) {
+    (void)capacidades;
+    return malloc(largo);
+}
+
+void heap_caps_free(void * bloque) {
+    free(bloque);
+}
+
+bool esp_ptr_dma_capable(const void * puntero) {
+    (void)puntero;
+    return memoria_dma;
+}
+
+esp_err_t gpio_config(const gpio_config_t * configuracion) {
+    (void)configuracion;
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_level(gpio_num_t pin, uint32_t nivel) {
+    (void)pin;
+    (void)nivel;
+    return ESP_OK;
+}
+
+esp_err_t gpio_hold_en(gpio_num_t pin) {
+    (void)pin;
+    return ESP_OK;
+}
+
+esp_err_t gpio_hold_dis(gpio_num_t pin) {
+    (void)pin;
+    return ESP_OK;
+}
+
+void gpio_deep_sleep_hold_en(void) {
+}
+
+void gpio_deep_sleep_hold_dis(void) {
+}
+
+esp_err_t spi_bus_initialize(spi_host_device_t host, const spi_bus_config_t * configuracion, int dma) {
+    (void)host;
+    (void)configuracion;
+    (void)dma;
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_new_panel_io_spi(esp_lcd_spi_bus_handle_t bus, const esp_lcd_panel_io_spi_config_t * configuracion,
+                                   esp_lcd_panel_io_handle_t * io) {
+    (void)bus;
+    if (paneles_creados >= SIMULADOS_MAXIMO) {
+        return ESP_ERR_NO_MEM;
+    }
+    *io = &paneles[paneles_creados++];
+    (*io)->terminada = configuracion->on_color_trans_done;
+    (*io)->contexto = configuracion->user_ctx;
+    (*io)->profundidad = configuracion->trans_queue_depth;
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_new_i80_bus(const esp_lcd_i80_bus_config_t * configuracion, esp_lcd_i80_bus_handle_t * bus) {
+    static int bus_i80;
+
+    (void)configuracion;
+    *bus = (esp_lcd_i80_bus_handle_t)&bus_i80;
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_new_panel_io_i80(esp_lcd_i80_bus_handle_t bus, const esp_lcd_panel_io_i80_config_t * configuracion,
+                                   esp_lcd_panel_io_handle_t * io) {
+    (void)bus;
+    if (paneles_creados >= SIMULADOS_MAXIMO) {
+        return ESP_ERR_NO_MEM;
+    }
+    *io = &paneles[paneles_creados++];
+    (*io)->terminada = configuracion->on_color_trans_done;
+    (*io)->contexto = configuracion->user_ctx;
+    (*io)->profundidad = configuracion->trans_queue_depth;
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_io_tx_param(esp_lcd_panel_io_handle_t io, int comando, const void * parametros,
+                                    size_t largo) {
+    Vaciar(io);
+    Registrar(comando, false, parametros, largo);
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_io_tx_color(esp_lcd_panel_io_handle_t io, int comando, const void * datos, size_t largo) {
+    if (comando != PANEL_SIMULADO_SIN_COMANDO) {
+        Vaciar(io);
+    }
+    Registrar(comando, true, datos, largo);
+    io->en_cola++;
+    if (io->en_cola > io->profundidad) {
+        /* ESP-IDF bloquearía al controlador, que no espera más transacciones que las de la cola */
+        errores++;
+    }
+    if (io->en_cola > maximo_en_cola) {
+        maximo_en_cola = io->en_cola;
+    }
+    return ESP_OK;
+}
+
+/* === End of documentation ======================================================================================== */
@@ -0,0 +1,118 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+#ifndef PANEL_SIMULADO_H_
+#define PANEL_SIMULADO_H_
+
+/** @file panel_simulado.h
+ ** @brief Registro de las transacciones que el controlador del ILI9341 envía al panel simulado
+ **
+ ** El panel simulado guarda cada comando con sus parámetros y cada transacción de píxeles, y concatena los píxeles
+ ** enviados desde la última escritura de memoria. Las transacciones de píxeles quedan en cola como en el DMA y
+ ** terminan en orden cuando el controlador espera su semáforo o cuando envía un comando, que en ESP-IDF espera a
+ ** que se vacíe la cola. Los usos incorrectos de la interfaz se cuentan como errores.
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* === Cabecera C++ ================================================================================================ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* === Public macros definitions =================================================================================== */
+
+//! @brief Cantidad de transacciones que se registran desde @ref PanelSimuladoReiniciar
+#define PANEL_SIMULADO_TRANSACCIONES 4096
+
+//! @brief Cantidad de bytes de píxeles que se guardan después de una escritura de memoria
+#define PANEL_SIMULADO_PIXELES       (2 * 320 * 240 * 2)
+
+//! @brief Comando de las transacciones de píxeles que continúan la escritura de memoria anterior
+#define PANEL_SIMULADO_SIN_COMANDO   -1
+
+/* === Public data type declarations =============================================================================== */
+
+//! @brief Transacción enviada al panel
+typedef struct {
+    int comando;               //!< Comando enviado o @ref PANEL_SIMULADO_SIN_COMANDO
+    bool pixeles;              //!< Transacción de píxeles con DMA, o comando con sus parámetros
+    uint32_t bytes;            //!< Cantidad de bytes de parámetros o de píxeles, sin el comando
+    const uint8_t * origen;    //!< Memoria desde la que se enviaron los datos
+    uint8_t parametros[16];    //!< Primeros bytes de los parámetros
+} transaccion_simulada_t;
+
+/* === Public variable declarations ================================================================================ */
+
+/* === Public function declarations ================================================================================ */
+
+/**
+ * @brief Función que borra las transacciones y los errores registrados
+ */
+void PanelSimuladoReiniciar(void);
+
+/**
+ * @brief Función que devuelve las transacciones registradas desde @ref PanelSimuladoReiniciar
+ *
+ * @param[out] transacciones  Transacciones en el orden en que se enviaron
+ * @return uint32_t           Cantidad de transacciones registradas
+ */
+uint32_t PanelSimuladoTransacciones(const transaccion_simulada_t ** transacciones);
+
+/**
+ * @brief Función que devuelve los píxeles enviados desde el último comando de escritura de memoria
+ *
+ * @param[out] pixeles  Bytes de los píxeles en el orden del bus
+ * @return uint32_t     Cantidad de bytes enviados
+ */
+uint32_t PanelSimuladoPixeles(const uint8_t ** pixeles);
+
+/**
+ * @brief Función que devuelve la mayor cantidad de transacciones de píxeles que estuvieron en cola a la vez
+ *
+ * @return uint32_t  Transacciones en cola sin terminar
+ */
+uint32_t PanelSimuladoMaximoEnCola(void);
+
+/**
+ * @brief Función que devuelve la cantidad de usos incorrectos de la interfaz del panel
+ *
+ * @return uint32_t  Píxeles fuera de una escritura de memoria, colas excedidas, semáforos que no se liberarían o
+ *                   transacciones que no se pudieron registrar
+ */
+uint32_t PanelSimuladoErrores(void);
+
+/**
+ * @brief Función que indica si el DMA puede leer la memoria de los datos que se envían
+ *
+ * @param  capaz  Verdadero si los datos están en la memoria interna, falso si están en la memoria flash
+ */
+void PanelSimuladoMemoriaDma(bool capaz);
+
+/* === End of documentation ======================================================================================== */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PANEL_SIMULADO_H_ */
@@ -0,0 +1,72 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+#ifndef PRUEBA_H_
+#define PRUEBA_H_
+
+/** @file prueba.h
+ ** @brief Verificaciones y medición de tiempo para las pruebas de los módulos en la computadora de desarrollo
+ **
+ ** Cada prueba es un programa que compila los módulos de main sin ESP_PLATFORM, verifica su comportamiento con
+ ** @ref VERIFICAR y termina con @ref PRUEBA_RESULTADO, que devuelve un código distinto de cero si alguna verificación
+ ** falló. Las mediciones de rendimiento solo se informan, no hacen fallar la prueba.
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include <stdio.h>
+#include <time.h>
+
+/* === Public macros definitions =================================================================================== */
+
+//! @brief Verifica una condición, si no se cumple informa el archivo y la línea y la prueba falla al terminar
+#define VERIFICAR(condicion)                                                                                           \
+    do {                                                                                                               \
+        prueba_verificaciones++;                                                                                       \
+        if (!(condicion)) {                                                                                            \
+            prueba_fallas++;                                                                                           \
+            printf("%s:%d: falló %s\n", __FILE__, __LINE__, #condicion);                                               \
+        }                                                                                                              \
+    } while (0)
+
+//! @brief Informa la cantidad de verificaciones y devuelve el código de salida de la prueba
+#define PRUEBA_RESULTADO()                                                                                             \
+    (printf("%d verificaciones, %d fallas\n", prueba_verificaciones, prueba_fallas), prueba_fallas != 0)
+
+/* === Public variable declarations ================================================================================ */
+
+static int prueba_verificaciones; //!< Cantidad de verificaciones realizadas
+static int prueba_fallas;         //!< Cantidad de verificaciones que fallaron
+
+/* === Public function declarations ================================================================================ */
+
+/**
+ * @brief Función que devuelve un instante del reloj monótono, para medir el rendimiento
+ *
+ * @return double  Instante en segundos
+ */
+static inline double PruebaSegundos(void) {
+    struct timespec ahora;
+    clock_gettime(CLOCK_MONOTONIC, &ahora);
+    return ahora.tv_sec + ahora.tv_nsec * 1e-9;
+}
+
+/* === End of documentation ======================================================================================== */
+
+#endif /* PRUEBA_H_ */
@@ -0,0 +1,183 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+/** @file test_antirrebote.c
+ ** @brief Pruebas del antirrebote en paralelo con contadores verticales
+ **
+ ** Verifica los casos básicos con pocas entradas y compara las 32 entradas con un modelo que lleva un contador por
+ ** entrada, con muestras al azar que rebotan. Informa el tiempo de procesar una muestra de 32 entradas.
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include "antirrebote.h"
+#include "prueba.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/* === Macros definitions ========================================================================================== */
+
+#define PULSADOR    (1UL << 0) //!< Entrada activa en nivel bajo
+#define PULSADOR_2  (1UL << 1) //!< Entrada activa en nivel bajo
+#define SENSOR      (1UL << 2) //!< Entrada activa en nivel alto
+#define NO_ENTRADA  (1UL << 4) //!< Bit de la muestra que no es una entrada
+#define REPOSO      (PULSADOR | PULSADOR_2) //!< Muestra sin ninguna entrada activa
+
+/* === Private variable definitions ================================================================================ */
+
+//! @brief Estado de las entradas del modelo de referencia
+static uint8_t cuentas[32];
+static uint32_t estables;
+
+/* === Private function definitions ================================================================================ */
+
+//! @brief Procesa una muestra y devuelve los flancos en un solo valor, activadas en los 32 bits altos
+static uint64_t Muestrear(antirrebote_t grupo, uint32_t muestra, bool * inestable) {
+    uint32_t activadas, desactivadas;
+    bool resultado = AntirreboteMuestrear(grupo, muestra, &activadas, &desactivadas);
+    if (inestable) {
+        *inestable = resultado;
+    }
+    return ((uint64_t)activadas << 32) | desactivadas;
+}
+
+//! @brief Modelo con un contador por entrada, sin entradas invertidas
+static uint64_t Referencia(uint32_t muestra, bool * inestable) {
+    uint32_t activadas = 0, desactivadas = 0;
+
+    *inestable = false;
+    for (int bit = 0; bit < 32; bit++) {
+        uint32_t mascara = 1UL << bit;
+        if ((muestra ^ estables) & mascara) {
+            if (++cuentas[bit] == ANTIRREBOTE_MUESTRAS) {
+                cuentas[bit] = 0;
+                estables ^= mascara;
+                *((muestra & mascara) ? &activadas : &desactivadas) |= mascara;
+            } else {
+                *inestable = true;
+            }
+        } else {
+            cuentas[bit] = 0;
+        }
+    }
+    return ((uint64_t)activadas << 32) | desactivadas;
+}
+
+//! @brief Pulsaciones, rebotes y liberaciones de pocas entradas
+static void PruebaEntradas(antirrebote_t grupo) {
+    bool inestable;
+
+    /* Un nivel nuevo se acepta en la cuarta muestra seguida */
+    for (int muestra = 1; muestra < ANTIRREBOTE_MUESTRAS; muestra++) {
+        VERIFICAR(Muestrear(grupo, REPOSO & ~PULSADOR, &inestable) == 0);
+        VERIFICAR(inestable);
+    }
+    VERIFICAR(Muestrear(grupo, REPOSO & ~PULSADOR, &inestable) == ((uint64_t)PULSADOR << 32));
+    VERIFICAR(!inestable);
+    VERIFICAR(AntirreboteActivas(grupo) == PULSADOR);
+
+    /* Un rebote antes de completar las muestras vuelve a empezar la cuenta */
+    for (int muestra = 1; muestra < ANTIRREBOTE_MUESTRAS; muestra++) {
+        VERIFICAR(Muestrear(grupo, REPOSO, NULL) == 0);
+    }
+    VERIFICAR(Muestrear(grupo, REPOSO & ~PULSADOR, &inestable) == 0);
+    VERIFICAR(!inestable);
+    for (int muestra = 1; muestra < ANTIRREBOTE_MUESTRAS; muestra++) {
+        VERIFICAR(Muestrear(grupo, REPOSO, NULL) == 0);
+    }
+    VERIFICAR(Muestrear(grupo, REPOSO, &inestable) == PULSADOR);
+    VERIFICAR(!inestable);
+    VERIFICAR(AntirreboteActivas(grupo) == 0);
+
+    /* Entradas invertidas y directas a la vez, los bits que no son entradas se ignoran */
+    uint32_t activas = SENSOR | PULSADOR_2 | NO_ENTRADA;
+    for (int muestra = 1; muestra < ANTIRREBOTE_MUESTRAS; muestra++) {
+        VERIFICAR(Muestrear(grupo, PULSADOR | SENSOR | NO_ENTRADA, NULL) == 0);
+    }
+    VERIFICAR(Muestrear(grupo, PULSADOR | SENSOR | NO_ENTRADA, &inestable) ==
+              ((uint64_t)(activas & ~NO_ENTRADA) << 32));
+    VERIFICAR(AntirreboteActivas(grupo) == (SENSOR | PULSADOR_2));
+    VERIFICAR(Muestrear(grupo, PULSADOR | SENSOR, &inestable) == 0);
+    VERIFICAR(!inestable);
+
+    /* Cada entrada cuenta por separado: una se libera mientras la otra rebota */
+    for (int muestra = 0; muestra < ANTIRREBOTE_MUESTRAS; muestra++) {
+        uint32_t rebote = (muestra % 2) ? SENSOR : 0;
+        uint64_t flancos = Muestrear(grupo, REPOSO | rebote, &inestable);
+        VERIFICAR(flancos == ((muestra == ANTIRREBOTE_MUESTRAS - 1) ? PULSADOR_2 : 0));
+        VERIFICAR(inestable == (muestra < ANTIRREBOTE_MUESTRAS - 1)); /* La última muestra del sensor coincide */
+    }
+    VERIFICAR(AntirreboteActivas(grupo) == SENSOR);
+}
+
+//! @brief Las 32 entradas coinciden con el modelo de referencia con muestras al azar que rebotan
+static void PruebaReferencia(antirrebote_t grupo) {
+    uint32_t azar = 1, nivel = 0, diferencias = 0;
+
+    for (uint32_t paso = 0; paso < 1000000; paso++) {
+        azar ^= azar << 13;
+        azar ^= azar >> 17;
+        azar ^= azar << 5;
+        /* El nivel de cada entrada cambia pocas veces y cada muestra tiene rebotes en algunas entradas */
+        if ((azar & 0xFF) == 0) {
+            nivel ^= azar;
+        }
+        uint32_t muestra = nivel ^ (((paso & 7) < 3) ? (azar & (azar >> 7) & (azar >> 14)) : 0);
+
+        bool inestable, esperado_inestable;
+        uint64_t flancos = Muestrear(grupo, muestra, &inestable);
+        uint64_t esperado = Referencia(muestra, &esperado_inestable);
+        diferencias += (flancos != esperado) || (inestable != esperado_inestable) ||
+                       (AntirreboteActivas(grupo) != estables);
+    }
+    VERIFICAR(diferencias == 0);
+}
+
+//! @brief Tiempo de procesar una muestra de 32 entradas
+static void MedirRendimiento(antirrebote_t grupo) {
+    const uint32_t muestras = 50000000;
+    uint32_t azar = 1, flancos = 0, activadas;
+
+    double inicio = PruebaSegundos();
+    for (uint32_t paso = 0; paso < muestras; paso++) {
+        azar ^= azar << 13;
+        azar ^= azar >> 17;
+        azar ^= azar << 5;
+        AntirreboteMuestrear(grupo, azar & 0x0F0F0F0F, &activadas, NULL);
+        flancos += __builtin_popcount(activadas);
+    }
+    double duracion = PruebaSegundos() - inicio;
+    printf("Muestreo: %.2f ns por muestra de 32 entradas (%u flancos)\n", duracion / muestras * 1e9, flancos);
+}
+
+/* === Public function implementation ============================================================================== */
+
+int main(void) {
+    antirrebote_t pulsadores = AntirreboteCrear(PULSADOR | PULSADOR_2 | SENSOR, PULSADOR | PULSADOR_2, REPOSO);
+    antirrebote_t todas = AntirreboteCrear(UINT32_MAX, 0, 0);
+    VERIFICAR((pulsadores != NULL) && (todas != NULL));
+    VERIFICAR(AntirreboteCrear(UINT32_MAX, 0, 0) == NULL);
+
+    PruebaEntradas(pulsadores);
+    PruebaReferencia(todas);
+    MedirRendimiento(todas);
+    return PRUEBA_RESULTADO();
+}
+
+/* === End of documentation ======================================================================================== */
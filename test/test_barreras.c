@@ -0,0 +1,169 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+/** @file test_barreras.c
+ ** @brief Pruebas de la conversión de las capturas y del filtrado de los flancos de las barreras de luz
+ **
+ ** Las capturas se generan con un temporizador de 80 MHz que arranca cerca del paso por cero de su cuenta de 32 bits,
+ ** así la conversión al reloj de alta resolución se verifica antes, durante y después de cada vuelta.
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include "barreras.h"
+#include "prueba.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* === Macros definitions ========================================================================================== */
+
+//! @brief Frecuencia del temporizador de captura, la del MCPWM en el ESP32
+#define RESOLUCION_HZ 80000000U
+
+//! @brief Valor del temporizador de captura en el instante cero, a 3,2 segundos de dar la vuelta
+#define CUENTA_INICIAL 0xF0000000U
+
+//! @brief Cantidad máxima de avisos que se registran por barrera
+#define AVISOS_MAXIMO 32
+
+/* === Private data type declarations ============================================================================== */
+
+//! @brief Avisos recibidos de una barrera
+typedef struct {
+    uint32_t cantidad;                //!< Cantidad de avisos recibidos
+    int64_t instantes[AVISOS_MAXIMO]; //!< Instante de cada aviso
+    bool despertar;                   //!< Valor que devuelve la función de aviso
+} avisos_t;
+
+/* === Private variable definitions ================================================================================ */
+
+static avisos_t largada; //!< Avisos de la barrera que corta por flanco de bajada con bloqueo
+static avisos_t llegada; //!< Avisos de la barrera que corta por ambos flancos sin bloqueo
+
+/* === Private function definitions ================================================================================ */
+
+//! @brief Registra el instante de cada corte aceptado
+static bool Aviso(barrera_t barrera, int64_t instante_us, void * contexto) {
+    avisos_t * avisos = contexto;
+
+    (void)barrera;
+    if (avisos->cantidad < AVISOS_MAXIMO) {
+        avisos->instantes[avisos->cantidad] = instante_us;
+    }
+    avisos->cantidad++;
+    return avisos->despertar;
+}
+
+//! @brief Valor del temporizador de captura en un instante, contando las vueltas de la cuenta
+static uint32_t Captura(int64_t instante_us) {
+    return CUENTA_INICIAL + (uint32_t)(instante_us * (RESOLUCION_HZ / 1000000));
+}
+
+//! @brief Después de un corte se descartan los flancos del bloqueo, medido desde el último corte aceptado
+static void PruebaBloqueo(barrera_t barrera) {
+    const struct {
+        int64_t instante_us;
+        bool subida;
+    } flancos[] = {
+        {2000000, false}, /* Corte del torso */
+        {2000020, true},  /* Rebote, flanco de subida que no corresponde a la barrera */
+        {2050000, false}, /* Brazos y piernas durante el bloqueo */
+        {2100000, true},  {2250000, false}, {2299999, false},
+        {2300000, false}, /* Termina el bloqueo del primer corte */
+        {2550000, false}, /* Bloqueo del segundo corte */
+        {2600000, false},
+    };
+
+    BarrerasSincronizar(Captura(1000000), 1000000);
+    for (size_t indice = 0; indice < sizeof(flancos) / sizeof(flancos[0]); indice++) {
+        BarreraCapturar(barrera, Captura(flancos[indice].instante_us), flancos[indice].subida);
+    }
+    VERIFICAR(largada.cantidad == 3);
+    VERIFICAR(largada.instantes[0] == 2000000);
+    VERIFICAR(largada.instantes[1] == 2300000);
+    VERIFICAR(largada.instantes[2] == 2600000);
+    /* Los flancos de subida no se cuentan como descartados, el receptor no los entrega */
+    VERIFICAR(BarreraDescartados(barrera) == 4);
+}
+
+//! @brief Sin bloqueo se acepta cada flanco configurado y la función de aviso decide si se cambia de tarea
+static void PruebaFlancos(barrera_t barrera) {
+    BarrerasSincronizar(Captura(1000000), 1000000);
+    llegada.despertar = true;
+    VERIFICAR(BarreraCapturar(barrera, Captura(3000000), true));
+    llegada.despertar = false;
+    VERIFICAR(!BarreraCapturar(barrera, Captura(3000001), false));
+    VERIFICAR(llegada.cantidad == 2);
+    VERIFICAR(llegada.instantes[0] == 3000000 && llegada.instantes[1] == 3000001);
+    VERIFICAR(BarreraDescartados(barrera) == 0);
+}
+
+//! @brief Las capturas se convierten con la referencia vigente aunque la cuenta dé la vuelta entre ambas
+static void PruebaVueltas(barrera_t barrera) {
+    uint32_t correctos = 0, casos = 0;
+
+    /* Referencias renovadas cada 10 s durante 200 s, la cuenta da la vuelta cada 53,7 s */
+    for (int64_t segundos = 10; segundos < 200; segundos += 10) {
+        int64_t referencia_us = segundos * 1000000;
+        BarrerasSincronizar(Captura(referencia_us), referencia_us);
+        /* Al final del periodo y con una fracción de microsegundo que se descarta */
+        int64_t instante_us = referencia_us + 9999999;
+        uint32_t antes = llegada.cantidad;
+        BarreraCapturar(barrera, Captura(instante_us) + RESOLUCION_HZ / 1000000 - 1, true);
+        correctos += (llegada.cantidad == antes + 1) && (llegada.instantes[antes % AVISOS_MAXIMO] == instante_us);
+        casos++;
+        llegada.cantidad %= AVISOS_MAXIMO;
+    }
+    VERIFICAR(correctos == casos);
+
+    /* Referencia justo antes del paso por cero y captura justo después */
+    llegada.cantidad = 0;
+    BarrerasSincronizar(0xFFFFFF00U, 500000000);
+    BarreraCapturar(barrera, 0x00000100U, true);
+    VERIFICAR(llegada.cantidad == 1 && llegada.instantes[0] == 500000000 + 512 / (RESOLUCION_HZ / 1000000));
+}
+
+//! @brief Un flanco capturado antes de tomar la referencia se convierte a un instante anterior
+static void PruebaAnterior(barrera_t barrera) {
+    llegada.cantidad = 0;
+    BarrerasSincronizar(Captura(9000000), 9000000);
+    BarreraCapturar(barrera, Captura(8000000), false);
+    BarreraCapturar(barrera, Captura(8999999), true);
+    VERIFICAR(llegada.cantidad == 2);
+    VERIFICAR(llegada.instantes[0] == 8000000 && llegada.instantes[1] == 8999999);
+}
+
+/* === Public function implementation ============================================================================== */
+
+int main(void) {
+    VERIFICAR(BarrerasIniciar(RESOLUCION_HZ));
+    barrera_t primera = BarreraCrear(34, BARRERA_BAJADA, 300000, Aviso, &largada);
+    barrera_t segunda = BarreraCrear(35, BARRERA_AMBOS, 0, Aviso, &llegada);
+    VERIFICAR(primera != NULL && segunda != NULL && primera != segunda);
+    VERIFICAR(BarreraCrear(36, BARRERA_SUBIDA, 0, Aviso, NULL) == NULL);
+
+    PruebaBloqueo(primera);
+    PruebaFlancos(segunda);
+    PruebaAnterior(segunda);
+    PruebaVueltas(segunda);
+    return PRUEBA_RESULTADO();
+}
+
+/* === End of documentation ======================================================================================== */
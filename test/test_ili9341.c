@@ -0,0 +1,420 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+/** @file test_ili9341.c
+ ** @brief Pruebas de los bytes que el controlador del ILI9341 envía al panel
+ **
+ ** El controlador se compila con los encabezados de ESP-IDF de la carpeta mocks, que registran cada comando con sus
+ ** parámetros y cada transacción de píxeles. Se verifica la secuencia de inicio, la ventana y los píxeles de los
+ ** rellenos y la división de las imágenes y los lienzos en transacciones con DMA.
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include "ili9341.h"
+#include "panel_simulado.h"
+#include "prueba.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+/* === Macros definitions ========================================================================================== */
+
+//! @brief Bytes de una transacción de píxeles, 16 líneas de 320 píxeles más 8 bytes redondeado a palabras
+#define BLIT_CHUNK        ((16 * 320 * 2 + 8) & ~3)
+
+//! @brief Transacciones de píxeles que el controlador pone en cola al enviar un lienzo
+#define BLIT_QUEUE        6
+
+//! @brief Bytes de cada transacción de píxeles de un relleno
+#define BYTES_RELLENO     256
+
+//! @brief Bytes del encabezado de una imagen comprimida, ancho y alto de 16 bits y cantidad de colores de 8 bits
+#define RLE_ENCABEZADO    5
+
+//! @brief Bit del encabezado de un paquete que indica una repetición de un mismo índice
+#define RLE_REPETICION    0x80
+
+//! @brief Píxeles de la imagen comprimida de prueba, 50 líneas de toda la pantalla
+#define RLE_PIXELES       (ILI9341_WIDTH * 50)
+
+#define RESET             0x01
+#define SLEEP_OUT         0x11
+#define DISPLAY_ON        0x29
+#define COLUMN_ADDR_SET   0x2A
+#define PAGE_ADDR_SET     0x2B
+#define MEM_WRITE         0x2C
+#define PWR_CTRL_A        0xCB
+
+/* === Private variable definitions ================================================================================ */
+
+static ili9341_t pantalla;                             //!< Pantalla creada al iniciar la prueba
+static uint16_t lienzo[ILI9341_WIDTH * ILI9341_HEIGHT]; //!< Píxeles de un lienzo del tamaño de la pantalla
+static uint8_t imagen[ILI9341_WIDTH * 45 * 2 + 4];     //!< Imagen con espacio para desalinearla
+static uint8_t comprimida[RLE_ENCABEZADO + 512 + 2 * RLE_PIXELES]; //!< Imagen comprimida armada por la prueba
+static uint8_t esperados[2 * RLE_PIXELES];                           //!< Píxeles que se esperan de la imagen comprimida
+static uint32_t comprimidos;                                         //!< Bytes escritos en la imagen comprimida
+static uint32_t expandidos;                                          //!< Píxeles que se esperan de la imagen comprimida
+
+/* === Private function definitions ================================================================================ */
+
+//! @brief Verifica que las dos transacciones sean la ventana de direcciones indicada
+static void VerificarVentana(const transaccion_simulada_t * transaccion, uint16_t x0, uint16_t y0, uint16_t x1,
+                             uint16_t y1) {
+    const uint8_t columnas[] = {x0 >> 8, x0 & 0xFF, x1 >> 8, x1 & 0xFF};
+    const uint8_t filas[] = {y0 >> 8, y0 & 0xFF, y1 >> 8, y1 & 0xFF};
+
+    VERIFICAR(transaccion[0].comando == COLUMN_ADDR_SET && !transaccion[0].pixeles && transaccion[0].bytes == 4);
+    VERIFICAR(memcmp(transaccion[0].parametros, columnas, sizeof(columnas)) == 0);
+    VERIFICAR(transaccion[1].comando == PAGE_ADDR_SET && !transaccion[1].pixeles && transaccion[1].bytes == 4);
+    VERIFICAR(memcmp(transaccion[1].parametros, filas, sizeof(filas)) == 0);
+}
+
+//! @brief Verifica que los píxeles se envíen desde el origen indicado en transacciones del tamaño máximo
+static void VerificarDivision(const transaccion_simulada_t * transaccion, uint32_t cantidad, uint32_t bytes,
+                              const uint8_t * origen) {
+    uint32_t esperadas = (bytes + BLIT_CHUNK - 1) / BLIT_CHUNK;
+
+    VERIFICAR(cantidad == esperadas);
+    for (uint32_t indice = 0; indice < cantidad && indice < esperadas; indice++) {
+        uint32_t largo = (indice < esperadas - 1) ? BLIT_CHUNK : bytes - indice * BLIT_CHUNK;
+        VERIFICAR(transaccion[indice].pixeles && transaccion[indice].comando == PANEL_SIMULADO_SIN_COMANDO);
+        VERIFICAR(transaccion[indice].bytes == largo);
+        if (origen != NULL) {
+            VERIFICAR(transaccion[indice].origen == origen + indice * BLIT_CHUNK);
+        }
+    }
+}
+
+//! @brief Agrega a la imagen comprimida un paquete y sus píxeles a los esperados, con el color de cada índice
+static void AgregarPaquete(bool repeticion, uint32_t cantidad, uint8_t indice) {
+    comprimida[comprimidos++] = (repeticion ? RLE_REPETICION : 0) | (cantidad - 1);
+    for (uint32_t pixel = 0; pixel < cantidad; pixel++) {
+        if (!repeticion || pixel == 0) {
+            comprimida[comprimidos++] = indice;
+        }
+        /* El byte alto de cada color es el índice y el bajo su complemento, así se nota un orden equivocado */
+        esperados[2 * expandidos] = indice;
+        esperados[2 * expandidos + 1] = ~indice;
+        expandidos++;
+        if (!repeticion) {
+            indice += 37;
+        }
+    }
+}
+
+//! @brief Completa la imagen comprimida hasta el píxel indicado alternando repeticiones e índices sueltos
+static void CompletarPaquetes(uint32_t hasta) {
+    bool repeticion = true;
+
+    while (expandidos < hasta) {
+        uint32_t cantidad = (hasta - expandidos < 128) ? hasta - expandidos : 128;
+        AgregarPaquete(repeticion, cantidad, expandidos);
+        repeticion = !repeticion;
+    }
+}
+
+//! @brief El inicio envía el reinicio, la configuración y el encendido, y borra toda la pantalla
+static void PruebaInicio(void) {
+    const uint8_t pwr_ctrl_a[] = {0x39, 0x2C, 0x00, 0x34, 0x02};
+    const uint32_t configuracion = 20; /* Comandos de la configuración inicial */
+    const uint32_t relleno = ILI9341_WIDTH * ILI9341_HEIGHT * 2 / BYTES_RELLENO;
+    const transaccion_simulada_t * transaccion;
+    const uint8_t * pixeles;
+    bool negros = true;
+
+    ili9341_config_t configuracion_bus = ILI9341_DEFAULT_CONFIG();
+    pantalla = ILI9341Init(&configuracion_bus);
+    VERIFICAR(pantalla != NULL);
+
+    uint32_t cantidad = PanelSimuladoTransacciones(&transaccion);
+    VERIFICAR(cantidad == 1 + configuracion + 2 + 3 + relleno);
+    VERIFICAR(transaccion[0].comando == RESET && transaccion[0].bytes == 0);
+    VERIFICAR(transaccion[1].comando == PWR_CTRL_A && transaccion[1].bytes == sizeof(pwr_ctrl_a));
+    VERIFICAR(memcmp(transaccion[1].parametros, pwr_ctrl_a, sizeof(pwr_ctrl_a)) == 0);
+    for (uint32_t indice = 0; indice <= configuracion; indice++) {
+        VERIFICAR(!transaccion[indice].pixeles);
+    }
+    VERIFICAR(transaccion[configuracion + 1].comando == SLEEP_OUT);
+    VERIFICAR(transaccion[configuracion + 2].comando == DISPLAY_ON);
+    VerificarVentana(&transaccion[configuracion + 3], 0, 0, ILI9341_WIDTH - 1, ILI9341_HEIGHT - 1);
+    VERIFICAR(transaccion[configuracion + 5].comando == MEM_WRITE && transaccion[configuracion + 5].bytes == 0);
+
+    uint32_t bytes = PanelSimuladoPixeles(&pixeles);
+    VERIFICAR(bytes == ILI9341_WIDTH * ILI9341_HEIGHT * 2);
+    for (uint32_t indice = 0; indice < bytes; indice++) {
+        negros = negros && (pixeles[indice] == 0);
+    }
+    VERIFICAR(negros);
+    VERIFICAR(PanelSimuladoErrores() == 0);
+}
+
+//! @brief Un relleno envía la ventana ordenada y el color con el byte alto primero, contando cada byte
+static void PruebaRelleno(void) {
+    const transaccion_simulada_t * transaccion;
+    const uint8_t * pixeles;
+    ili9341_stats_t estadisticas;
+    bool color = true;
+
+    PanelSimuladoReiniciar();
+    ILI9341ResetStats(pantalla);
+    ILI9341DrawFilledRectangle(pantalla, 10, 20, 109, 29, 0x1234);
+
+    uint32_t cantidad = PanelSimuladoTransacciones(&transaccion);
+    VERIFICAR(cantidad == 3 + 8);
+    VerificarVentana(transaccion, 10, 20, 109, 29);
+    VERIFICAR(transaccion[2].comando == MEM_WRITE && !transaccion[2].pixeles);
+    for (uint32_t indice = 3; indice < cantidad; indice++) {
+        VERIFICAR(transaccion[indice].pixeles && transaccion[indice].comando == PANEL_SIMULADO_SIN_COMANDO);
+        VERIFICAR(transaccion[indice].bytes == ((indice < cantidad - 1) ? BYTES_RELLENO : 2000 - 7 * BYTES_RELLENO));
+    }
+    uint32_t bytes = PanelSimuladoPixeles(&pixeles);
+    VERIFICAR(bytes == 100 * 10 * 2);
+    for (uint32_t indice = 0; indice < bytes; indice += 2) {
+        color = color && (pixeles[indice] == 0x12) && (pixeles[indice + 1] == 0x34);
+    }
+    VERIFICAR(color);
+
+    ILI9341GetStats(pantalla, &estadisticas);
+    VERIFICAR(estadisticas.commands == 3);
+    VERIFICAR(estadisticas.data_transactions == 2 + 8);
+    VERIFICAR(estadisticas.bytes == 2 * (1 + 4) + 1 + 2000);
+    VERIFICAR(estadisticas.window_sets == 1 && estadisticas.redundant_window_sets == 0);
+
+    /* Con las esquinas invertidas la ventana es la misma, se envía igual y se cuenta como repetida */
+    PanelSimuladoReiniciar();
+    ILI9341DrawFilledRectangle(pantalla, 109, 29, 10, 20, 0x1234);
+    PanelSimuladoTransacciones(&transaccion);
+    VerificarVentana(transaccion, 10, 20, 109, 29);
+    ILI9341GetStats(pantalla, &estadisticas);
+    VERIFICAR(estadisticas.window_sets == 2 && estadisticas.redundant_window_sets == 1);
+    VERIFICAR(PanelSimuladoErrores() == 0);
+}
+
+//! @brief Un lienzo se envía desde su memoria, sin copias, con la cola de transacciones llena
+static void PruebaLienzo(void) {
+    const transaccion_simulada_t * transaccion;
+    const uint8_t * pixeles;
+    ili9341_canvas_t canvas;
+
+    for (uint32_t indice = 0; indice < sizeof(lienzo) / sizeof(lienzo[0]); indice++) {
+        lienzo[indice] = (indice * 2654435761U) >> 16;
+    }
+    ILI9341CanvasInit(&canvas, lienzo, ILI9341_WIDTH, ILI9341_HEIGHT);
+    PanelSimuladoReiniciar();
+    ILI9341BlitCanvas(pantalla, &canvas, 0, 0);
+
+    uint32_t cantidad = PanelSimuladoTransacciones(&transaccion);
+    VerificarVentana(transaccion, 0, 0, ILI9341_WIDTH - 1, ILI9341_HEIGHT - 1);
+    VERIFICAR(transaccion[2].comando == MEM_WRITE && !transaccion[2].pixeles);
+    VerificarDivision(&transaccion[3], cantidad - 3, sizeof(lienzo), (const uint8_t *)lienzo);
+    VERIFICAR(PanelSimuladoPixeles(&pixeles) == sizeof(lienzo));
+    VERIFICAR(memcmp(pixeles, lienzo, sizeof(lienzo)) == 0);
+    VERIFICAR(PanelSimuladoMaximoEnCola() == BLIT_QUEUE);
+    VERIFICAR(PanelSimuladoErrores() == 0);
+
+    /* Un lienzo chico entra en una sola transacción, en la ventana de su posición */
+    ILI9341CanvasInit(&canvas, lienzo, 15, 15);
+    PanelSimuladoReiniciar();
+    ILI9341BlitCanvas(pantalla, &canvas, 100, 50);
+    cantidad = PanelSimuladoTransacciones(&transaccion);
+    VerificarVentana(transaccion, 100, 50, 114, 64);
+    VerificarDivision(&transaccion[3], cantidad - 3, 15 * 15 * 2, (const uint8_t *)lienzo);
+
+    /* Con un lienzo como destino los dibujos no usan el bus */
+    PanelSimuladoReiniciar();
+    ILI9341SetTarget(pantalla, &canvas);
+    ILI9341DrawFilledRectangle(pantalla, 2, 2, 12, 12, 0xF800);
+    ILI9341SetTarget(pantalla, NULL);
+    VERIFICAR(PanelSimuladoTransacciones(&transaccion) == 0);
+    VERIFICAR(lienzo[2 * 15 + 2] == 0x00F8 && lienzo[0] != 0x00F8);
+    VERIFICAR(PanelSimuladoErrores() == 0);
+}
+
+//! @brief Las imágenes que el DMA no puede leer pasan por dos memorias intermedias, las demás se envían sin copias
+static void PruebaImagen(void) {
+    const uint32_t bytes = ILI9341_WIDTH * 45 * 2;
+    const transaccion_simulada_t * transaccion;
+    const uint8_t * pixeles;
+
+    for (uint32_t indice = 0; indice < sizeof(imagen); indice++) {
+        imagen[indice] = indice * 7 + (indice >> 9);
+    }
+
+    /* Desde la memoria flash y desalineada, se copia alternando las memorias intermedias */
+    PanelSimuladoMemoriaDma(false);
+    PanelSimuladoReiniciar();
+    ILI9341DrawPicture(pantalla, 0, 0, ILI9341_WIDTH, 45, &imagen[1]);
+    uint32_t cantidad = PanelSimuladoTransacciones(&transaccion);
+    VerificarVentana(transaccion, 0, 0, ILI9341_WIDTH - 1, 44);
+    VERIFICAR(transaccion[2].comando == MEM_WRITE && !transaccion[2].pixeles);
+    VerificarDivision(&transaccion[3], cantidad - 3, bytes, NULL);
+    VERIFICAR(cantidad == 6);
+    VERIFICAR(transaccion[3].origen != transaccion[4].origen && transaccion[3].origen == transaccion[5].origen);
+    VERIFICAR(transaccion[3].origen < imagen || transaccion[3].origen >= imagen + sizeof(imagen));
+    VERIFICAR(PanelSimuladoPixeles(&pixeles) == bytes);
+    VERIFICAR(memcmp(pixeles, &imagen[1], bytes) == 0);
+    VERIFICAR(PanelSimuladoMaximoEnCola() <= 2);
+
+    /* Desde la memoria interna, cada transacción se envía desde la imagen */
+    PanelSimuladoMemoriaDma(true);
+    PanelSimuladoReiniciar();
+    ILI9341DrawPicture(pantalla, 0, 0, ILI9341_WIDTH, 45, imagen);
+    cantidad = PanelSimuladoTransacciones(&transaccion);
+    VerificarDivision(&transaccion[3], cantidad - 3, bytes, imagen);
+    VERIFICAR(PanelSimuladoPixeles(&pixeles) == bytes);
+    VERIFICAR(memcmp(pixeles, imagen, bytes) == 0);
+    PanelSimuladoMemoriaDma(false);
+    VERIFICAR(PanelSimuladoErrores() == 0);
+}
+
+//! @brief Los sprites se expanden con la paleta, con el primer pixel en el bit más significativo de cada byte
+static void PruebaSprite(void) {
+    /* Filas de 10 pixeles en 2 bytes y de 5 pixeles en 3 bytes, los bits de relleno no se dibujan */
+    static const uint8_t datos_1bpp[] = {0xB2, 0xC5, 0x4D, 0x7F};
+    static const uint8_t indices_1bpp[] = {1, 0, 1, 1, 0, 0, 1, 0, 1, 1, 0, 1, 0, 0, 1, 1, 0, 1, 0, 1};
+    static const uint8_t datos_4bpp[] = {0x12, 0x3F, 0x8A, 0xE0, 0x75, 0xC3};
+    static const uint8_t indices_4bpp[] = {0x1, 0x2, 0x3, 0xF, 0x8, 0xE, 0x0, 0x7, 0x5, 0xC};
+    static const struct {
+        ili9341_sprite_t sprite;
+        const uint8_t * indices;
+    } casos[] = {
+        {{.width = 10, .height = 2, .bpp = 1, .data = datos_1bpp}, indices_1bpp},
+        {{.width = 5, .height = 2, .bpp = 4, .data = datos_4bpp}, indices_4bpp},
+    };
+    const transaccion_simulada_t * transaccion;
+    const uint8_t * pixeles;
+    uint16_t paleta[16];
+
+    for (uint32_t indice = 0; indice < 16; indice++) {
+        paleta[indice] = 0x1200 + indice * 0x0103;
+    }
+    for (uint32_t caso = 0; caso < sizeof(casos) / sizeof(casos[0]); caso++) {
+        const ili9341_sprite_t * sprite = &casos[caso].sprite;
+        uint32_t cantidad = sprite->width * sprite->height;
+
+        PanelSimuladoReiniciar();
+        ILI9341DrawSprite(pantalla, 30, 40, sprite, paleta);
+        PanelSimuladoTransacciones(&transaccion);
+        VerificarVentana(transaccion, 30, 40, 30 + sprite->width - 1, 40 + sprite->height - 1);
+        VERIFICAR(transaccion[2].comando == MEM_WRITE && !transaccion[2].pixeles);
+        VERIFICAR(PanelSimuladoPixeles(&pixeles) == 2 * cantidad);
+        for (uint32_t indice = 0; indice < cantidad; indice++) {
+            uint16_t color = paleta[casos[caso].indices[indice]];
+            VERIFICAR(pixeles[2 * indice] == (color >> 8) && pixeles[2 * indice + 1] == (color & 0xFF));
+        }
+    }
+
+    /* Con otros tamaños de pixel no se envía nada */
+    for (uint8_t bpp = 0; bpp < 16; bpp++) {
+        if (bpp != 1 && bpp != 2 && bpp != 4 && bpp != 8) {
+            ili9341_sprite_t sprite = {.width = 5, .height = 2, .bpp = bpp, .data = datos_4bpp};
+            PanelSimuladoReiniciar();
+            ILI9341DrawSprite(pantalla, 30, 40, &sprite, paleta);
+            VERIFICAR(PanelSimuladoTransacciones(&transaccion) == 0);
+        }
+    }
+    VERIFICAR(PanelSimuladoErrores() == 0);
+}
+
+//! @brief Las imágenes comprimidas se expanden con su paleta, aunque un paquete quede entre dos transacciones
+static void PruebaComprimida(void) {
+    const uint32_t limite = BLIT_CHUNK / 2;
+    const transaccion_simulada_t * transaccion;
+    const uint8_t * pixeles;
+
+    /* Ancho y alto de mayor a menor peso, y cero colores significa una paleta de 256 */
+    comprimida[0] = ILI9341_WIDTH >> 8;
+    comprimida[1] = ILI9341_WIDTH & 0xFF;
+    comprimida[2] = 0;
+    comprimida[3] = RLE_PIXELES / ILI9341_WIDTH;
+    comprimida[4] = 0;
+    for (uint32_t indice = 0; indice < 256; indice++) {
+        comprimida[RLE_ENCABEZADO + 2 * indice] = indice;
+        comprimida[RLE_ENCABEZADO + 2 * indice + 1] = ~indice;
+    }
+    comprimidos = RLE_ENCABEZADO + 512;
+    expandidos = 0;
+
+    /* Paquetes cortos al inicio, índices sueltos entre la primera y la segunda transacción y una repetición entre
+       la segunda y la tercera */
+    AgregarPaquete(false, 3, 250);
+    AgregarPaquete(true, 1, 255);
+    CompletarPaquetes(limite - 50);
+    AgregarPaquete(false, 100, 200);
+    CompletarPaquetes(2 * limite - 50);
+    AgregarPaquete(true, 100, 131);
+    CompletarPaquetes(RLE_PIXELES);
+
+    PanelSimuladoReiniciar();
+    ILI9341DrawRLEPicture(pantalla, 0, 10, comprimida);
+    uint32_t cantidad = PanelSimuladoTransacciones(&transaccion);
+    VerificarVentana(transaccion, 0, 10, ILI9341_WIDTH - 1, 10 + RLE_PIXELES / ILI9341_WIDTH - 1);
+    VERIFICAR(transaccion[2].comando == MEM_WRITE && !transaccion[2].pixeles);
+    VerificarDivision(&transaccion[3], cantidad - 3, sizeof(esperados), NULL);
+    VERIFICAR(PanelSimuladoPixeles(&pixeles) == sizeof(esperados));
+    VERIFICAR(memcmp(pixeles, esperados, sizeof(esperados)) == 0);
+
+    /* Una cantidad mayor que los píxeles que faltan se recorta a la ventana y el resto de la imagen no se lee */
+    comprimida[0] = 0;
+    comprimida[1] = 10;
+    comprimida[2] = 0;
+    comprimida[3] = 2;
+    comprimida[4] = 2;
+    comprimida[5] = 0x00;
+    comprimida[6] = 0xFF;
+    comprimida[7] = 0x01;
+    comprimida[8] = 0xFE;
+    comprimidos = RLE_ENCABEZADO + 4;
+    comprimida[comprimidos++] = 4;
+    for (uint32_t pixel = 0; pixel < 20; pixel++) {
+        uint8_t indice = (pixel < 5) ? (pixel & 1) : 1;
+        if (pixel < 5) {
+            comprimida[comprimidos++] = indice;
+        }
+        esperados[2 * pixel] = indice;
+        esperados[2 * pixel + 1] = ~indice;
+    }
+    comprimida[comprimidos++] = RLE_REPETICION | 0x7F;
+    comprimida[comprimidos++] = 1;
+    memset(&comprimida[comprimidos], 0x7F, 16);
+
+    PanelSimuladoReiniciar();
+    ILI9341DrawRLEPicture(pantalla, 100, 100, comprimida);
+    cantidad = PanelSimuladoTransacciones(&transaccion);
+    VerificarVentana(transaccion, 100, 100, 109, 101);
+    VERIFICAR(cantidad == 4);
+    VERIFICAR(PanelSimuladoPixeles(&pixeles) == 2 * 20);
+    VERIFICAR(memcmp(pixeles, esperados, 2 * 20) == 0);
+    VERIFICAR(PanelSimuladoErrores() == 0);
+}
+
+/* === Public function implementation ============================================================================== */
+
+int main(void) {
+    PruebaInicio();
+    PruebaRelleno();
+    PruebaLienzo();
+    PruebaImagen();
+    PruebaSprite();
+    PruebaComprimida();
+    return PRUEBA_RESULTADO();
+}
+
+/* === End of documentation ======================================================================================== */
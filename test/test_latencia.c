@@ -0,0 +1,142 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+/** @file test_latencia.c
+ ** @brief Pruebas del histograma logarítmico-lineal de la medición de latencia
+ **
+ ** Los límites de los casilleros se comparan con un cálculo independiente: un valor mayor o igual a 16 cuyo bit más
+ ** significativo es el e cae en un casillero de 2^(e-4) valores. Los percentiles se verifican con entradas conocidas.
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include "latencia.h"
+#include "prueba.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/* === Private function definitions ================================================================================ */
+
+//! @brief Registra una traza completa en la que todas las etapas tardan lo mismo desde el flanco
+static void Medir(uint64_t valor_us) {
+    const uint64_t flanco = 1000000;
+
+    LatenciaIniciar(flanco);
+    for (int etapa = LATENCIA_BOTON; etapa < LATENCIA_ETAPAS; etapa++) {
+        LatenciaMarcar(etapa, flanco + valor_us);
+    }
+}
+
+//! @brief Mayor valor del casillero de un valor, calculado sin el código del módulo
+static uint64_t LimiteEsperado(uint64_t valor) {
+    if (valor < 16) {
+        return valor;
+    }
+    int ancho = 63 - __builtin_clzll(valor) - 4; /* Bits que no distingue el casillero */
+    return (((valor >> ancho) + 1) << ancho) - 1;
+}
+
+//! @brief Cada valor cae en el casillero esperado, con un error relativo menor a 1/16
+static void PruebaCasilleros(void) {
+    uint32_t correctos = 0, casos = 0;
+
+    for (uint64_t valor = 0; valor < (1ULL << 31); valor = (valor < 4096) ? valor + 1 : valor + valor / 37) {
+        /* Con una medición mayor, la mediana de dos mediciones es el límite superior del casillero del valor */
+        LatenciaReiniciar();
+        Medir(valor);
+        Medir(UINT32_MAX);
+        uint64_t limite = LatenciaPercentil(LATENCIA_PIXEL, 500);
+        casos++;
+        correctos += (limite == LimiteEsperado(valor)) && (limite - valor) * 16 <= valor;
+    }
+    VERIFICAR(correctos == casos);
+
+    /* El límite superior de un casillero y el valor siguiente caen en casilleros distintos */
+    LatenciaReiniciar();
+    Medir(511);
+    Medir(512);
+    VERIFICAR(LatenciaPercentil(LATENCIA_PIXEL, 500) == 511);
+    VERIFICAR(LatenciaPercentil(LATENCIA_PIXEL, 1000) == 512);
+}
+
+//! @brief Percentiles y máximo de una distribución uniforme conocida
+static void PruebaPercentiles(void) {
+    LatenciaReiniciar();
+    VERIFICAR(LatenciaPercentil(LATENCIA_PIXEL, 500) == 0);
+    for (uint64_t valor = 1; valor <= 1000; valor++) {
+        Medir(valor);
+    }
+    VERIFICAR(LatenciaCantidad() == 1000);
+    /* La mediana es 500, en el casillero [496, 511], y el percentil 99 es 990, en el casillero [960, 991] */
+    VERIFICAR(LatenciaPercentil(LATENCIA_PIXEL, 500) == 511);
+    VERIFICAR(LatenciaPercentil(LATENCIA_PIXEL, 990) == 991);
+    VERIFICAR(LatenciaPercentil(LATENCIA_BOTON, 10) == 10);
+    VERIFICAR(LatenciaMaximo(LATENCIA_PIXEL) == 1000);
+    /* El percentil nunca supera al máximo medido aunque el casillero llegue más lejos */
+    VERIFICAR(LatenciaPercentil(LATENCIA_PIXEL, 1000) == 1000);
+
+    /* Las mediciones de más de 32 bits van al último casillero pero el máximo conserva el valor real */
+    Medir(1ULL << 40);
+    VERIFICAR(LatenciaMaximo(LATENCIA_PIXEL) == (1ULL << 40));
+    VERIFICAR(LatenciaPercentil(LATENCIA_PIXEL, 1000) == UINT32_MAX);
+}
+
+//! @brief Solo se agregan las trazas completas con las etapas marcadas en orden
+static void PruebaTrazas(void) {
+    LatenciaReiniciar();
+
+    /* Una etapa salteada deja la traza incompleta y un evento nuevo la descarta */
+    LatenciaIniciar(0);
+    LatenciaMarcar(LATENCIA_BOTON, 10);
+    LatenciaMarcar(LATENCIA_LECTURA, 20);
+    LatenciaMarcar(LATENCIA_PIXEL, 30);
+    VERIFICAR(LatenciaCantidad() == 0);
+    Medir(100);
+    VERIFICAR(LatenciaCantidad() == 1);
+
+    /* Una marca repetida o sin traza en curso no tiene efecto */
+    LatenciaMarcar(LATENCIA_PIXEL, 5000);
+    VERIFICAR(LatenciaCantidad() == 1);
+    VERIFICAR(LatenciaMaximo(LATENCIA_PIXEL) == 100);
+
+    /* Un instante anterior a la etapa previa se iguala a ella */
+    LatenciaIniciar(1000);
+    LatenciaMarcar(LATENCIA_BOTON, 1200);
+    LatenciaMarcar(LATENCIA_ESTADO, 1100);
+    LatenciaMarcar(LATENCIA_LECTURA, 1300);
+    LatenciaMarcar(LATENCIA_PANTALLA, 1400);
+    LatenciaMarcar(LATENCIA_PIXEL, 1500);
+    VERIFICAR(LatenciaCantidad() == 2);
+    VERIFICAR(LatenciaMaximo(LATENCIA_ESTADO) == 200);
+    VERIFICAR(LatenciaMaximo(LATENCIA_PIXEL) == 500);
+
+    LatenciaReiniciar();
+    VERIFICAR((LatenciaCantidad() == 0) && (LatenciaMaximo(LATENCIA_PIXEL) == 0));
+}
+
+/* === Public function implementation ============================================================================== */
+
+int main(void) {
+    PruebaCasilleros();
+    PruebaPercentiles();
+    PruebaTrazas();
+    return PRUEBA_RESULTADO();
+}
+
+/* === End of documentation ======================================================================================== */
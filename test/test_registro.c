@@ -0,0 +1,239 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+/** @file test_registro.c
+ ** @brief Pruebas del registro persistente de eventos sobre una imagen de la partición en un archivo
+ **
+ ** Verifica la reconstrucción del índice al montar, la recuperación después de una escritura interrumpida por un corte
+ ** de energía y el uso circular de los sectores. Informa la cantidad de eventos por segundo que se confirman y el
+ ** tiempo de montaje de una partición llena.
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include "prueba.h"
+#include "registro.h"
+#include <stdbool.h>
+#include <stdio.h>
+
+/* === Macros definitions ========================================================================================== */
+
+#define IMAGEN             "test_registro.img"
+#define EVENTOS_POR_SECTOR ((REGISTRO_SECTOR - 16) / 24) //!< Cabecera de 16 bytes y eventos de 24 bytes
+
+/* === Private variable definitions ================================================================================ */
+
+//! @brief Medio sobre la imagen, lo envuelve el medio con cortes de energía simulados
+static registro_medio_t imagen;
+
+//! @brief Bytes que se escriben antes del corte de energía, negativo si no hay un corte programado
+static int bytes_hasta_corte = -1;
+
+//! @brief Se produjo el corte de energía, ninguna operación posterior llega a la imagen
+static bool sin_energia;
+
+/* === Private function definitions ================================================================================ */
+
+static int EscribirConCorte(void * contexto, uint32_t direccion, const void * datos, size_t largo) {
+    if (sin_energia) {
+        return -1;
+    }
+    if ((bytes_hasta_corte >= 0) && (largo > (size_t)bytes_hasta_corte)) {
+        imagen.escribir(contexto, direccion, datos, bytes_hasta_corte);
+        sin_energia = true;
+        return -1;
+    }
+    return imagen.escribir(contexto, direccion, datos, largo);
+}
+
+static int BorrarConCorte(void * contexto, uint32_t direccion, size_t largo) {
+    return sin_energia ? -1 : imagen.borrar(contexto, direccion, largo);
+}
+
+//! @brief Abre la imagen, vacía si se indica, y monta el registro sobre el medio con cortes simulados
+static registro_t Montar(uint32_t sectores, bool vacia) {
+    if (vacia) {
+        remove(IMAGEN);
+    }
+    RegistroCerrarImagen(&imagen);
+    if (!RegistroAbrirImagen(&imagen, IMAGEN, sectores * REGISTRO_SECTOR)) {
+        return NULL;
+    }
+    registro_medio_t medio = imagen;
+    medio.escribir = EscribirConCorte;
+    medio.borrar = BorrarConCorte;
+    bytes_hasta_corte = -1;
+    sin_energia = false;
+    return RegistroMontar(&medio);
+}
+
+static registro_evento_t Evento(uint32_t numero) {
+    return (registro_evento_t){
+        .tipo = REGISTRO_VUELTA,
+        .canal = numero % 8,
+        .sesion = 1,
+        .numero = numero,
+        .tiempo_us = numero * 1000ULL,
+    };
+}
+
+//! @brief Agrega los eventos con números desde primero hasta antes de ultimo y los confirma
+static void Escribir(registro_t registro, uint32_t primero, uint32_t ultimo) {
+    for (uint32_t numero = primero; numero < ultimo; numero++) {
+        registro_evento_t evento = Evento(numero);
+        if (!RegistroAgregar(registro, &evento)) {
+            RegistroConfirmar(registro);
+            RegistroAgregar(registro, &evento);
+        }
+    }
+    RegistroConfirmar(registro);
+}
+
+//! @brief Verifica que el registro tenga los eventos consecutivos que terminan en ultimo, sin eventos corruptos
+static void VerificarSecuencia(registro_t registro, uint32_t cantidad, uint32_t ultimo) {
+    registro_evento_t evento;
+    uint32_t leidos = 0;
+
+    VERIFICAR(RegistroCantidad(registro) == cantidad);
+    for (uint32_t indice = 0; indice < cantidad; indice++) {
+        if (RegistroLeer(registro, indice, &evento) && (evento.numero == ultimo + 1 - cantidad + indice) &&
+            (evento.tiempo_us == evento.numero * 1000ULL)) {
+            leidos++;
+        }
+    }
+    VERIFICAR(leidos == cantidad);
+    VERIFICAR(!RegistroLeer(registro, cantidad, &evento));
+    if (cantidad > 0) {
+        VERIFICAR(RegistroUltimo(registro, &evento) && (evento.numero == ultimo));
+    } else {
+        VERIFICAR(!RegistroUltimo(registro, &evento));
+    }
+}
+
+//! @brief La cantidad de eventos de cada sector se recupera al montar con la búsqueda binaria
+static void PruebaMontaje(void) {
+    static const uint32_t cantidades[] = {0, 1, 2, EVENTOS_POR_SECTOR - 1, EVENTOS_POR_SECTOR, EVENTOS_POR_SECTOR + 1,
+                                          3 * EVENTOS_POR_SECTOR + 17};
+
+    for (size_t caso = 0; caso < sizeof(cantidades) / sizeof(cantidades[0]); caso++) {
+        uint32_t cantidad = cantidades[caso];
+        registro_t registro = Montar(8, true);
+        VERIFICAR(registro != NULL);
+        Escribir(registro, 0, cantidad);
+
+        registro = Montar(8, false);
+        registro_estadisticas_t estadisticas;
+        RegistroEstadisticas(registro, &estadisticas);
+        VERIFICAR(estadisticas.corruptos == 0);
+        VerificarSecuencia(registro, cantidad, cantidad - 1);
+    }
+}
+
+//! @brief Un corte de energía a mitad de una escritura solo invalida los eventos que se estaban escribiendo
+static void PruebaEscrituraInterrumpida(void) {
+    static const int cortes[] = {1, 10, 23, 24 + 5};
+
+    for (size_t caso = 0; caso < sizeof(cortes) / sizeof(cortes[0]); caso++) {
+        registro_t registro = Montar(8, true);
+        Escribir(registro, 0, 100);
+
+        /* El corte deja escritos solo los primeros bytes del lote de cinco eventos, el último a medias es corrupto */
+        bytes_hasta_corte = cortes[caso];
+        Escribir(registro, 100, 105);
+        VERIFICAR(sin_energia);
+
+        registro = Montar(8, false);
+        registro_estadisticas_t estadisticas;
+        RegistroEstadisticas(registro, &estadisticas);
+        uint32_t completos = cortes[caso] / 24;
+        uint32_t ocupados = completos + 1;
+        VERIFICAR(estadisticas.corruptos == 1);
+        VERIFICAR(RegistroCantidad(registro) == 100 + ocupados);
+
+        registro_evento_t evento;
+        VERIFICAR(RegistroUltimo(registro, &evento) && (evento.numero == 99 + completos));
+        VERIFICAR(RegistroLeer(registro, 99 + completos, &evento) && (evento.numero == 99 + completos));
+        VERIFICAR(!RegistroLeer(registro, 100 + completos, &evento));
+
+        /* Los eventos nuevos siguen al incompleto y se recuperan en el próximo montaje */
+        Escribir(registro, 200, 210);
+        registro = Montar(8, false);
+        VERIFICAR(RegistroCantidad(registro) == 110 + ocupados);
+        VERIFICAR(RegistroUltimo(registro, &evento) && (evento.numero == 209));
+        VERIFICAR(RegistroLeer(registro, 100 + ocupados, &evento) && (evento.numero == 200));
+    }
+}
+
+//! @brief Al llenarse la partición se borra el sector más antiguo y se conservan los eventos más recientes
+static void PruebaUsoCircular(void) {
+    const uint32_t sectores = 4;
+    registro_t registro = Montar(sectores, true);
+
+    for (uint32_t vuelta = 1; vuelta <= 3; vuelta++) {
+        uint32_t total = vuelta * 1000 + 7;
+        Escribir(registro, 0, total);
+        /* El sector siguiente al activo se borra al abrirse, el activo está parcialmente escrito */
+        uint32_t conservados = (sectores - 1) * EVENTOS_POR_SECTOR + ((total - 1) % EVENTOS_POR_SECTOR) + 1;
+        VerificarSecuencia(registro, conservados, total - 1);
+
+        registro = Montar(sectores, false);
+        VerificarSecuencia(registro, conservados, total - 1);
+        registro = Montar(sectores, true);
+    }
+}
+
+//! @brief Eventos por segundo que se confirman en la imagen y tiempo de montaje de una partición llena
+static void MedirRendimiento(void) {
+    const uint32_t sectores = REGISTRO_MAXIMO_SECTORES;
+    const uint32_t cantidad = 50000;
+    registro_t registro = Montar(sectores, true);
+
+    double inicio = PruebaSegundos();
+    Escribir(registro, 0, cantidad);
+    double escritura = PruebaSegundos() - inicio;
+    registro_estadisticas_t estadisticas;
+    RegistroEstadisticas(registro, &estadisticas);
+
+    const int montajes = 100;
+    inicio = PruebaSegundos();
+    for (int montaje = 0; montaje < montajes; montaje++) {
+        registro = Montar(sectores, false);
+    }
+    double montaje = (PruebaSegundos() - inicio) / montajes;
+    VerificarSecuencia(registro, (sectores - 1) * EVENTOS_POR_SECTOR + ((cantidad - 1) % EVENTOS_POR_SECTOR) + 1,
+                       cantidad - 1);
+
+    printf("Escritura: %.0f eventos/s (%u sectores borrados)\n", cantidad / escritura, estadisticas.borrados);
+    printf("Montaje de %u sectores con %u eventos: %.1f us\n", sectores, RegistroCantidad(registro), montaje * 1e6);
+}
+
+/* === Public function implementation ============================================================================== */
+
+int main(void) {
+    PruebaMontaje();
+    PruebaEscrituraInterrumpida();
+    PruebaUsoCircular();
+    MedirRendimiento();
+
+    RegistroCerrarImagen(&imagen);
+    remove(IMAGEN);
+    return PRUEBA_RESULTADO();
+}
+
+/* === End of documentation ======================================================================================== */
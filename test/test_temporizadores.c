@@ -0,0 +1,202 @@
+/*********************************************************************************************************************
+Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the
+Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+SPDX-License-Identifier: MIT
+*********************************************************************************************************************/
+
+/** @file test_temporizadores.c
+ ** @brief Pruebas de la rueda jerárquica de temporizadores
+ **
+ ** La rueda avanza de un evento al siguiente con @ref TemporizadoresProximo, asi cada temporizador debe vencer
+ ** exactamente en su tic aunque haya pasado por los casilleros de los niveles superiores. Informa la cantidad de
+ ** temporizadores que se arman y que vencen por segundo con miles de temporizadores activos.
+ **/
+
+/* === Headers files inclusions ==================================================================================== */
+
+#include "prueba.h"
+#include "temporizadores.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/* === Macros definitions ========================================================================================== */
+
+#define TICS_NIVEL(nivel) (1ULL << (6 * (nivel))) //!< Tics que cubre un casillero de un nivel
+#define ALCANCE           TICS_NIVEL(TEMPORIZADORES_NIVELES)
+
+/* === Private variable definitions ================================================================================ */
+
+static temporizador_t temporizadores[TEMPORIZADORES_MAXIMO];
+static uint64_t esperado[TEMPORIZADORES_MAXIMO]; //!< Tic en que debe vencer cada temporizador
+static uint32_t periodos[TEMPORIZADORES_MAXIMO];  //!< Período de cada temporizador, cero si es de un solo disparo
+static uint32_t avisos[TEMPORIZADORES_MAXIMO];    //!< Cantidad de avisos de cada temporizador
+static uint32_t adelantados, atrasados;           //!< Avisos antes o después del tic esperado
+static uint64_t ahora;                            //!< Tic al que se avanza la rueda
+
+/* === Private function definitions ================================================================================ */
+
+static void Aviso(temporizador_t temporizador, void * contexto) {
+    uintptr_t indice = (uintptr_t)contexto;
+
+    (void)temporizador;
+    avisos[indice]++;
+    if (ahora < esperado[indice]) {
+        adelantados++;
+    } else if (ahora > esperado[indice]) {
+        atrasados++;
+    }
+    esperado[indice] += periodos[indice];
+}
+
+//! @brief Desarma todos los temporizadores y vuelve a iniciar la rueda en el tic indicado
+static void Reiniciar(uint64_t inicio) {
+    for (uint32_t indice = 0; indice < TEMPORIZADORES_MAXIMO; indice++) {
+        if (temporizadores[indice] != NULL) {
+            TemporizadorCancelar(temporizadores[indice]);
+        }
+    }
+    TemporizadoresIniciar(inicio);
+    ahora = inicio;
+    adelantados = 0;
+    atrasados = 0;
+    for (uintptr_t indice = 0; indice < TEMPORIZADORES_MAXIMO; indice++) {
+        if (temporizadores[indice] == NULL) {
+            temporizadores[indice] = TemporizadorCrear(Aviso, (void *)indice);
+        }
+        avisos[indice] = 0;
+        periodos[indice] = 0;
+    }
+}
+
+static void Armar(uint32_t indice, uint32_t demora, uint32_t periodo) {
+    esperado[indice] = ahora + demora;
+    periodos[indice] = periodo;
+    TemporizadorArmar(temporizadores[indice], demora, periodo);
+}
+
+//! @brief Avanza la rueda de un evento al siguiente hasta el tic indicado, devuelve la cantidad de vencimientos
+static uint32_t AvanzarHasta(uint64_t limite) {
+    uint32_t cantidad = 0;
+
+    for (uint64_t proximo = TemporizadoresProximo(); proximo <= limite; proximo = TemporizadoresProximo()) {
+        ahora = proximo;
+        cantidad += TemporizadoresAvanzar(ahora);
+    }
+    ahora = limite;
+    cantidad += TemporizadoresAvanzar(ahora);
+    return cantidad;
+}
+
+//! @brief Los vencimientos en los bordes de cada nivel llegan exactamente en su tic después de redistribuirse
+static void PruebaNiveles(void) {
+    static const uint64_t inicios[] = {0, 1, 63, 12345, TICS_NIVEL(3) - 1, 987654321};
+    uint32_t demoras[TEMPORIZADORES_MAXIMO];
+    uint32_t cantidad = 0;
+
+    for (uint8_t nivel = 1; nivel <= TEMPORIZADORES_NIVELES; nivel++) {
+        for (int desvio = -2; desvio <= 2; desvio++) {
+            demoras[cantidad++] = TICS_NIVEL(nivel) + desvio;
+        }
+    }
+    demoras[cantidad++] = 1;
+    demoras[cantidad++] = ALCANCE + 5000; /* Fuera del alcance, se vuelve a ubicar al final de la rueda */
+
+    for (size_t caso = 0; caso < sizeof(inicios) / sizeof(inicios[0]); caso++) {
+        Reiniciar(inicios[caso]);
+        for (uint32_t indice = 0; indice < cantidad; indice++) {
+            Armar(indice, demoras[indice], 0);
+        }
+        uint32_t vencidos = AvanzarHasta(inicios[caso] + 2 * ALCANCE);
+        uint32_t correctos = 0;
+        for (uint32_t indice = 0; indice < cantidad; indice++) {
+            correctos += (avisos[indice] == 1) && !TemporizadorArmado(temporizadores[indice]);
+        }
+        VERIFICAR(vencidos == cantidad);
+        VERIFICAR(correctos == cantidad);
+        VERIFICAR((adelantados == 0) && (atrasados == 0));
+        VERIFICAR(TemporizadoresProximo() == UINT64_MAX);
+    }
+}
+
+//! @brief Demoras al azar en los cuatro niveles, con temporizadores periódicos y cancelaciones mezclados
+static void PruebaAzar(void) {
+    uint32_t cancelados = 0, correctos = 0;
+
+    srand(1);
+    Reiniciar(4242);
+    for (uint32_t indice = 0; indice < TEMPORIZADORES_MAXIMO; indice++) {
+        uint8_t nivel = indice % TEMPORIZADORES_NIVELES;
+        uint32_t demora = 1 + (uint32_t)(((uint64_t)rand() << 16 ^ rand()) % (TICS_NIVEL(nivel + 1) - 1));
+        Armar(indice, demora, (indice % 7 == 0) ? 1 + rand() % 5000 : 0);
+    }
+    for (uint32_t indice = 3; indice < TEMPORIZADORES_MAXIMO; indice += 11) {
+        TemporizadorCancelar(temporizadores[indice]);
+        cancelados++;
+    }
+
+    uint64_t fin = ahora + ALCANCE;
+    AvanzarHasta(fin);
+    for (uint32_t indice = 0; indice < TEMPORIZADORES_MAXIMO; indice++) {
+        bool cancelado = (indice >= 3) && ((indice - 3) % 11 == 0);
+        if (cancelado) {
+            correctos += (avisos[indice] == 0);
+        } else if (periodos[indice]) {
+            /* El próximo vencimiento esperado es el primero posterior al final de la prueba */
+            correctos += (esperado[indice] > fin) && (esperado[indice] - periodos[indice] <= fin);
+        } else {
+            correctos += (avisos[indice] == 1);
+        }
+    }
+    VERIFICAR(correctos == TEMPORIZADORES_MAXIMO);
+    VERIFICAR((adelantados == 0) && (atrasados == 0));
+}
+
+//! @brief Temporizadores armados y vencidos por segundo con todos los temporizadores activos
+static void MedirRendimiento(void) {
+    const int rondas = 200;
+    uint32_t vencidos = 0;
+    double armado = 0, avance = 0;
+
+    srand(2);
+    Reiniciar(0);
+    for (int ronda = 0; ronda < rondas; ronda++) {
+        double inicio = PruebaSegundos();
+        for (uint32_t indice = 0; indice < TEMPORIZADORES_MAXIMO; indice++) {
+            Armar(indice, 1 + rand() % 100000, 0);
+        }
+        double medio = PruebaSegundos();
+        vencidos += AvanzarHasta(ahora + 100000);
+        armado += medio - inicio;
+        avance += PruebaSegundos() - medio;
+    }
+    VERIFICAR(vencidos == (uint32_t)rondas * TEMPORIZADORES_MAXIMO);
+    VERIFICAR((adelantados == 0) && (atrasados == 0));
+    printf("Armado: %.1f M temporizadores/s con %d activos\n", rondas * TEMPORIZADORES_MAXIMO / armado / 1e6,
+           TEMPORIZADORES_MAXIMO);
+    printf("Vencimiento: %.1f M temporizadores/s\n", vencidos / avance / 1e6);
+}
+
+/* === Public function implementation ============================================================================== */
+
+int main(void) {
+    PruebaNiveles();
+    PruebaAzar();
+    MedirRendimiento();
+    return PRUEBA_RESULTADO();
+}
+
+/* === End of documentation ======================================================================================== */
@@ -0,0 +1,108 @@
+#!/usr/bin/env python3
+# Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+# SPDX-License-Identifier: MIT
+"""Convierte una imagen al formato comprimido de ILI9341DrawRLEPicture.
+
+La imagen se lleva a RGB565 y, si tiene más de 256 colores, se reduce a una paleta de 256. Los píxeles se codifican
+como índices de la paleta en paquetes de repeticiones o de índices sueltos (el formato está documentado en
+ili9341.h). El resultado es un archivo C con un arreglo constante, que queda en la memoria flash.
+
+Uso: rle565.py imagen.png salida.c [--nombre logo]
+"""
+
+import argparse
+import os
+import sys
+
+from PIL import Image
+
+RUN = 0x80
+MAX_PACKET = 128
+MIN_RUN = 3  # Una repetición de dos píxeles ocupa lo mismo que dos índices sueltos
+
+
+def rgb565(r, g, b):
+    return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3)
+
+
+def palette_indexes(image):
+    """Devuelve la paleta RGB565 y el índice de cada píxel"""
+    rgb = image.convert("RGB").tobytes()
+    pixels = [rgb565(*rgb[i : i + 3]) for i in range(0, len(rgb), 3)]
+    colors = sorted(set(pixels))
+    if len(colors) > 256:
+        reduced = image.convert("RGB").quantize(256, dither=Image.Dither.NONE)
+        rgb = reduced.getpalette()[: 3 * 256]
+        palette = [rgb565(*rgb[i : i + 3]) for i in range(0, len(rgb), 3)]
+        return palette, list(reduced.tobytes())
+    lookup = {color: index for index, color in enumerate(colors)}
+    return colors, [lookup[p] for p in pixels]
+
+
+def encode(indexes):
+    """Codifica los índices en paquetes de repeticiones y de índices sueltos"""
+    result = bytearray()
+    literal = []
+
+    def flush():
+        if literal:
+            result.append(len(literal) - 1)
+            result.extend(literal)
+            literal.clear()
+
+    i = 0
+    while i < len(indexes):
+        run = 1
+        while i + run < len(indexes) and run < MAX_PACKET and indexes[i + run] == indexes[i]:
+            run += 1
+        if run >= MIN_RUN:
+            flush()
+            result.append(RUN | (run - 1))
+            result.append(indexes[i])
+            i += run
+        else:
+            literal.append(indexes[i])
+            if len(literal) == MAX_PACKET:
+                flush()
+            i += 1
+    flush()
+    return result
+
+
+def convert(image):
+    width, height = image.size
+    palette, indexes = palette_indexes(image)
+    data = bytearray([width >> 8, width & 0xFF, height >> 8, height & 0xFF, len(palette) & 0xFF])
+    for color in palette:
+        data.extend((color >> 8, color & 0xFF))
+    data.extend(encode(indexes))
+    return data
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("imagen")
+    parser.add_argument("salida")
+    parser.add_argument("--nombre", help="nombre del arreglo, por omisión el del archivo de entrada")
+    args = parser.parse_args()
+
+    image = Image.open(args.imagen)
+    name = args.nombre or os.path.splitext(os.path.basename(args.imagen))[0]
+    data = convert(image)
+    raw = image.size[0] * image.size[1] * 2
+
+    with open(args.salida, "w") as output:
+        source = os.path.basename(args.imagen)
+        output.write("/* Generado con tools/rle565.py a partir de %s, no editar */\n\n" % source)
+        output.write("#include <stdint.h>\n\n")
+        width, height = image.size
+        output.write("// %dx%d píxeles, %d bytes (%d sin comprimir)\n" % (width, height, len(data), raw))
+        output.write("const uint8_t %s[%d] = {\n" % (name, len(data)))
+        for i in range(0, len(data), 16):
+            output.write("    " + ", ".join("0x%02X" % b for b in data[i : i + 16]) + ",\n")
+        output.write("};\n")
+    print("%s: %d bytes, %.1f%% del original" % (name, len(data), 100.0 * len(data) / raw), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,80 @@
+#!/usr/bin/env python3
+# Copyright (c) 2025, Esteban Volentini <evolentini@herrera.unt.edu.ar>
+# SPDX-License-Identifier: MIT
+"""Convierte una imagen en un sprite de colores indexados para ILI9341DrawSprite.
+
+Cada color distinto de la imagen recibe un índice y los píxeles se guardan con la menor cantidad de bits que alcanza
+(1, 2, 4 u 8). Los colores de la imagen se guardan como paleta de ejemplo, pero al dibujar se puede usar cualquier
+otra paleta con la misma cantidad de colores, por ejemplo para mostrar el mismo sprite encendido y apagado. Con
+--paleta se fija el orden de los índices dando los colores de la imagen en formato RRGGBB.
+
+Uso: sprite565.py imagen.png salida.c [--nombre icono] [--paleta 000000,FF0000]
+"""
+
+import argparse
+import os
+import sys
+
+from PIL import Image
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from rle565 import palette_indexes, rgb565  # noqa: E402
+
+
+def pack(indexes, width, bpp):
+    """Empaqueta los índices con el píxel de la izquierda en los bits más significativos, cada fila desde un byte"""
+    result = bytearray()
+    for start in range(0, len(indexes), width):
+        value, bits = 0, 0
+        for index in indexes[start : start + width]:
+            value = (value << bpp) | index
+            bits += bpp
+            if bits == 8:
+                result.append(value)
+                value, bits = 0, 0
+        if bits:
+            result.append(value << (8 - bits))
+    return result
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("imagen")
+    parser.add_argument("salida")
+    parser.add_argument("--nombre", help="nombre del sprite, por omisión el del archivo de entrada")
+    parser.add_argument("--paleta", help="colores de la imagen en el orden de los índices, RRGGBB separados por comas")
+    args = parser.parse_args()
+
+    image = Image.open(args.imagen)
+    width, height = image.size
+    name = args.nombre or os.path.splitext(os.path.basename(args.imagen))[0]
+    palette, indexes = palette_indexes(image)
+    if args.paleta:
+        order = [rgb565(*bytes.fromhex(color)) for color in args.paleta.split(",")]
+        missing = set(palette) - set(order)
+        if missing:
+            sys.exit("La imagen usa colores que no están en la paleta: %s" % ", ".join("%04X" % c for c in missing))
+        indexes = [order.index(palette[i]) for i in indexes]
+        palette = order
+    bpp = next(bits for bits in (1, 2, 4, 8) if len(palette) <= (1 << bits))
+    data = pack(indexes, width, bpp)
+
+    with open(args.salida, "w") as output:
+        source = os.path.basename(args.imagen)
+        output.write("/* Generado con tools/sprite565.py a partir de %s, no editar */\n\n" % source)
+        output.write('#include "ili9341.h"\n\n')
+        output.write("// %dx%d píxeles, %d bits por píxel, %d bytes\n" % (width, height, bpp, len(data)))
+        output.write("static const uint8_t %s_data[%d] = {\n" % (name, len(data)))
+        for i in range(0, len(data), 16):
+            output.write("    " + ", ".join("0x%02X" % b for b in data[i : i + 16]) + ",\n")
+        output.write("};\n\n")
+        output.write("const ili9341_sprite_t %s = {%d, %d, %d, %s_data};\n\n" % (name, width, height, bpp, name))
+        output.write("// Colores de la imagen original\n")
+        output.write("const uint16_t %s_palette[%d] = {" % (name, 1 << bpp))
+        output.write(", ".join("0x%04X" % c for c in palette + [0] * ((1 << bpp) - len(palette))) + "};\n")
+    raw = width * height * 2
+    print("%s: %d bits por píxel, %d bytes (%d en RGB565)" % (name, bpp, len(data), raw), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()